@@ -1,30 +1,120 @@
+#include <algorithm>
 #include <array>
+#include <cerrno>
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <optional>
 #include <string>
+#include <type_traits>
 
 #include <argp.h>
+#include <reelay/io/binary_row.hpp>
+#include <reelay/io/mapped_file.hpp>
+#include <reelay/io/verdict_file.hpp>
 #include <reelay/monitors.hpp>
+#include <reelay/profiling/run_profile.hpp>
 #include <sys/types.h>
 
 // argp option keys
-enum RYBINX_OPTS : uint8_t { OPT_DENSE = 'v', OPT_DISCRETE = 'x' };
+enum RYBINX_OPTS : uint8_t {
+  OPT_DENSE = 'v',
+  OPT_DISCRETE = 'x',
+  OPT_BINARY = 'B',
+  OPT_EARLY_EXIT = 'e',
+  OPT_AUTOMATON = 'a',
+  OPT_PLAN = 'p',
+  OPT_REGEX = 'r',
+  OPT_THREADS = 't',
+  OPT_INTERVALS = 'i',
+  OPT_ADAPTIVE = 'o',
+  OPT_STATS = 's'
+};
 
 const char* argp_program_version = "rybinx 0.1.0";
 const char* argp_program_bug_address = "Dogan Ulus <github.com/doganulus>";
-static const char* doc = "Reelay on Timescales Raw Binary Format";
+static const char* doc =
+  "Reelay on Timescales Raw Binary Format and Self-Describing Binary Rows";
 static const char* args_doc = "SPEC FILE";
 
+// Upper bound of --threads, far beyond the lanes of practical specifications
+static constexpr size_t max_threads = 256;
+
 struct arguments {
   char* spec;
   char* file;
   bool dense = false;
   bool discrete = false;
+  bool binary = false;
+  bool early_exit = false;
+  bool automaton = false;
+  bool plan = false;
+  bool regex = false;
+  bool adaptive = false;
+  size_t threads = 0;
+  bool intervals = false;
+  bool stats = false;
+  char* stats_file = nullptr;
 };
 
-static std::array<struct argp_option, 12> options = {
+static std::array<struct argp_option, 18> options = {
   {{"dense", OPT_DENSE, nullptr, 0, "Use dense time model (default)", 0},
    {"discrete", OPT_DISCRETE, nullptr, 0, "Use discrete time model", 0},
+   {"binary",
+    OPT_BINARY,
+    nullptr,
+    0,
+    "Write verdicts in binary format (.rylb)",
+    0},
+   {"early-exit",
+    OPT_EARLY_EXIT,
+    nullptr,
+    0,
+    "Stop reading once the verdict can no longer change",
+    0},
+   {"automaton",
+    OPT_AUTOMATON,
+    nullptr,
+    0,
+    "with -x, compile SPEC into a transition table when small enough",
+    0},
+   {"plan",
+    OPT_PLAN,
+    nullptr,
+    0,
+    "Read SPEC as a plan file (.rypl) compiled by ryplan",
+    0},
+   {"regex",
+    OPT_REGEX,
+    nullptr,
+    0,
+    "with -x, read SPEC as a regular expression over records",
+    0},
+   {"adaptive",
+    OPT_ADAPTIVE,
+    nullptr,
+    0,
+    "with -x, evaluate operands that often decide conjunctions first",
+    0},
+   {"threads",
+    OPT_THREADS,
+    "N",
+    0,
+    "with -x, split SPEC into lanes evaluated on N worker threads",
+    0},
+   {"intervals",
+    OPT_INTERVALS,
+    nullptr,
+    0,
+    "with -v, write final verdict intervals (begin, end, value)",
+    0},
+   {"stats",
+    OPT_STATS,
+    "FILE",
+    OPTION_ARG_OPTIONAL,
+    "Report throughput and per-event latency as JSON to FILE or stderr",
+    0},
    {nullptr}}};
 
 static error_t parse_opt(int key, char* arg, struct argp_state* state)
@@ -37,6 +127,42 @@ static error_t parse_opt(int key, char* arg, struct argp_state* state)
     case OPT_DISCRETE:
       arguments->discrete = true;
       break;
+    case OPT_BINARY:
+      arguments->binary = true;
+      break;
+    case OPT_EARLY_EXIT:
+      arguments->early_exit = true;
+      break;
+    case OPT_AUTOMATON:
+      arguments->automaton = true;
+      break;
+    case OPT_PLAN:
+      arguments->plan = true;
+      break;
+    case OPT_REGEX:
+      arguments->regex = true;
+      break;
+    case OPT_ADAPTIVE:
+      arguments->adaptive = true;
+      break;
+    case OPT_THREADS: {
+      char* end = nullptr;
+      errno = 0;
+      auto count = std::strtoul(arg, &end, 10);
+      if(arg[0] < '0' or arg[0] > '9' or *end != '\0' or errno != 0 or
+         count == 0 or count > max_threads) {
+        argp_error(state, "--threads must be between 1 and %zu", max_threads);
+      }
+      arguments->threads = count;
+      break;
+    }
+    case OPT_INTERVALS:
+      arguments->intervals = true;
+      break;
+    case OPT_STATS:
+      arguments->stats = true;
+      arguments->stats_file = arg;
+      break;
     case ARGP_KEY_ARG:
       if(state->arg_num == 0) {
         arguments->spec = arg;
@@ -49,6 +175,39 @@ static error_t parse_opt(int key, char* arg, struct argp_state* state)
       if(state->arg_num < 2) {
         argp_usage(state);
       }
+      if(arguments->intervals and not arguments->dense) {
+        argp_error(state, "--intervals requires the dense time model (-v)");
+      }
+      if(arguments->dense and arguments->regex) {
+        argp_error(state, "--regex requires the discrete time model (-x)");
+      }
+      if(arguments->dense and arguments->automaton) {
+        argp_error(state, "--automaton requires the discrete time model (-x)");
+      }
+      if(arguments->dense and arguments->threads > 0) {
+        argp_error(state, "--threads requires the discrete time model (-x)");
+      }
+      if(arguments->dense and arguments->adaptive) {
+        argp_error(state, "--adaptive requires the discrete time model (-x)");
+      }
+      if(arguments->threads > 0 and arguments->automaton) {
+        argp_error(state, "--automaton cannot be used with --threads");
+      }
+      if(arguments->regex and arguments->threads > 0) {
+        argp_error(state, "--regex cannot be used with --threads");
+      }
+      if(arguments->regex and arguments->automaton) {
+        argp_error(state, "--regex cannot be used with --automaton");
+      }
+      if(arguments->regex and arguments->adaptive) {
+        argp_error(state, "--regex cannot be used with --adaptive");
+      }
+      if(arguments->plan and arguments->regex) {
+        argp_error(state, "--regex cannot be used with --plan");
+      }
+      if(arguments->plan and arguments->automaton) {
+        argp_error(state, "--automaton cannot be used with --plan");
+      }
       break;
     default:
       return ARGP_ERR_UNKNOWN;
@@ -168,15 +327,132 @@ struct reelay::datafield<tx_binary_input_t> {
   }
 };
 
-static constexpr size_t buffer_size =
-  static_cast<const size_t>(64 * 1024);  // 64 KiB
+static constexpr size_t batch_size =
+  static_cast<const size_t>(1024 * 1024);  // records per batch
+
+// Streams rows from the mapping into the monitor batch by batch and
+// releases the pages behind so that resident memory stays bounded. With
+// `early_exit`, stops after the row that decides the verdict for good. With
+// a `profile`, rows are pushed one by one to time each of them; rows are
+// decoded lazily by the monitor, so the input phase is the page handling.
+template<typename MonitorT, typename RowIt, typename SinkT>
+void process(
+  MonitorT& monitor,
+  const reelay::mapped_file& file,
+  RowIt first,
+  size_t count,
+  size_t offset,
+  size_t row_size,
+  SinkT&& sink,
+  bool early_exit,
+  reelay::run_profile* profile)
+{
+  using phase = reelay::run_profile::phase;
+
+  for(size_t i = 0; i < count; i += batch_size) {
+    size_t n = std::min(batch_size, count - i);
+    if(early_exit or profile != nullptr) {
+      for(size_t j = 0; j < n; j++) {
+        if(profile != nullptr) {
+          profile->measure_event([&] { monitor.push(*(first + i + j), sink); });
+        }
+        else {
+          monitor.push(*(first + i + j), sink);
+        }
+        if(early_exit and monitor.decided()) {
+          std::cout << "Verdict decided at row " << i + j << std::endl;
+          return;
+        }
+      }
+    }
+    else {
+      monitor.push(first + i, first + i + n, sink);
+    }
+    if(profile != nullptr) {
+      profile->measure(
+        phase::parse, [&] { file.release(offset + i * row_size, n * row_size); });
+    }
+    else {
+      file.release(offset + i * row_size, n * row_size);
+    }
+  }
+}
+
+// Presents the interval output of a dense monitor as its `push` members
+template<typename MonitorT>
+struct interval_output {
+  MonitorT& monitor;
 
-int main(int argc, char** argv)
+  template<typename InputT, typename SinkT>
+  void push(const InputT& args, SinkT&& sink)
+  {
+    monitor.push_intervals(args, sink);
+  }
+
+  template<typename InputIt, typename SinkT>
+  void push(InputIt first, InputIt last, SinkT&& sink)
+  {
+    monitor.push_intervals(first, last, sink);
+  }
+
+  std::optional<bool> decided() const
+  {
+    return monitor.decided();
+  }
+};
+
+template<typename TimeT>
+void write_verdict(std::ostream& os, TimeT time, bool value)
 {
-  struct arguments arguments;
-  argp_parse(&argp, argc, argv, 0, nullptr, &arguments);
+  if constexpr(std::is_floating_point_v<TimeT>) {
+    os << reelay::json({{"time", time}, {"value", value}});
+  }
+  else {
+    os << "{\"time\":" << time << ",\"value\":" << (value ? "true" : "false")
+       << "}";
+  }
+}
 
-  using input_t = tx_binary_input_t;
+template<typename TimeT>
+void write_interval(std::ostream& os, TimeT begin, TimeT end, bool value)
+{
+  if constexpr(std::is_floating_point_v<TimeT>) {
+    os << reelay::json({{"begin", begin}, {"end", end}, {"value", value}});
+  }
+  else {
+    os << "{\"begin\":" << begin << ",\"end\":" << end
+       << ",\"value\":" << (value ? "true" : "false") << "}";
+  }
+}
+
+template<typename MonitorT, typename... ArgsT>
+std::optional<MonitorT> make_monitor(
+  const struct arguments& arguments,
+  const reelay::basic_options& options,
+  const ArgsT&... extra)
+{
+  if(not arguments.plan) {
+    return MonitorT::make(arguments.spec, options, extra...);
+  }
+  try {
+    return MonitorT::from_plan(std::string(arguments.spec), options, extra...);
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return std::nullopt;
+  }
+}
+
+template<typename TimeT, typename InputT, typename RowIt>
+int run(
+  const struct arguments& arguments,
+  const reelay::mapped_file& file,
+  RowIt first,
+  size_t count,
+  size_t offset,
+  size_t row_size)
+{
+  using input_t = InputT;
   using output_t = reelay::json;
 
   // Choices
@@ -188,27 +464,10 @@ int main(int argc, char** argv)
     use_discrete = true;
   }
 
-  auto monitor = reelay::monitor<input_t, output_t>();
-  auto discrete_opts =
-    reelay::discrete_timed<int32_t>::monitor<input_t, output_t>::options()
-      .with_condensing(true);
-  auto dense_opts =
-    reelay::dense_timed<int32_t>::monitor<input_t, output_t>::options();
-
-  if(use_dense) {
-    monitor = reelay::make_monitor(arguments.spec, dense_opts);
-  }
-  else {
-    monitor = reelay::make_monitor(arguments.spec, discrete_opts);
-  }
-
   std::string filename = arguments.file;
-  std::ifstream input(filename, std::ios::binary);
-  if(!input) {
-    std::cerr << "Error opening file: " << filename << std::endl;
-    return 1;
-  }
-  std::ofstream output(filename + ".ryl");
+  std::string output_filename =
+    filename + (arguments.binary ? ".rylb" : ".ryl");
+  std::ofstream output(output_filename, std::ios::binary);
   if(!output) {
     std::cerr << "Error creating output" << std::endl;
     return 1;
@@ -216,51 +475,294 @@ int main(int argc, char** argv)
   std::cout << "Processing " << filename << std::endl;
   std::cout << "---" << std::endl;
 
-  uint32_t total_lines = 0;
-  input.read(reinterpret_cast<char*>(&total_lines), sizeof(total_lines));
-  if(input.gcount() != sizeof(total_lines)) {
-    std::cerr << "File too small or corrupted." << std::endl;
-    return 1;
+  uint64_t errn = 0;
+
+  auto model =
+    use_dense ? reelay::verdict_model::dense : reelay::verdict_model::discrete;
+  auto layout = use_dense and arguments.intervals
+                  ? reelay::verdict_layout::interval
+                  : reelay::verdict_layout::point;
+  std::optional<reelay::verdict_writer<TimeT, bool>> writer;
+  if(arguments.binary) {
+    writer.emplace(output, model, layout);
   }
 
-  using record_t = tx_binary_input_t;
-  static_assert(
-    std::is_trivially_copyable_v<record_t>,
-    "record_t must be trivially copyable for binary I/O!");
+  std::optional<reelay::run_profile> profile;
+  if(arguments.stats) {
+    profile.emplace();
+  }
+  auto* profiled = profile ? &*profile : nullptr;
 
-  const size_t record_size = sizeof(record_t);
+  auto write_point = [&](TimeT time, bool value) {
+    if(writer) {
+      (*writer)(time, value);
+    }
+    else {
+      write_verdict(output, time, value);
+      output << '\n';
+    }
+    if(errn < 5) {
+      write_verdict(std::cout, time, value);
+      std::cout << std::endl;
+    }
+    else if(errn == 5) {
+      std::cout << "..." << std::endl;
+    }
+    errn++;
+  };
 
-  std::vector<char> buffer(buffer_size);
-  std::vector<record_t> records;
-  records.reserve(buffer_size / record_size);
+  auto sink = [&](TimeT time, bool value) {
+    if(profiled != nullptr) {
+      profiled->measure(
+        reelay::run_profile::phase::output, [&] { write_point(time, value); });
+    }
+    else {
+      write_point(time, value);
+    }
+  };
 
-  uint64_t count = 0;
-  uint64_t errn = 0;
+  auto write_span = [&](TimeT begin, TimeT end, bool value) {
+    if(writer) {
+      (*writer)(begin, end, value);
+    }
+    else {
+      write_interval(output, begin, end, value);
+      output << '\n';
+    }
+    if(errn < 5) {
+      write_interval(std::cout, begin, end, value);
+      std::cout << std::endl;
+    }
+    else if(errn == 5) {
+      std::cout << "..." << std::endl;
+    }
+    errn++;
+  };
+
+  auto interval_sink = [&](TimeT begin, TimeT end, bool value) {
+    if(profiled != nullptr) {
+      profiled->measure(reelay::run_profile::phase::output, [&] {
+        write_span(begin, end, value);
+      });
+    }
+    else {
+      write_span(begin, end, value);
+    }
+  };
+
+  if(use_dense and arguments.intervals) {
+    using monitor_t = reelay::dense_timed_monitor<TimeT, input_t, output_t>;
+    auto opts = reelay::dense_timed<TimeT>::template monitor<
+      input_t,
+      output_t>::options();
+    auto monitor = make_monitor<monitor_t>(arguments, opts.get_basic_options());
+    if(not monitor) {
+      return 1;
+    }
+    auto intervals = interval_output<monitor_t>{*monitor};
+    process(
+      intervals,
+      file,
+      first,
+      count,
+      offset,
+      row_size,
+      interval_sink,
+      arguments.early_exit,
+      profiled);
+    monitor->close_intervals(interval_sink);
+  }
+  else if(use_dense) {
+    auto opts = reelay::dense_timed<TimeT>::template monitor<
+      input_t,
+      output_t>::options();
+    auto monitor =
+      make_monitor<reelay::dense_timed_monitor<TimeT, input_t, output_t>>(
+        arguments, opts.get_basic_options());
+    if(not monitor) {
+      return 1;
+    }
+    process(
+      *monitor,
+      file,
+      first,
+      count,
+      offset,
+      row_size,
+      sink,
+      arguments.early_exit,
+      profiled);
+  }
+  else if constexpr(std::is_integral_v<TimeT>) {
+    if(arguments.regex) {
+      using regex_monitor_t =
+        reelay::discrete_timed_regex_monitor<TimeT, input_t, output_t, true>;
+      auto opts = reelay::basic_options().with_condensing(true);
+      std::optional<regex_monitor_t> monitor;
+      try {
+        monitor.emplace(regex_monitor_t::make(arguments.spec, opts));
+      }
+      catch(const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+      }
+      process(
+        *monitor,
+        file,
+        first,
+        count,
+        offset,
+        row_size,
+        sink,
+        arguments.early_exit,
+        profiled);
+    }
+    else if(arguments.threads > 0) {
+      auto opts = reelay::basic_options()
+                    .with_condensing(true)
+                    .with_adaptive_ordering(arguments.adaptive);
+      auto parallel = reelay::parallel_options();
+      parallel.threads = arguments.threads;
+      auto monitor = make_monitor<
+        reelay::discrete_timed_parallel_monitor<TimeT, input_t, output_t, true>>(
+        arguments, opts, parallel);
+      if(not monitor) {
+        return 1;
+      }
+      process(
+        *monitor,
+        file,
+        first,
+        count,
+        offset,
+        row_size,
+        sink,
+        arguments.early_exit,
+        profiled);
+    }
+    else {
+      auto opts = reelay::discrete_timed<TimeT>::template monitor<
+                    input_t,
+                    output_t>::options()
+                    .with_condensing(true)
+                    .with_adaptive_ordering(arguments.adaptive)
+                    .with_automaton(arguments.automaton);
+      auto monitor = make_monitor<
+        reelay::discrete_timed_monitor<TimeT, input_t, output_t, true>>(
+        arguments, opts.get_basic_options());
+      if(not monitor) {
+        return 1;
+      }
+      if(arguments.automaton and not monitor->is_automaton()) {
+        std::cerr << "Specification exceeds the automaton limits, "
+                     "falling back to the network"
+                  << std::endl;
+      }
+      process(
+        *monitor,
+        file,
+        first,
+        count,
+        offset,
+        row_size,
+        sink,
+        arguments.early_exit,
+        profiled);
+    }
+  }
+  else {
+    std::cerr << "Discrete time model requires an integer time field"
+              << std::endl;
+    return 1;
+  }
 
-  while(true) {
-    input.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
-    std::streamsize bytes_read = input.gcount();
-    if(bytes_read <= 0) {
-      break;
+  if(writer) {
+    writer->flush();
+  }
+  if(errn <= 5) {
+    std::cout << "---" << std::endl;
+  }
+  std::cout << "Full output written to " + output_filename << std::endl;
+
+  if(profile) {
+    output.flush();
+    profile->stop();
+    profile->bytes = profile->events * row_size;
+    profile->verdicts = errn;
+    if(arguments.stats_file == nullptr) {
+      profile->write(std::cerr);
+    }
+    else {
+      std::ofstream stats(arguments.stats_file);
+      if(!stats) {
+        std::cerr << "Error creating " << arguments.stats_file << std::endl;
+        return 1;
+      }
+      profile->write(stats);
     }
+  }
 
-    size_t num_records = bytes_read / record_size;
+  return 0;
+}
 
-    const char* ptr = buffer.data();
-    for(size_t i = 0; i < num_records; i++) {
-      record_t rec;
-      std::memcpy(&rec, ptr, record_size);
-      ptr += record_size;
+int main(int argc, char** argv)
+{
+  struct arguments arguments;
+  argp_parse(&argp, argc, argv, 0, nullptr, &arguments);
 
-      reelay::json result = monitor.update(rec);
-      if(not result.empty()) {
-        errn++;
-        std::cout << result << std::endl;
-      }
-      count++;
+  std::string filename = arguments.file;
+  std::optional<reelay::mapped_file> file;
+  try {
+    file.emplace(filename);
+  }
+  catch(const std::runtime_error& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  if(file->size() < sizeof(uint32_t)) {
+    std::cerr << "File too small or corrupted." << std::endl;
+    return 1;
+  }
+  file->advise_sequential();
+
+  // Self-describing row files start with a schema header
+  if(std::memcmp(file->data(), reelay::binary_schema::magic, 4) == 0) {
+    std::optional<std::pair<reelay::binary_schema, size_t>> header;
+    try {
+      header.emplace(reelay::binary_schema::read(file->data(), file->size()));
     }
+    catch(const std::runtime_error& e) {
+      std::cerr << e.what() << std::endl;
+      return 1;
+    }
+    const auto& [schema, offset] = *header;
+    if(schema.time_field == nullptr) {
+      std::cerr << "Binary row file has no time field." << std::endl;
+      return 1;
+    }
+
+    if((file->size() - offset) % schema.row_size != 0) {
+      std::cerr << "Binary row file ends with a partial row." << std::endl;
+      return 1;
+    }
+
+    auto first = reelay::binary_row_iterator(&schema, file->data() + offset);
+    size_t count = (file->size() - offset) / schema.row_size;
+    if(schema.time_field->kind == reelay::scalar_kind::float64) {
+      return run<double, reelay::binary_row>(
+        arguments, *file, first, count, offset, schema.row_size);
+    }
+    return run<int64_t, reelay::binary_row>(
+      arguments, *file, first, count, offset, schema.row_size);
   }
-  std::cout << "---" << std::endl;
 
-  return 0;
+  // Timescales records follow a 4-byte record count header
+  auto records = file->records<tx_binary_input_t>(sizeof(uint32_t));
+  return run<int32_t, tx_binary_input_t>(
+    arguments,
+    *file,
+    records.begin(),
+    records.size(),
+    sizeof(uint32_t),
+    sizeof(tx_binary_input_t));
 }
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2019-2025 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <argp.h>
+#include <reelay/io/csv_row.hpp>
+#include <reelay/io/verdict_file.hpp>
+#include <reelay/monitors.hpp>
+#include <reelay/parser/ptl_inspector.hpp>
+
+// argp option keys
+enum RYCSV_OPTS : uint8_t {
+  OPT_DENSE = 'v',
+  OPT_DISCRETE = 'x',
+  OPT_BINARY = 'B',
+  OPT_DELIMITER = 'd'
+};
+
+const char* argp_program_version = "rycsv 0.1.0";
+const char* argp_program_bug_address = "Dogan Ulus <github.com/doganulus>";
+static const char* doc =
+  "Reelay on delimited text files (CSV, TSV) with a header line";
+static const char* args_doc = "SPEC FILE";
+
+struct arguments {
+  char* spec;
+  char* file;
+  bool dense = false;
+  bool discrete = false;
+  bool binary = false;
+  char delimiter = ',';
+};
+
+static std::array<struct argp_option, 5> options = {
+  {{"dense", OPT_DENSE, nullptr, 0, "Use dense time model", 0},
+   {"discrete", OPT_DISCRETE, nullptr, 0, "Use discrete time model (default)", 0},
+   {"binary",
+    OPT_BINARY,
+    nullptr,
+    0,
+    "Write verdicts in binary format (.rylb)",
+    0},
+   {"delimiter",
+    OPT_DELIMITER,
+    "CHAR",
+    0,
+    "Use CHAR to separate cells, `tab` for tabs (default: ,)",
+    0},
+   {nullptr}}};
+
+static error_t parse_opt(int key, char* arg, struct argp_state* state)
+{
+  auto* arguments = (struct arguments*)state->input;
+  switch(key) {
+    case OPT_DENSE:
+      arguments->dense = true;
+      break;
+    case OPT_DISCRETE:
+      arguments->discrete = true;
+      break;
+    case OPT_BINARY:
+      arguments->binary = true;
+      break;
+    case OPT_DELIMITER:
+      if(std::strcmp(arg, "tab") == 0 or std::strcmp(arg, "\\t") == 0) {
+        arguments->delimiter = '\t';
+      }
+      else if(std::strlen(arg) == 1 and arg[0] != '\n') {
+        arguments->delimiter = arg[0];
+      }
+      else {
+        argp_error(state, "Delimiter must be a single character");
+      }
+      break;
+    case ARGP_KEY_ARG:
+      if(state->arg_num == 0) {
+        arguments->spec = arg;
+      }
+      else {
+        arguments->file = arg;
+      }
+      break;
+    case ARGP_KEY_END:
+      if(state->arg_num < 2) {
+        argp_usage(state);
+      }
+      break;
+    default:
+      return ARGP_ERR_UNKNOWN;
+  }
+  return 0;
+}
+static struct argp argp = {options.data(), parse_opt, args_doc, doc};
+
+template<typename TimeT>
+void write_verdict(std::ostream& os, TimeT time, bool value)
+{
+  if constexpr(std::is_floating_point_v<TimeT>) {
+    os << reelay::json({{"time", time}, {"value", value}});
+  }
+  else {
+    os << "{\"time\":" << time << ",\"value\":" << (value ? "true" : "false")
+       << "}";
+  }
+}
+
+// Monitors the rows of `reader` and writes verdicts next to the input file
+template<typename MonitorT>
+int run(
+  const struct arguments& arguments,
+  const reelay::csv_reader& reader,
+  const reelay::csv_table& table,
+  const reelay::basic_options& options,
+  reelay::verdict_model model)
+{
+  using time_t = typename MonitorT::time_type;
+
+  std::optional<MonitorT> monitor;
+  try {
+    monitor.emplace(MonitorT::make(arguments.spec, options));
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  std::string filename = arguments.file;
+  std::string output_filename =
+    filename + (arguments.binary ? ".rylb" : ".ryl");
+  std::ofstream output(output_filename, std::ios::binary);
+  if(!output) {
+    std::cerr << "Error creating output" << std::endl;
+    return 1;
+  }
+  std::cout << "Processing " << filename << std::endl;
+  std::cout << "---" << std::endl;
+
+  uint64_t errn = 0;
+
+  std::optional<reelay::verdict_writer<time_t, bool>> writer;
+  if(arguments.binary) {
+    writer.emplace(output, model);
+  }
+
+  auto sink = [&](time_t time, bool value) {
+    if(writer) {
+      (*writer)(time, value);
+    }
+    else {
+      write_verdict(output, time, value);
+      output << '\n';
+    }
+    if(errn < 5) {
+      write_verdict(std::cout, time, value);
+      std::cout << std::endl;
+    }
+    else if(errn == 5) {
+      std::cout << "..." << std::endl;
+    }
+    errn++;
+  };
+
+  try {
+    reader.for_each(table, [&](const reelay::csv_record& row) {
+      monitor->push(row, sink);
+    });
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  if(writer) {
+    writer->flush();
+  }
+  if(errn <= 5) {
+    std::cout << "---" << std::endl;
+  }
+  std::cout << "Full output written to " + output_filename << std::endl;
+
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  struct arguments arguments;
+  argp_parse(&argp, argc, argv, 0, nullptr, &arguments);
+
+  using input_t = reelay::csv_record;
+  using output_t = reelay::json;
+
+  std::optional<reelay::csv_reader> reader;
+  try {
+    reader.emplace(arguments.file);
+  }
+  catch(const std::runtime_error& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  // Only the columns referenced by the specification are read
+  auto inspection = reelay::ptl_inspector().inspect(arguments.spec);
+  if(reelay::any_cast<bool>(inspection["has_nested_keys"])) {
+    std::cerr << "Nested keys are not supported for delimited text"
+              << std::endl;
+    return 1;
+  }
+  bool has_references = reelay::any_cast<bool>(inspection["has_references"]);
+
+  // Discrete monitors count rows, so only dense ones need a time column
+  bool dense = arguments.dense and not arguments.discrete;
+
+  std::optional<reelay::csv_table> table;
+  try {
+    table.emplace(
+      reader->header(),
+      reelay::any_cast<std::vector<std::string>>(inspection["keys"]),
+      arguments.delimiter,
+      dense);
+  }
+  catch(const std::out_of_range& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  auto options = reelay::basic_options();
+  if(has_references) {
+    options.with_data_manager();
+  }
+
+  if(dense) {
+    auto model = reelay::verdict_model::dense;
+    if(has_references) {
+      return run<reelay::dense_timed_data_monitor<double, input_t, output_t>>(
+        arguments, *reader, *table, options, model);
+    }
+    return run<reelay::dense_timed_monitor<double, input_t, output_t>>(
+      arguments, *reader, *table, options, model);
+  }
+
+  auto model = reelay::verdict_model::discrete;
+  if(has_references) {
+    return run<
+      reelay::discrete_timed_data_monitor<int64_t, input_t, output_t, true>>(
+      arguments, *reader, *table, options, model);
+  }
+  return run<reelay::discrete_timed_monitor<int64_t, input_t, output_t, true>>(
+    arguments, *reader, *table, options, model);
+}
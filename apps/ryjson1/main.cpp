@@ -6,84 +6,156 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 
+#include "reelay/io/verdict_file.hpp"
 #include "reelay/json.hpp"
 #include "reelay/monitors.hpp"
+#include "reelay/profiling/run_profile.hpp"
 
 #include <array>
 #include <cstring>  // memset()
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "ondemand_adapter.hpp"
+#include "pipeline.hpp"
 #include "simdjson.h"
 #include "simdjson_adapter.hpp"
 #include <argp.h>
 
 namespace rycli {
 
-template<typename X, typename Y>
-void discrete_timed_processing(
-  reelay::monitor<X, Y>& monitor, const std::string& filename)
+template<typename T>
+struct input_tag {
+  using type = T;
+};
+
+// Flattens dense results so that `emit` receives one verdict at a time
+template<typename EmitT>
+void for_each_verdict(const reelay::json& result, EmitT&& emit)
+{
+  if(result.is_array()) {
+    for(const auto& item : result) {
+      emit(item);
+    }
+  }
+  else if(not result.empty()) {
+    emit(result);
+  }
+}
+
+// Times one update from the end of the previous one: the time in between is
+// spent reading the next input, then the update and its verdicts follow
+template<typename UpdateT, typename EmitT>
+void profiled_update(
+  reelay::run_profile& profile,
+  reelay::run_profile::clock::time_point& mark,
+  UpdateT&& update,
+  EmitT&& emit)
+{
+  using phase = reelay::run_profile::phase;
+
+  profile.charge(phase::parse, mark);
+  reelay::json result;
+  profile.measure_event([&] { result = update(); });
+  profile.measure(phase::output, [&] {
+    for_each_verdict(result, [&](const reelay::json& item) {
+      profile.verdicts++;
+      emit(item);
+    });
+  });
+  mark = reelay::run_profile::clock::now();
+}
+
+template<typename X, typename Y, typename EmitT>
+void dom_verdicts(
+  reelay::monitor<X, Y>& monitor,
+  const std::string& filename,
+  EmitT&& emit,
+  reelay::run_profile* profile = nullptr)
 {
-  int stdout_line_count = 0;
   simdjson::dom::parser reader;
-  std::ofstream output_file(filename + ".ryl");
-  std::cout << "Processing " + filename << std::endl;
-  std::cout << "---" << std::endl;
+  auto mark = reelay::run_profile::clock::now();
   for(simdjson::dom::element doc : reader.load_many(filename)) {
-    reelay::json result = monitor.update(doc);
-    if(not result.empty()) {
-      if(stdout_line_count < 5) {
-        std::cout << result << std::endl;
-        stdout_line_count++;
-      }
-      else if(stdout_line_count == 5) {
-        std::cout << "..." << std::endl;
-        stdout_line_count++;
-      }
-      output_file << result << std::endl;
+    if(profile != nullptr) {
+      profiled_update(
+        *profile, mark, [&] { return monitor.update(doc); }, emit);
+    }
+    else {
+      for_each_verdict(monitor.update(doc), emit);
     }
   }
-  if(stdout_line_count < 5) {
-    std::cout << "---" << std::endl;
-  }
-  std::cout << "Full output written to " + filename + ".ryl" << std::endl;
 }
 
-template<typename X, typename Y>
-void dense_timed_processing(
-  reelay::monitor<X, Y>& monitor, const std::string& filename)
+template<typename Y, typename EmitT>
+void ondemand_verdicts(
+  reelay::monitor<slot_record, Y>& monitor,
+  const std::string& filename,
+  const slot_table& table,
+  EmitT&& emit,
+  reelay::run_profile* profile = nullptr)
+{
+  auto mark = reelay::run_profile::clock::now();
+  for_each_record(filename, table, [&](const slot_record& record) {
+    if(profile != nullptr) {
+      profiled_update(
+        *profile, mark, [&] { return monitor.update(record); }, emit);
+    }
+    else {
+      for_each_verdict(monitor.update(record), emit);
+    }
+  });
+}
+
+template<typename SourceT>
+void text_processing(const std::string& filename, SourceT&& source)
 {
   int stdout_line_count = 0;
-  simdjson::dom::parser reader;
   std::ofstream output_file(filename + ".ryl");
   std::cout << "Processing " + filename << std::endl;
   std::cout << "---" << std::endl;
-  for(simdjson::dom::element doc : reader.load_many(filename)) {
-    reelay::json result = monitor.update(doc);
-    if(not result.empty()) {
-      for(const auto& item : result) {
-        if(stdout_line_count < 5) {
-          std::cout << item << std::endl;
-          stdout_line_count++;
-        }
-        else if(stdout_line_count == 5) {
-          std::cout << "..." << std::endl;
-          stdout_line_count++;
-        }
-        output_file << item << std::endl;
-      }
+  auto emit = [&](const reelay::json& item) {
+    if(stdout_line_count < 5) {
+      std::cout << item << std::endl;
+      stdout_line_count++;
     }
-  }
+    else if(stdout_line_count == 5) {
+      std::cout << "..." << std::endl;
+      stdout_line_count++;
+    }
+    output_file << item << '\n';
+  };
+  source(filename, emit);
   if(stdout_line_count < 5) {
     std::cout << "---" << std::endl;
   }
   std::cout << "Full output written to " + filename + ".ryl" << std::endl;
 }
 
+template<typename TimeT, typename ValueT, typename SourceT>
+void binary_processing(
+  const std::string& filename,
+  reelay::verdict_model model,
+  const std::string& tname,
+  const std::string& yname,
+  SourceT&& source)
+{
+  std::ofstream output_file(filename + ".rylb", std::ios::binary);
+  reelay::verdict_writer<TimeT, ValueT> writer(output_file, model);
+  auto emit = [&](const reelay::json& item) {
+    writer(item[tname].get<TimeT>(), item[yname].get<ValueT>());
+  };
+  std::cout << "Processing " + filename << std::endl;
+  source(filename, emit);
+  writer.flush();
+  std::cout << "Full output written to " + filename + ".rylb" << std::endl;
+}
+
 }  // namespace rycli
 
 // argp option keys
@@ -98,7 +170,11 @@ enum {
   OPT_PWL = 'l',
   OPT_NO_CONDENSE = 'z',
   OPT_TNAME = 1000,
-  OPT_YNAME
+  OPT_YNAME,
+  OPT_BINARY,
+  OPT_PIPELINE,
+  OPT_ONDEMAND,
+  OPT_STATS
 };
 
 const char* argp_program_version = "ryjson 1.0";
@@ -120,11 +196,16 @@ struct arguments {
   bool pwc = false;
   bool pwl = false;
   bool no_condense = false;
+  bool binary = false;
+  bool pipeline = false;
+  bool ondemand = false;
+  bool stats = false;
+  char* stats_file = nullptr;
   std::string tname = "time";
   std::string yname = "value";
 };
 
-static std::array<struct argp_option, 12> options = {
+static std::array<struct argp_option, 16> options = {
   {{"dense", OPT_DENSE, nullptr, 0, "Use dense time model (default)", 0},
    {"discrete", OPT_DISCRETE, nullptr, 0, "Use discrete time model", 0},
    {"itime", OPT_ITIME, nullptr, 0, "Use int64 as time type (default)", 0},
@@ -156,6 +237,30 @@ static std::array<struct argp_option, 12> options = {
     0,
     "Use STRING as the name of output field",
     0},
+   {"binary",
+    OPT_BINARY,
+    nullptr,
+    0,
+    "Write verdicts in binary format (.rylb)",
+    0},
+   {"pipeline",
+    OPT_PIPELINE,
+    nullptr,
+    0,
+    "Parse, monitor and write on separate threads",
+    0},
+   {"ondemand",
+    OPT_ONDEMAND,
+    nullptr,
+    0,
+    "Decode only the fields used by SPEC (simdjson On-Demand)",
+    0},
+   {"stats",
+    OPT_STATS,
+    "FILE",
+    OPTION_ARG_OPTIONAL,
+    "Report throughput and per-event latency as JSON to FILE or stderr",
+    0},
    {nullptr}}};
 
 static error_t parse_opt(int key, char* arg, struct argp_state* state)
@@ -195,6 +300,19 @@ static error_t parse_opt(int key, char* arg, struct argp_state* state)
     case OPT_YNAME:
       arguments->yname = arg;
       break;
+    case OPT_BINARY:
+      arguments->binary = true;
+      break;
+    case OPT_PIPELINE:
+      arguments->pipeline = true;
+      break;
+    case OPT_ONDEMAND:
+      arguments->ondemand = true;
+      break;
+    case OPT_STATS:
+      arguments->stats = true;
+      arguments->stats_file = arg;
+      break;
     case ARGP_KEY_ARG:
       if(state->arg_num == 0) {
         arguments->spec = arg;
@@ -207,6 +325,9 @@ static error_t parse_opt(int key, char* arg, struct argp_state* state)
       if(state->arg_num < 2) {
         argp_usage(state);
       }
+      if(arguments->ondemand and arguments->pipeline) {
+        argp_error(state, "--ondemand cannot be used with --pipeline");
+      }
       break;
     default:
       return ARGP_ERR_UNKNOWN;
@@ -222,9 +343,6 @@ int main(int argc, char** argv)
   struct arguments arguments;
   argp_parse(&argp, argc, argv, 0, nullptr, &arguments);
 
-  using input_t = simdjson::dom::element;
-  using output_t = reelay::json;
-
   // Choices
   bool use_discrete = arguments.discrete;
   bool use_dense = arguments.dense;
@@ -249,84 +367,160 @@ int main(int argc, char** argv)
     use_constant = true;
   }
 
-  using input_t = simdjson::dom::element;
-  using output_t = reelay::json;
+  auto make_cli_monitor = [&](auto tag) {
+    using input_t = typename decltype(tag)::type;
+    using output_t = reelay::json;
 
-  auto manager = std::make_shared<reelay::binding_manager>();
-  auto monitor = reelay::monitor<input_t, output_t>();
+    auto manager = std::make_shared<reelay::binding_manager>();
+    auto monitor = reelay::monitor<input_t, output_t>();
 
-  if(use_discrete && use_boolean) {  // -x -xb -xbz
-    auto opts =
-      reelay::discrete_timed<int64_t>::monitor<input_t, output_t>::options()
-        .with_time_field_name(arguments.tname)
-        .with_value_field_name(arguments.yname)
-        .with_condensing(!arguments.no_condense)
-        .with_data_manager(manager);
-    monitor = reelay::make_monitor(arguments.spec, opts);
-  }
-  else if(use_discrete && use_robustness) {  // -xr -xrz
-    auto opts = reelay::discrete_timed<int64_t>::robustness<
-                  double>::monitor<input_t, output_t>::options()
-                  .with_time_field_name(arguments.tname)
-                  .with_value_field_name(arguments.yname)
-                  .with_condensing(!arguments.no_condense);
-    monitor = reelay::make_monitor(arguments.spec, opts);
-  }
-  else if(use_dense && use_boolean && use_integer) {  // -vbi
-    auto opts =
-      reelay::dense_timed<int64_t>::monitor<input_t, output_t>::options()
-        .with_time_field_name(arguments.tname)
-        .with_value_field_name(arguments.yname)
-        .with_data_manager(manager);
-    monitor = reelay::make_monitor(arguments.spec, opts);
-  }
-  else if(use_dense && use_boolean && use_floating && use_constant) {  // -vbf,
-                                                                       // -vbfk
-    auto opts =
-      reelay::dense_timed<double>::monitor<input_t, output_t>::options()
-        .with_time_field_name(arguments.tname)
-        .with_value_field_name(arguments.yname)
-        .with_interpolation(reelay::piecewise::constant)
-        .with_data_manager(manager);
-    monitor = reelay::make_monitor(arguments.spec, opts);
-  }
-  else if(use_dense && use_boolean && use_floating && use_linear) {  // -vbfl
-    auto opts =
-      reelay::dense_timed<double>::monitor<input_t, output_t>::options()
-        .with_time_field_name(arguments.tname)
-        .with_value_field_name(arguments.yname)
-        .with_interpolation(reelay::piecewise::linear)
-        .with_data_manager(manager);
-    monitor = reelay::make_monitor(arguments.spec, opts);
-  }
-  else if(use_dense && use_robustness && use_integer) {  // -vri
-    auto opts = reelay::dense_timed<int64_t>::robustness<
-                  double>::monitor<input_t, output_t>::options()
-                  .with_time_field_name(arguments.tname)
-                  .with_value_field_name(arguments.yname);
-    monitor = reelay::make_monitor(arguments.spec, opts);
-  }
-  else if(use_dense && use_robustness && use_floating) {  // -vrf
-    auto opts = reelay::dense_timed<double>::robustness<
-                  double>::monitor<input_t, output_t>::options()
-                  .with_time_field_name(arguments.tname)
-                  .with_value_field_name(arguments.yname);
-    monitor = reelay::make_monitor(arguments.spec, opts);
-  }
-  else {
-    throw std::invalid_argument("Unsupported flag combination");
+    if(use_discrete && use_boolean) {  // -x -xb -xbz
+      auto opts =
+        reelay::discrete_timed<int64_t>::template monitor<input_t, output_t>::options()
+          .with_time_field_name(arguments.tname)
+          .with_value_field_name(arguments.yname)
+          .with_condensing(!arguments.no_condense)
+          .with_data_manager(manager);
+      monitor = reelay::make_monitor(arguments.spec, opts);
+    }
+    else if(use_discrete && use_robustness) {  // -xr -xrz
+      auto opts = reelay::discrete_timed<int64_t>::robustness<
+                    double>::template monitor<input_t, output_t>::options()
+                    .with_time_field_name(arguments.tname)
+                    .with_value_field_name(arguments.yname)
+                    .with_condensing(!arguments.no_condense);
+      monitor = reelay::make_monitor(arguments.spec, opts);
+    }
+    else if(use_dense && use_boolean && use_integer) {  // -vbi
+      auto opts =
+        reelay::dense_timed<int64_t>::template monitor<input_t, output_t>::options()
+          .with_time_field_name(arguments.tname)
+          .with_value_field_name(arguments.yname)
+          .with_data_manager(manager);
+      monitor = reelay::make_monitor(arguments.spec, opts);
+    }
+    else if(use_dense && use_boolean && use_floating && use_constant) {  // -vbf,
+                                                                         // -vbfk
+      auto opts =
+        reelay::dense_timed<double>::template monitor<input_t, output_t>::options()
+          .with_time_field_name(arguments.tname)
+          .with_value_field_name(arguments.yname)
+          .with_interpolation(reelay::piecewise::constant)
+          .with_data_manager(manager);
+      monitor = reelay::make_monitor(arguments.spec, opts);
+    }
+    else if(use_dense && use_boolean && use_floating && use_linear) {  // -vbfl
+      auto opts =
+        reelay::dense_timed<double>::template monitor<input_t, output_t>::options()
+          .with_time_field_name(arguments.tname)
+          .with_value_field_name(arguments.yname)
+          .with_interpolation(reelay::piecewise::linear)
+          .with_data_manager(manager);
+      monitor = reelay::make_monitor(arguments.spec, opts);
+    }
+    else if(use_dense && use_robustness && use_integer) {  // -vri
+      auto opts = reelay::dense_timed<int64_t>::robustness<
+                    double>::template monitor<input_t, output_t>::options()
+                    .with_time_field_name(arguments.tname)
+                    .with_value_field_name(arguments.yname);
+      monitor = reelay::make_monitor(arguments.spec, opts);
+    }
+    else if(use_dense && use_robustness && use_floating) {  // -vrf
+      auto opts = reelay::dense_timed<double>::robustness<
+                    double>::template monitor<input_t, output_t>::options()
+                    .with_time_field_name(arguments.tname)
+                    .with_value_field_name(arguments.yname);
+      monitor = reelay::make_monitor(arguments.spec, opts);
+    }
+    else {
+      throw std::invalid_argument("Unsupported flag combination");
+    }
+    return monitor;
+  };
+
+  std::optional<reelay::run_profile> profile;
+  if(arguments.stats) {
+    profile.emplace();
   }
+  auto* profiled = profile ? &*profile : nullptr;
 
-  if(use_discrete) {
+  // Reports the profile at exit, after the last file is written
+  auto report = [&]() {
+    if(not profile) {
+      return 0;
+    }
+    profile->stop();
+    if(arguments.stats_file == nullptr) {
+      profile->write(std::cerr);
+      return 0;
+    }
+    std::ofstream stats(arguments.stats_file);
+    if(!stats) {
+      std::cerr << "Error creating " << arguments.stats_file << std::endl;
+      return 1;
+    }
+    profile->write(stats);
+    return 0;
+  };
+
+  auto process = [&](auto&& source) {
+    auto model = use_discrete ? reelay::verdict_model::discrete
+                              : reelay::verdict_model::dense;
     for(const auto& filename : arguments.files) {
-      rycli::discrete_timed_processing(monitor, filename);
+      if(profile) {
+        profile->bytes += std::filesystem::file_size(filename);
+      }
+      if(not arguments.binary) {
+        rycli::text_processing(filename, source);
+      }
+      else if((use_discrete || use_integer) && use_boolean) {
+        rycli::binary_processing<int64_t, bool>(
+          filename, model, arguments.tname, arguments.yname, source);
+      }
+      else if(use_discrete || use_integer) {
+        rycli::binary_processing<int64_t, double>(
+          filename, model, arguments.tname, arguments.yname, source);
+      }
+      else if(use_boolean) {
+        rycli::binary_processing<double, bool>(
+          filename, model, arguments.tname, arguments.yname, source);
+      }
+      else {
+        rycli::binary_processing<double, double>(
+          filename, model, arguments.tname, arguments.yname, source);
+      }
     }
+  };
+
+  if(arguments.ondemand) {
+    auto inspection = reelay::ptl_inspector().inspect(arguments.spec);
+    if(not reelay::any_cast<bool>(inspection["has_nested_keys"])) {
+      auto table = rycli::slot_table(
+        reelay::any_cast<std::vector<std::string>>(inspection["keys"]));
+      auto monitor = make_cli_monitor(rycli::input_tag<rycli::slot_record>{});
+      process([&](const std::string& filename, auto&& emit) {
+        rycli::ondemand_verdicts(monitor, filename, table, emit, profiled);
+      });
+      return report();
+    }
+    std::cerr << "Nested keys are not supported by --ondemand, using DOM"
+              << std::endl;
+  }
+
+  auto monitor = make_cli_monitor(rycli::input_tag<simdjson::dom::element>{});
+
+  if(arguments.pipeline) {
+    auto options = rycli::pipeline_options();
+    options.profile = profiled;
+    process([&](const std::string& filename, auto&& emit) {
+      rycli::run_pipeline(monitor, filename, emit, options);
+    });
   }
   else {
-    for(const auto& filename : arguments.files) {
-      rycli::dense_timed_processing(monitor, filename);
-    }
+    process([&](const std::string& filename, auto&& emit) {
+      rycli::dom_verdicts(monitor, filename, emit, profiled);
+    });
   }
 
-  return 0;
+  return report();
 }
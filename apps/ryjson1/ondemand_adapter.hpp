@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2019-2025 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "reelay/datafield.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "simdjson.h"
+
+namespace rycli {
+
+/*
+ * Precompiled key set for the simdjson On-Demand adapter.
+ *
+ * Every key referenced by the specification gets a slot; the time field is
+ * always slot zero. Documents are scanned once and only the declared fields
+ * are decoded into a typed slot array, which the atoms then read.
+ */
+struct slot_table {
+  std::vector<std::string> keys;
+  std::unordered_map<std::string_view, std::size_t> index;
+
+  explicit slot_table(const std::vector<std::string>& keylist)
+  {
+    keys.emplace_back("time");
+    for(const auto& key : keylist) {
+      if(key != "time") {
+        keys.push_back(key);
+      }
+    }
+    // Views refer to `keys`, which must not change from now on
+    for(std::size_t i = 0; i < keys.size(); i++) {
+      index.emplace(keys[i], i);
+    }
+  }
+
+  slot_table(const slot_table&) = delete;
+  slot_table& operator=(const slot_table&) = delete;
+
+  std::size_t size() const
+  {
+    return keys.size();
+  }
+
+  // Slot of a declared key, or the number of slots if undeclared
+  std::size_t find(const std::string& key) const
+  {
+    auto it = index.find(key);
+    return it == index.end() ? keys.size() : it->second;
+  }
+
+  // Slot of an atom key, which is bound to this table on first use
+  std::size_t find(const reelay::layout_key& key) const
+  {
+    return key.slot(
+      this, [this](const std::string& name) { return find(name); });
+  }
+
+  template<typename KeyT>
+  std::size_t slot(const KeyT& key) const
+  {
+    std::size_t i = find(key);
+    if(i == keys.size()) {
+      throw std::out_of_range("Undeclared key: " + std::string(key));
+    }
+    return i;
+  }
+};
+
+enum class slot_kind : uint8_t { missing, boolean, number, string, other };
+
+struct field_slot {
+  slot_kind kind = slot_kind::missing;
+  bool boolean = false;
+  int64_t integer = 0;
+  double floating = 0.0;
+  std::string_view string;
+};
+
+/*
+ * Monitor input holding the declared fields of the current document.
+ * String slots refer to parser buffers and are valid until the next document.
+ */
+struct slot_record {
+  const slot_table* table = nullptr;
+  std::vector<field_slot> slots;
+
+  slot_record() = default;
+  explicit slot_record(const slot_table& t) : table(&t), slots(t.size()) {}
+
+  void extract(simdjson::ondemand::object object)
+  {
+    for(auto& slot : slots) {
+      slot.kind = slot_kind::missing;
+    }
+
+    std::size_t remaining = slots.size();
+    for(auto field : object) {
+      std::string_view key = field.unescaped_key();
+      auto it = table->index.find(key);
+      if(it == table->index.end()) {
+        continue;  // On-Demand skips the value
+      }
+
+      field_slot& slot = slots[it->second];
+      if(slot.kind != slot_kind::missing) {
+        continue;  // First occurrence wins as in the DOM adapter
+      }
+
+      simdjson::ondemand::value value = field.value();
+      switch(value.type()) {
+        case simdjson::ondemand::json_type::boolean:
+          slot.kind = slot_kind::boolean;
+          slot.boolean = value.get_bool();
+          break;
+        case simdjson::ondemand::json_type::number: {
+          simdjson::ondemand::number number = value.get_number();
+          slot.kind = slot_kind::number;
+          if(number.is_int64()) {
+            slot.integer = number.get_int64();
+            slot.floating = static_cast<double>(slot.integer);
+          }
+          else {
+            slot.floating = number.as_double();
+            slot.integer = static_cast<int64_t>(slot.floating);
+          }
+          break;
+        }
+        case simdjson::ondemand::json_type::string:
+          slot.kind = slot_kind::string;
+          slot.string = value.get_string();
+          break;
+        default:
+          slot.kind = slot_kind::other;
+          break;
+      }
+
+      if(--remaining == 0) {
+        break;  // All declared fields found
+      }
+    }
+  }
+
+  template<typename KeyT>
+  const field_slot& at(const KeyT& key) const
+  {
+    return slots[table->slot(key)];
+  }
+
+  static const field_slot& expect(const field_slot& slot, slot_kind kind)
+  {
+    if(slot.kind != kind) {
+      throw simdjson::simdjson_error(simdjson::INCORRECT_TYPE);
+    }
+    return slot;
+  }
+};
+
+/*
+ * Scans newline-delimited JSON with On-Demand and calls `fn` with the record
+ * of every document.
+ */
+template<typename FunctionT>
+void for_each_record(
+  const std::string& filename, const slot_table& table, FunctionT&& fn)
+{
+  simdjson::padded_string json;
+  auto error = simdjson::padded_string::load(filename).get(json);
+  if(error) {
+    throw simdjson::simdjson_error(error);
+  }
+
+  simdjson::ondemand::parser parser;
+  simdjson::ondemand::document_stream stream = parser.iterate_many(json);
+
+  auto record = slot_record(table);
+  for(auto doc : stream) {
+    record.extract(doc.get_object());
+    fn(record);
+  }
+}
+
+}  // namespace rycli
+
+namespace reelay {
+
+template<typename T>
+struct timefield<T, rycli::slot_record> {
+  using input_t = rycli::slot_record;
+  inline static T get_time(const input_t& container)
+  {
+    const auto& slot =
+      input_t::expect(container.slots[0], rycli::slot_kind::number);
+    if constexpr(std::is_integral_v<T>) {
+      return static_cast<T>(slot.integer);
+    }
+    else {
+      return static_cast<T>(slot.floating);
+    }
+  }
+};
+
+template<>
+struct datafield<rycli::slot_record> {
+  using input_t = rycli::slot_record;
+  using key_type = layout_key;
+  using kind = rycli::slot_kind;
+
+  inline static input_t at(const input_t& /*container*/, const std::string& key)
+  {
+    throw std::invalid_argument("Nested fields are not supported: " + key);
+  }
+
+  inline static input_t at(const input_t& /*container*/, std::size_t /*index*/)
+  {
+    throw std::invalid_argument("Nested fields are not supported");
+  }
+
+  inline static bool contains(const input_t& container, const std::string& key)
+  {
+    return container.at(key).kind != kind::missing;
+  }
+
+  inline static bool contains(const input_t& container, std::string_view key)
+  {
+    auto it = container.table->index.find(key);
+    return it != container.table->index.end() and
+           container.slots[it->second].kind != kind::missing;
+  }
+
+  inline static bool as_bool(const input_t& container, const std::string& key)
+  {
+    return input_t::expect(container.at(key), kind::boolean).boolean;
+  }
+
+  inline static int64_t as_integer(
+    const input_t& container, const std::string& key)
+  {
+    return input_t::expect(container.at(key), kind::number).integer;
+  }
+
+  inline static double as_floating(
+    const input_t& container, const std::string& key)
+  {
+    return input_t::expect(container.at(key), kind::number).floating;
+  }
+
+  inline static std::string as_string(
+    const input_t& container, const std::string& key)
+  {
+    return std::string(input_t::expect(container.at(key), kind::string).string);
+  }
+
+  inline static std::string_view as_string_view(
+    const input_t& container, const std::string& key)
+  {
+    return input_t::expect(container.at(key), kind::string).string;
+  }
+
+  // Atoms read through their bound keys
+  inline static bool contains(const input_t& container, const key_type& key)
+  {
+    return container.at(key).kind != kind::missing;
+  }
+
+  inline static bool as_bool(const input_t& container, const key_type& key)
+  {
+    return input_t::expect(container.at(key), kind::boolean).boolean;
+  }
+
+  inline static int64_t as_integer(
+    const input_t& container, const key_type& key)
+  {
+    return input_t::expect(container.at(key), kind::number).integer;
+  }
+
+  inline static double as_floating(
+    const input_t& container, const key_type& key)
+  {
+    return input_t::expect(container.at(key), kind::number).floating;
+  }
+
+  inline static std::string as_string(
+    const input_t& container, const key_type& key)
+  {
+    return std::string(input_t::expect(container.at(key), kind::string).string);
+  }
+
+  inline static std::string_view as_string_view(
+    const input_t& container, const key_type& key)
+  {
+    return input_t::expect(container.at(key), kind::string).string;
+  }
+
+  inline static bool contains(
+    const input_t& /*container*/, std::size_t /*index*/)
+  {
+    throw std::invalid_argument("Array records are not supported");
+  }
+
+  inline static bool as_bool(const input_t& /*container*/, std::size_t /*index*/)
+  {
+    throw std::invalid_argument("Array records are not supported");
+  }
+
+  inline static int as_integer(
+    const input_t& /*container*/, std::size_t /*index*/)
+  {
+    throw std::invalid_argument("Array records are not supported");
+  }
+
+  inline static double as_floating(
+    const input_t& /*container*/, std::size_t /*index*/)
+  {
+    throw std::invalid_argument("Array records are not supported");
+  }
+
+  inline static std::string as_string(
+    const input_t& /*container*/, std::size_t /*index*/)
+  {
+    throw std::invalid_argument("Array records are not supported");
+  }
+};
+
+}  // namespace reelay
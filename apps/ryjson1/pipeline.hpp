@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2019-2025 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "reelay/concurrency/spsc_queue.hpp"
+#include "reelay/json.hpp"
+#include "reelay/monitors.hpp"
+#include "reelay/profiling/run_profile.hpp"
+
+#include <cctype>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "simdjson.h"
+
+namespace rycli {
+
+/*
+ * Three-stage pipeline over newline-delimited JSON files.
+ *
+ * A parser thread parses batches of lines into reusable documents, the
+ * calling thread runs the monitor over each batch, and a writer thread hands
+ * every verdict to `emit`. Stages are connected by bounded SPSC queues and
+ * batches are recycled through return queues, so no stage allocates in the
+ * steady state. Each input line must hold exactly one JSON document.
+ *
+ * A profile only receives the monitor stage, whose updates it times one by
+ * one. Parsing and writing overlap with monitoring on their own threads, so
+ * their share shows in the total time alone.
+ */
+struct pipeline_options {
+  std::size_t batch_size = 1024;  // documents per batch
+  std::size_t depth = 8;          // batches in flight per stage
+  reelay::run_profile* profile = nullptr;
+};
+
+struct document_batch {
+  std::vector<simdjson::dom::document> documents;
+  std::vector<simdjson::dom::element> elements;
+};
+
+struct verdict_batch {
+  std::vector<reelay::json> verdicts;
+};
+
+template<typename X, typename Y, typename EmitT>
+void run_pipeline(
+  reelay::monitor<X, Y>& monitor,
+  const std::string& filename,
+  EmitT&& emit,
+  const pipeline_options& options = pipeline_options())
+{
+  // Parsing may fail before any thread starts
+  simdjson::padded_string json;
+  auto error = simdjson::padded_string::load(filename).get(json);
+  if(error) {
+    throw simdjson::simdjson_error(error);
+  }
+
+  const std::size_t depth = options.depth;
+
+  auto document_pool = std::vector<std::unique_ptr<document_batch>>();
+  auto verdict_pool = std::vector<std::unique_ptr<verdict_batch>>();
+
+  // Batches flow forward through `parsed` and `verdicts` queues and return
+  // to their producers through `free_*` queues. A null batch ends a stream.
+  reelay::spsc_queue<document_batch*> parsed(depth);
+  reelay::spsc_queue<document_batch*> free_documents(depth);
+  reelay::spsc_queue<verdict_batch*> verdicts(depth);
+  reelay::spsc_queue<verdict_batch*> free_verdicts(depth);
+
+  for(std::size_t i = 0; i < depth; i++) {
+    document_pool.push_back(std::make_unique<document_batch>());
+    // Elements point to their documents, which therefore must never move
+    document_pool.back()->documents.reserve(options.batch_size);
+    free_documents.push(document_pool.back().get());
+    verdict_pool.push_back(std::make_unique<verdict_batch>());
+    free_verdicts.push(verdict_pool.back().get());
+  }
+
+  std::exception_ptr parser_error = nullptr;
+  std::exception_ptr monitor_error = nullptr;
+  std::exception_ptr writer_error = nullptr;
+
+  std::thread parser_thread([&]() {
+    try {
+      simdjson::dom::parser parser;
+      const char* data = json.data();
+      const std::size_t size = json.size();
+      std::size_t pos = 0;
+
+      while(pos < size) {
+        document_batch* batch = free_documents.pop();
+        batch->elements.clear();
+
+        while(batch->elements.size() < options.batch_size and pos < size) {
+          const char* newline =
+            static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+          std::size_t end = newline != nullptr ? newline - data : size;
+          std::size_t len = end - pos;
+
+          bool blank = true;
+          for(std::size_t i = pos; i < end; i++) {
+            if(not std::isspace(static_cast<unsigned char>(data[i]))) {
+              blank = false;
+              break;
+            }
+          }
+
+          if(not blank) {
+            std::size_t k = batch->elements.size();
+            if(k == batch->documents.size()) {
+              batch->documents.emplace_back();
+            }
+            // Bytes after each line are readable up to the final padding
+            simdjson::dom::element element;
+            auto err = parser
+                         .parse_into_document(
+                           batch->documents[k], data + pos, len, false)
+                         .get(element);
+            if(err) {
+              throw simdjson::simdjson_error(err);
+            }
+            batch->elements.push_back(element);
+          }
+          pos = end + 1;
+        }
+        parsed.push(batch);
+      }
+    }
+    catch(...) {
+      parser_error = std::current_exception();
+    }
+    parsed.push(nullptr);
+  });
+
+  std::thread writer_thread([&]() {
+    while(verdict_batch* batch = verdicts.pop()) {
+      if(writer_error == nullptr) {
+        try {
+          for(const auto& item : batch->verdicts) {
+            emit(item);
+          }
+        }
+        catch(...) {
+          writer_error = std::current_exception();
+        }
+      }
+      free_verdicts.push(batch);
+    }
+  });
+
+  // The monitor stage runs on the calling thread and always drains its
+  // input so that the other stages can finish after an error.
+  while(document_batch* batch = parsed.pop()) {
+    if(monitor_error == nullptr) {
+      try {
+        verdict_batch* output = free_verdicts.pop();
+        output->verdicts.clear();
+        for(const auto& element : batch->elements) {
+          reelay::json result;
+          if(options.profile != nullptr) {
+            options.profile->measure_event(
+              [&] { result = monitor.update(element); });
+          }
+          else {
+            result = monitor.update(element);
+          }
+          if(result.is_array()) {
+            for(auto& item : result) {
+              output->verdicts.push_back(std::move(item));
+            }
+          }
+          else if(not result.empty()) {
+            output->verdicts.push_back(std::move(result));
+          }
+        }
+        if(options.profile != nullptr) {
+          options.profile->verdicts += output->verdicts.size();
+        }
+        verdicts.push(output);
+      }
+      catch(...) {
+        monitor_error = std::current_exception();
+      }
+    }
+    free_documents.push(batch);
+  }
+  verdicts.push(nullptr);
+
+  parser_thread.join();
+  writer_thread.join();
+
+  for(const auto& err : {parser_error, monitor_error, writer_error}) {
+    if(err != nullptr) {
+      std::rethrow_exception(err);
+    }
+  }
+}
+
+}  // namespace rycli
@@ -39,6 +39,11 @@ struct datafield<simdjson::dom::element> {
   }
 
   inline static bool contains(const input_t& container, const std::string& key)
+  {
+    return contains(container, std::string_view(key));
+  }
+
+  inline static bool contains(const input_t& container, std::string_view key)
   {
     for(simdjson::dom::object::iterator field =
           simdjson::dom::object(container).begin();
@@ -75,6 +80,12 @@ struct datafield<simdjson::dom::element> {
     return std::string(sv);
   }
 
+  inline static std::string_view as_string_view(
+    const input_t& container, const std::string& key)
+  {
+    return container.at_key(key).get<std::string_view>();
+  }
+
   inline static bool contains(const input_t& container, std::size_t index)
   {
     return index < simdjson::dom::array(container).size();
@@ -101,6 +112,12 @@ struct datafield<simdjson::dom::element> {
     std::string_view sv = container.at(index).get<std::string_view>();
     return std::string(sv);
   }
+
+  inline static std::string_view as_string_view(
+    const input_t& container, std::size_t index)
+  {
+    return container.at(index).get<std::string_view>();
+  }
 };
 
 }  // namespace reelay
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019-2025 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "reelay/io/verdict_file.hpp"
+
+#include <array>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <argp.h>
+
+// argp option keys
+enum { OPT_TNAME = 1000, OPT_YNAME };
+
+const char* argp_program_version = "rylconv 0.1.0";
+const char* argp_program_bug_address = "<doganulus@gmail.com>";
+static const char* doc =
+  "Convert binary Reelay verdict files (.rylb) to JSON lines on stdout";
+static const char* args_doc = "FILE...";
+
+struct arguments {
+  std::vector<std::string> files;
+  std::string tname = "time";
+  std::string yname = "value";
+};
+
+static std::array<struct argp_option, 3> options = {
+  {{"tname", OPT_TNAME, "STRING", 0, "Use STRING as the name of time field", 0},
+   {"yname",
+    OPT_YNAME,
+    "STRING",
+    0,
+    "Use STRING as the name of output field",
+    0},
+   {nullptr}}};
+
+static error_t parse_opt(int key, char* arg, struct argp_state* state)
+{
+  auto* arguments = (struct arguments*)state->input;
+  switch(key) {
+    case OPT_TNAME:
+      arguments->tname = arg;
+      break;
+    case OPT_YNAME:
+      arguments->yname = arg;
+      break;
+    case ARGP_KEY_ARG:
+      arguments->files.emplace_back(arg);
+      break;
+    case ARGP_KEY_END:
+      if(state->arg_num < 1) {
+        argp_usage(state);
+      }
+      break;
+    default:
+      return ARGP_ERR_UNKNOWN;
+  }
+  return 0;
+}
+static struct argp argp = {options.data(), parse_opt, args_doc, doc};
+
+int main(int argc, char** argv)
+{
+  struct arguments arguments;
+  argp_parse(&argp, argc, argv, 0, nullptr, &arguments);
+
+  std::ios::sync_with_stdio(false);
+
+  for(const auto& filename : arguments.files) {
+    try {
+      auto reader = reelay::verdict_reader(filename);
+      reader.to_json_lines(std::cout, arguments.tname, arguments.yname);
+    }
+    catch(const std::exception& e) {
+      std::cerr << e.what() << std::endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2019-2025 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "reelay/io/plan_file.hpp"
+#include "reelay/json.hpp"
+#include "reelay/networks.hpp"
+#include "reelay/parser/ptl_inspector.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <argp.h>
+
+// argp option keys
+enum RYPLAN_OPTS : uint8_t {
+  OPT_DENSE = 'v',
+  OPT_DISCRETE = 'x',
+  OPT_BUDGET = 'b',
+  OPT_RATE = 'r'
+};
+
+const char* argp_program_version = "ryplan 0.1.0";
+const char* argp_program_bug_address = "<doganulus@gmail.com>";
+static const char* doc =
+  "Compile a Reelay specification into a plan file (.rypl) that monitors "
+  "load without parsing";
+static const char* args_doc = "SPEC FILE";
+
+struct arguments {
+  std::string spec;
+  std::string file;
+  bool dense = false;
+  double budget = reelay::ptl_bounds::unbounded;
+  double rate = reelay::ptl_bounds::unbounded;
+};
+
+static std::array<struct argp_option, 5> options = {
+  {{"dense", OPT_DENSE, nullptr, 0, "Compile for dense time model", 0},
+   {"discrete",
+    OPT_DISCRETE,
+    nullptr,
+    0,
+    "Compile for discrete time model (default)",
+    0},
+   {"budget",
+    OPT_BUDGET,
+    "BYTES",
+    0,
+    "Reject SPEC if its monitor may need more memory than BYTES",
+    0},
+   {"rate",
+    OPT_RATE,
+    "R",
+    0,
+    "with -v, assume at most R input changes per time unit",
+    0},
+   {nullptr}}};
+
+static error_t parse_opt(int key, char* arg, struct argp_state* state)
+{
+  auto* arguments = (struct arguments*)state->input;
+  switch(key) {
+    case OPT_DENSE:
+      arguments->dense = true;
+      break;
+    case OPT_DISCRETE:
+      arguments->dense = false;
+      break;
+    case OPT_BUDGET:
+      arguments->budget = std::strtod(arg, nullptr);
+      break;
+    case OPT_RATE:
+      arguments->rate = std::strtod(arg, nullptr);
+      break;
+    case ARGP_KEY_ARG:
+      if(state->arg_num == 0) {
+        arguments->spec = arg;
+      }
+      else {
+        arguments->file = arg;
+      }
+      break;
+    case ARGP_KEY_END:
+      if(state->arg_num < 2) {
+        argp_usage(state);
+      }
+      break;
+    default:
+      return ARGP_ERR_UNKNOWN;
+  }
+  return 0;
+}
+static struct argp argp = {options.data(), parse_opt, args_doc, doc};
+
+// Plans do not depend on the time and input types of the network
+std::shared_ptr<const reelay::ptl_plan> compile(
+  const std::string& spec, const struct arguments& arguments)
+{
+  using input_t = reelay::json;
+
+  bool dense = arguments.dense;
+  auto inspection = reelay::ptl_inspector().admit(
+    spec, arguments.budget, dense, arguments.rate);
+  auto bounds = reelay::any_cast<reelay::ptl_bounds>(inspection["bounds"]);
+  std::cout << bounds.operators << " operators, " << bounds.states
+            << " states, " << bounds.windows << " windows ("
+            << bounds.unbounded_windows << " unbounded), horizon "
+            << bounds.horizon << ", memory "
+            << bounds.memory(dense, arguments.rate) << " bytes at most"
+            << std::endl;
+
+  bool has_references = reelay::any_cast<bool>(inspection["has_references"]);
+
+  if(dense and has_references) {
+    return reelay::dense_timed_data_network<double, input_t>::compile(spec);
+  }
+  if(dense) {
+    return reelay::dense_timed_network<double, input_t>::compile(spec);
+  }
+  if(has_references) {
+    return reelay::discrete_timed_data_network<int64_t, input_t>::compile(
+      spec);
+  }
+  return reelay::discrete_timed_network<int64_t, input_t>::compile(spec);
+}
+
+int main(int argc, char** argv)
+{
+  struct arguments arguments;
+  argp_parse(&argp, argc, argv, 0, nullptr, &arguments);
+
+  try {
+    auto plan = compile(arguments.spec, arguments);
+    reelay::save_plan(arguments.file, *plan);
+    std::cout << plan->setting << " plan with " << plan->steps.size()
+              << " steps written to " << arguments.file << std::endl;
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
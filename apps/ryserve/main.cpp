@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2019-2025 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "session.hpp"
+
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+#include <argp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// argp option keys
+enum RYSERVE_OPTS : uint8_t { OPT_QUIET = 'q' };
+
+const char* argp_program_version = "ryserve 0.1.0";
+const char* argp_program_bug_address = "Dogan Ulus <github.com/doganulus>";
+static const char* doc =
+  "Reelay monitoring daemon serving sessions over a Unix domain socket\v"
+  "Each session starts with a JSON line registering specifications, e.g.\n"
+  "  {\"specs\": [\"{p} since {q}\"], \"model\": \"discrete\", "
+  "\"format\": \"json\"}\n"
+  "followed by events as JSON lines (format json) or as a binary row stream "
+  "(format rows). Verdict changes are sent back as JSON lines.";
+static const char* args_doc = "SOCKET";
+
+struct arguments {
+  char* socket = nullptr;
+  bool quiet = false;
+};
+
+static std::array<struct argp_option, 2> options = {
+  {{"quiet", OPT_QUIET, nullptr, 0, "Do not log sessions", 0}, {nullptr}}};
+
+static error_t parse_opt(int key, char* arg, struct argp_state* state)
+{
+  auto* arguments = (struct arguments*)state->input;
+  switch(key) {
+    case OPT_QUIET:
+      arguments->quiet = true;
+      break;
+    case ARGP_KEY_ARG:
+      if(state->arg_num > 0) {
+        argp_usage(state);
+      }
+      arguments->socket = arg;
+      break;
+    case ARGP_KEY_END:
+      if(state->arg_num < 1) {
+        argp_usage(state);
+      }
+      break;
+    default:
+      return ARGP_ERR_UNKNOWN;
+  }
+  return 0;
+}
+static struct argp argp = {options.data(), parse_opt, args_doc, doc};
+
+static constexpr std::size_t read_size = 64 * 1024;           // 64 KiB
+static constexpr std::size_t output_limit = 16 * 1024 * 1024;  // 16 MiB
+static constexpr int max_events = 64;
+
+static volatile std::sig_atomic_t stopping = 0;
+
+static void stop(int /*signal*/)
+{
+  stopping = 1;
+}
+
+/*
+ * Single-threaded event loop over all sessions.
+ *
+ * Sockets are non-blocking and watched by epoll. A session is read while its
+ * pending output stays below the limit, so a client that does not read its
+ * verdicts is slowed down instead of growing the daemon without bound.
+ */
+struct server {
+  int listener = -1;
+  int poller = -1;
+  bool quiet = false;
+  std::string bound_path;
+  std::unordered_map<int, ryserve::session> sessions;
+
+  // Binds the socket with owner-only permissions; there is no remote access
+  void listen(const std::string& path)
+  {
+    auto address = sockaddr_un{};
+    address.sun_family = AF_UNIX;
+    if(path.size() >= sizeof(address.sun_path)) {
+      throw std::runtime_error("Socket path too long: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    // A stale socket of an earlier run is replaced, other files are not
+    struct stat st {};
+    if(::lstat(path.c_str(), &st) == 0 and S_ISSOCK(st.st_mode)) {
+      int error = probe(address);
+      if(error == 0) {
+        throw std::runtime_error("Socket in use: " + path);
+      }
+      if(error == ECONNREFUSED) {
+        ::unlink(path.c_str());
+      }
+    }
+
+    listener =
+      ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(listener < 0) {
+      throw std::runtime_error(
+        std::string("Error creating socket: ") + std::strerror(errno));
+    }
+    auto mask = ::umask(0077);
+    int bound =
+      ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    ::umask(mask);
+    if(bound < 0 or ::listen(listener, SOMAXCONN) < 0) {
+      throw std::runtime_error(
+        "Error binding socket: " + path + " (" + std::strerror(errno) + ")");
+    }
+    bound_path = path;
+
+    poller = ::epoll_create1(EPOLL_CLOEXEC);
+    if(poller < 0) {
+      throw std::runtime_error(
+        std::string("Error creating epoll: ") + std::strerror(errno));
+    }
+    watch(listener, EPOLLIN, EPOLL_CTL_ADD);
+  }
+
+  // Connects to the socket and returns errno of the attempt, or 0 if a
+  // daemon still accepts connections there
+  static int probe(const sockaddr_un& address)
+  {
+    int client = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(client < 0) {
+      throw std::runtime_error(
+        std::string("Error creating socket: ") + std::strerror(errno));
+    }
+    int connected = ::connect(
+      client, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    int error = connected < 0 ? errno : 0;
+    ::close(client);
+    return error;
+  }
+
+  void run()
+  {
+    auto events = std::array<epoll_event, max_events>();
+    while(not stopping) {
+      int n = ::epoll_wait(poller, events.data(), max_events, -1);
+      if(n < 0) {
+        if(errno == EINTR) {
+          continue;
+        }
+        throw std::runtime_error(
+          std::string("Error waiting for events: ") + std::strerror(errno));
+      }
+      for(int i = 0; i < n; i++) {
+        int fd = events[i].data.fd;
+        if(fd == listener) {
+          accept();
+        }
+        else {
+          serve(fd, events[i].events);
+        }
+      }
+    }
+  }
+
+  ~server()
+  {
+    for(const auto& entry : sessions) {
+      ::close(entry.first);
+    }
+    if(poller >= 0) {
+      ::close(poller);
+    }
+    if(listener >= 0) {
+      ::close(listener);
+    }
+    if(not bound_path.empty()) {
+      ::unlink(bound_path.c_str());
+    }
+  }
+
+ private:
+  void watch(int fd, uint32_t flags, int operation) const
+  {
+    auto event = epoll_event{};
+    event.events = flags;
+    event.data.fd = fd;
+    ::epoll_ctl(poller, operation, fd, &event);
+  }
+
+  void accept()
+  {
+    while(true) {
+      int fd =
+        ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if(fd < 0) {
+        return;  // EAGAIN once the backlog is drained
+      }
+      sessions[fd].fd = fd;
+      watch(fd, EPOLLIN | EPOLLRDHUP, EPOLL_CTL_ADD);
+      if(not quiet) {
+        std::cerr << "Session " << fd << " opened" << std::endl;
+      }
+    }
+  }
+
+  void serve(int fd, uint32_t flags)
+  {
+    auto& session = sessions.at(fd);
+
+    if(flags & (EPOLLERR | EPOLLHUP)) {
+      if(not(flags & EPOLLIN)) {
+        return close(session);
+      }
+    }
+
+    if(flags & EPOLLIN and not session.closing) {
+      receive(session);
+    }
+
+    if(not flush(session)) {
+      return close(session);
+    }
+    if(session.closing and session.pending() == 0) {
+      return close(session);
+    }
+
+    uint32_t interest = 0;
+    if(not session.closing and session.pending() < output_limit) {
+      interest |= EPOLLIN | EPOLLRDHUP;
+    }
+    if(session.pending() > 0) {
+      interest |= EPOLLOUT;
+    }
+    watch(fd, interest, EPOLL_CTL_MOD);
+  }
+
+  // Reads one chunk and answers the events it completes right away; level
+  // triggered epoll reports the session again while more input is waiting
+  static void receive(ryserve::session& session)
+  {
+    std::size_t size = session.input.size();
+    session.input.resize(size + read_size);
+    ssize_t n = ::read(session.fd, session.input.data() + size, read_size);
+    session.input.resize(size + (n > 0 ? static_cast<std::size_t>(n) : 0));
+    if(n < 0) {
+      return;  // EAGAIN, or an error that epoll reports next
+    }
+    session.process(n == 0);
+    if(n == 0) {
+      session.closing = true;
+    }
+  }
+
+  // Writes pending output; returns false if the peer is gone
+  static bool flush(ryserve::session& session)
+  {
+    while(session.pending() > 0) {
+      ssize_t n = ::send(
+        session.fd,
+        session.output.data() + session.sent,
+        session.pending(),
+        MSG_NOSIGNAL);
+      if(n < 0) {
+        return errno == EAGAIN or errno == EWOULDBLOCK;
+      }
+      session.sent += static_cast<std::size_t>(n);
+    }
+    session.output.clear();
+    session.sent = 0;
+    return true;
+  }
+
+  void close(ryserve::session& session)
+  {
+    int fd = session.fd;
+    ::epoll_ctl(poller, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    sessions.erase(fd);
+    if(not quiet) {
+      std::cerr << "Session " << fd << " closed" << std::endl;
+    }
+  }
+};
+
+int main(int argc, char** argv)
+{
+  struct arguments arguments;
+  argp_parse(&argp, argc, argv, 0, nullptr, &arguments);
+
+  struct sigaction action {};
+  action.sa_handler = stop;
+  ::sigaction(SIGINT, &action, nullptr);
+  ::sigaction(SIGTERM, &action, nullptr);
+
+  try {
+    auto daemon = server();
+    daemon.quiet = arguments.quiet;
+    daemon.listen(arguments.socket);
+    if(not arguments.quiet) {
+      std::cerr << "Listening on " << arguments.socket << std::endl;
+    }
+    daemon.run();
+  }
+  catch(const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
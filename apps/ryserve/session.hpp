@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2019-2025 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "reelay/io/binary_row.hpp"
+#include "reelay/json.hpp"
+#include "reelay/monitors.hpp"
+#include "reelay/parser/ptl_inspector.hpp"
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ryserve {
+
+/*
+ * Session protocol
+ *
+ * A client opens a session with one JSON line registering its specs:
+ *
+ *   {"specs": ["{p} since {q}", ...], "model": "discrete", "format": "json"}
+ *
+ * where `model` is `discrete` (default) or `dense` and `format` is `json`
+ * (default) for newline-delimited JSON events or `rows` for a binary row
+ * stream (.rybr header followed by rows). The daemon answers
+ *
+ *   {"ready":true,"specs":2}
+ *
+ * or `{"error":"..."}` before closing the session. From then on, the client
+ * streams events and receives a line {"time":t,"spec":i,"value":v} whenever
+ * the verdict of the spec at index i changes. Closing the write side of the
+ * connection ends the session once the last verdicts are sent.
+ */
+struct handshake {
+  std::vector<std::string> specs;
+  bool dense = false;
+  bool rows = false;
+
+  static handshake parse(const char* first, const char* last)
+  {
+    auto message = reelay::json::parse(first, last, nullptr, false);
+    if(message.is_discarded() or not message.is_object()) {
+      throw std::invalid_argument("Session must start with a JSON object");
+    }
+
+    auto result = handshake();
+    if(message.contains("spec")) {
+      result.specs.push_back(message["spec"].get<std::string>());
+    }
+    if(message.contains("specs")) {
+      for(const auto& spec : message["specs"]) {
+        result.specs.push_back(spec.get<std::string>());
+      }
+    }
+    if(result.specs.empty()) {
+      throw std::invalid_argument("No specification registered");
+    }
+
+    auto model = message.value("model", std::string("discrete"));
+    if(model != "discrete" and model != "dense") {
+      throw std::invalid_argument("Unknown time model: " + model);
+    }
+    result.dense = model == "dense";
+
+    auto format = message.value("format", std::string("json"));
+    if(format != "json" and format != "rows") {
+      throw std::invalid_argument("Unknown input format: " + format);
+    }
+    result.rows = format == "rows";
+    return result;
+  }
+};
+
+template<typename TimeT>
+void write_verdict(std::string& out, TimeT time, std::size_t index, bool value)
+{
+  if constexpr(std::is_floating_point_v<TimeT>) {
+    out += reelay::json({{"time", time}, {"spec", index}, {"value", value}})
+             .dump();
+  }
+  else {
+    out += "{\"time\":";
+    out += std::to_string(time);
+    out += ",\"spec\":";
+    out += std::to_string(index);
+    out += value ? ",\"value\":true}" : ",\"value\":false}";
+  }
+  out += '\n';
+}
+
+/*
+ * Event side of a session. Complete events are consumed from the front of
+ * the input and the verdicts they cause are appended to `out`.
+ */
+struct channel {
+  virtual ~channel() = default;
+
+  // Returns the number of bytes consumed; `last` marks the end of input
+  virtual std::size_t consume(
+    const char* data, std::size_t size, bool last, std::string& out) = 0;
+};
+
+template<typename MonitorT>
+struct monitor_list {
+  using time_t = typename MonitorT::time_type;
+  using input_t = typename MonitorT::input_type;
+
+  std::vector<MonitorT> monitors;
+
+  // Plans are cached by the parser, so the specs of earlier sessions are
+  // instantiated without parsing them again
+  explicit monitor_list(const std::vector<std::string>& specs)
+  {
+    for(const auto& spec : specs) {
+      // Fresh options per monitor as data monitors own their bindings
+      auto options = reelay::basic_options().with_data_manager();
+      auto plan = MonitorT::network_t::compile(spec, options);
+      monitors.push_back(MonitorT::from_plan(*plan, options));
+    }
+  }
+
+  void push(const input_t& event, std::string& out)
+  {
+    for(std::size_t i = 0; i < monitors.size(); i++) {
+      monitors[i].push(event, [&out, i](time_t time, bool value) {
+        write_verdict(out, time, i, value);
+      });
+    }
+  }
+};
+
+template<typename MonitorT>
+struct json_channel final : channel {
+  monitor_list<MonitorT> list;
+
+  explicit json_channel(const std::vector<std::string>& specs) : list(specs) {}
+
+  std::size_t consume(
+    const char* data, std::size_t size, bool last, std::string& out) override
+  {
+    std::size_t pos = 0;
+    while(pos < size) {
+      const char* first = data + pos;
+      const auto* eol =
+        static_cast<const char*>(std::memchr(first, '\n', size - pos));
+      if(eol == nullptr and not last) {
+        break;  // Wait for the rest of the line
+      }
+      const char* end = eol == nullptr ? data + size : eol;
+      auto event = reelay::json::parse(first, end, nullptr, false);
+      if(event.is_discarded()) {
+        bool blank = true;
+        for(const char* p = first; p != end; ++p) {
+          blank = blank and std::isspace(static_cast<unsigned char>(*p));
+        }
+        if(not blank) {
+          throw std::invalid_argument("Invalid JSON event");
+        }
+      }
+      else {
+        list.push(event, out);
+      }
+      pos = static_cast<std::size_t>(end - data) + (eol == nullptr ? 0 : 1);
+    }
+    return pos;
+  }
+};
+
+template<typename MonitorT>
+struct row_channel final : channel {
+  monitor_list<MonitorT> list;
+  std::optional<reelay::binary_schema> schema;
+
+  explicit row_channel(const std::vector<std::string>& specs) : list(specs) {}
+
+  std::size_t consume(
+    const char* data, std::size_t size, bool last, std::string& out) override
+  {
+    std::size_t pos = 0;
+    if(not schema) {
+      if(size < 16) {
+        return 0;
+      }
+      auto offset = reelay::binary_schema::load<uint32_t>(data + 12);
+      if(size < offset) {
+        return 0;
+      }
+      auto header = reelay::binary_schema::read(data, offset);
+      if(header.first.time_field == nullptr) {
+        throw std::invalid_argument("Binary row stream has no time field");
+      }
+      schema.emplace(std::move(header.first));
+      pos = header.second;
+    }
+
+    std::size_t count = (size - pos) / schema->row_size;
+    auto row = reelay::binary_row{&*schema, data + pos};
+    for(std::size_t i = 0; i < count; i++) {
+      list.push(row, out);
+      row.data += schema->row_size;
+    }
+    pos += count * schema->row_size;
+    if(last and pos < size) {
+      throw std::invalid_argument("Binary row stream ends with a partial row");
+    }
+    return pos;
+  }
+};
+
+template<typename InputT, template<typename> class ChannelT>
+std::unique_ptr<channel> make_channel(const handshake& request)
+{
+  using output_t = reelay::json;
+
+  // Data monitors cover propositional specs too, so one type fits all
+  bool has_references = false;
+  for(const auto& spec : request.specs) {
+    auto inspection = reelay::ptl_inspector().inspect(spec);
+    has_references = has_references or
+                     reelay::any_cast<bool>(inspection["has_references"]);
+  }
+
+  if(request.dense and has_references) {
+    return std::make_unique<ChannelT<
+      reelay::dense_timed_data_monitor<double, InputT, output_t>>>(
+      request.specs);
+  }
+  if(request.dense) {
+    return std::make_unique<
+      ChannelT<reelay::dense_timed_monitor<double, InputT, output_t>>>(
+      request.specs);
+  }
+  if(has_references) {
+    return std::make_unique<ChannelT<
+      reelay::discrete_timed_data_monitor<int64_t, InputT, output_t, true>>>(
+      request.specs);
+  }
+  return std::make_unique<ChannelT<
+    reelay::discrete_timed_monitor<int64_t, InputT, output_t, true>>>(
+    request.specs);
+}
+
+inline std::unique_ptr<channel> make_channel(const handshake& request)
+{
+  if(request.rows) {
+    return make_channel<reelay::binary_row, row_channel>(request);
+  }
+  return make_channel<reelay::json, json_channel>(request);
+}
+
+/*
+ * Connection state. Input accumulates until complete events are available
+ * and output is kept until the socket accepts it. A request line or event
+ * that does not complete within the input limit ends the session, so a
+ * client cannot grow the daemon without bound.
+ */
+struct session {
+  static constexpr std::size_t input_limit = 16 * 1024 * 1024;  // 16 MiB
+
+  int fd = -1;
+  std::string input;
+  std::string output;
+  std::size_t sent = 0;
+  std::unique_ptr<channel> events;
+  bool closing = false;
+
+  // Consumes buffered input; `last` marks that the peer stopped writing
+  void process(bool last)
+  {
+    try {
+      std::size_t pos = 0;
+      if(not events) {
+        const auto* eol = static_cast<const char*>(
+          std::memchr(input.data(), '\n', input.size()));
+        if(eol == nullptr) {
+          if(last and not input.empty()) {
+            throw std::invalid_argument("Incomplete session request");
+          }
+          return bound();
+        }
+        auto request = handshake::parse(input.data(), eol);
+        events = make_channel(request);
+        output += "{\"ready\":true,\"specs\":" +
+                  std::to_string(request.specs.size()) + "}\n";
+        pos = static_cast<std::size_t>(eol - input.data()) + 1;
+      }
+      pos +=
+        events->consume(input.data() + pos, input.size() - pos, last, output);
+      input.erase(0, pos);
+      bound();
+    }
+    catch(const std::exception& e) {
+      output += reelay::json({{"error", e.what()}}).dump() + "\n";
+      input.clear();
+      closing = true;
+    }
+  }
+
+  std::size_t pending() const
+  {
+    return output.size() - sent;
+  }
+
+ private:
+  void bound() const
+  {
+    if(input.size() > input_limit) {
+      throw std::length_error("Input exceeds the session limit");
+    }
+  }
+};
+
+}  // namespace ryserve
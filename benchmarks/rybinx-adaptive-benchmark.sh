@@ -0,0 +1,28 @@
+#!/usr/bin/env bash
+set -xeuo pipefail
+
+commit_hash=$(git rev-parse HEAD)
+echo "Running adaptive ordering benchmark for commit ${commit_hash}"
+
+TESTDATA_DIR="${TESTDATA_DIR:-$1}"
+
+# Each specification runs with operands in syntactic order (-x) and in the
+# order learned from the rows (-x --adaptive). Conjunctions list the rarely
+# false operand first, as written by hand.
+for name in AbsentAQ AlwaysAQ; do
+    for bound in 10 100 1000; do
+        for spec in \
+            "historically({p} and {r} and {s} and {q})" \
+            "historically((once[:${bound}]{q}) -> ({p} and {q}))"; do
+            label=$(echo "${spec}" | tr -c '[:alnum:]' '_')
+            hyperfine \
+                --warmup 3 \
+                --runs 25 \
+                --export-json "${TESTDATA_DIR}/rybinx.${commit_hash}.${name}${bound}.${label}.adaptive.results.json" \
+                --command-name "${name}${bound}-syntactic" \
+                    "rybinx -x '${spec}' ${TESTDATA_DIR}/${name}${bound}.row.bin" \
+                --command-name "${name}${bound}-adaptive" \
+                    "rybinx -x --adaptive '${spec}' ${TESTDATA_DIR}/${name}${bound}.row.bin"
+        done
+    done
+done
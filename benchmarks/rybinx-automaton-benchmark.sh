@@ -0,0 +1,27 @@
+#!/usr/bin/env bash
+set -xeuo pipefail
+
+commit_hash=$(git rev-parse HEAD)
+echo "Running table-driven discrete benchmark for commit ${commit_hash}"
+
+TESTDATA_DIR="${TESTDATA_DIR:-$1}"
+
+# Each specification runs on the network (-x) and on its compiled transition
+# table (-x --automaton) over the same rows.
+for name in AbsentAQ AlwaysAQ; do
+    for bound in 10 100 1000; do
+        if [ "${name}" = "AbsentAQ" ]; then
+            spec="historically((once[:${bound}]{q}) -> ((not{p}) since {q}))"
+        else
+            spec="historically((once[:${bound}]{q}) -> ({p} since {q}))"
+        fi
+        hyperfine \
+            --warmup 3 \
+            --runs 25 \
+            --export-json "${TESTDATA_DIR}/rybinx.${commit_hash}.${name}${bound}.automaton.results.json" \
+            --command-name "${name}${bound}-network" \
+                "rybinx -x '${spec}' ${TESTDATA_DIR}/${name}${bound}.row.bin" \
+            --command-name "${name}${bound}-automaton" \
+                "rybinx -x --automaton '${spec}' ${TESTDATA_DIR}/${name}${bound}.row.bin"
+    done
+done
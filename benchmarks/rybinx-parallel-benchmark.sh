@@ -0,0 +1,31 @@
+#!/usr/bin/env bash
+set -xeuo pipefail
+
+commit_hash=$(git rev-parse HEAD)
+echo "Running parallel discrete benchmark for commit ${commit_hash}"
+
+TESTDATA_DIR="${TESTDATA_DIR:-$1}"
+
+# A conjunction of independent response properties runs sequentially (-x)
+# and split into lanes over 2, 4 and 8 worker threads (-x --threads N).
+spec=""
+for bound in 10 20 30 40 50 60 70 80; do
+    spec="${spec:+${spec} and }(once[:${bound}]{q} -> ({p} since {q}))"
+done
+
+for name in AbsentAQ AlwaysAQ; do
+    for bound in 10 100 1000; do
+        hyperfine \
+            --warmup 3 \
+            --runs 25 \
+            --export-json "${TESTDATA_DIR}/rybinx.${commit_hash}.${name}${bound}.parallel.results.json" \
+            --command-name "${name}${bound}-sequential" \
+                "rybinx -x '${spec}' ${TESTDATA_DIR}/${name}${bound}.row.bin" \
+            --command-name "${name}${bound}-threads2" \
+                "rybinx -x --threads 2 '${spec}' ${TESTDATA_DIR}/${name}${bound}.row.bin" \
+            --command-name "${name}${bound}-threads4" \
+                "rybinx -x --threads 4 '${spec}' ${TESTDATA_DIR}/${name}${bound}.row.bin" \
+            --command-name "${name}${bound}-threads8" \
+                "rybinx -x --threads 8 '${spec}' ${TESTDATA_DIR}/${name}${bound}.row.bin"
+    done
+done
@@ -0,0 +1,24 @@
+#!/usr/bin/env bash
+set -xeuo pipefail
+
+commit_hash=$(git rev-parse HEAD)
+echo "Running regular expression benchmark for commit ${commit_hash}"
+
+TESTDATA_DIR="${TESTDATA_DIR:-$1}"
+
+# Each pattern runs as a regular expression (-x --regex) and as the
+# equivalent past temporal logic formula (-x) over the same rows.
+for bound in 10 100 1000; do
+    regex="{p} {*}[:${bound}] {q}"
+    formula="{q} and pre(once[0:${bound}]{p})"
+    for name in AbsentAQ AlwaysAQ; do
+        hyperfine \
+            --warmup 3 \
+            --runs 25 \
+            --export-json "${TESTDATA_DIR}/rybinx.${commit_hash}.${name}${bound}.regex.results.json" \
+            --command-name "${name}${bound}-formula" \
+                "rybinx -x '${formula}' ${TESTDATA_DIR}/${name}${bound}.row.bin" \
+            --command-name "${name}${bound}-regex" \
+                "rybinx -x --regex '${regex}' ${TESTDATA_DIR}/${name}${bound}.row.bin"
+    done
+done
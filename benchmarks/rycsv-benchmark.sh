@@ -0,0 +1,23 @@
+#!/usr/bin/env bash
+set -xeuo pipefail
+
+commit_hash=$(git rev-parse HEAD)
+echo "Running delimited text versus JSON lines benchmark for commit ${commit_hash}"
+
+RYCSV_FLAGS=${RYCSV_FLAGS:-"-x"}
+TESTDATA_DIR="${TESTDATA_DIR:-$1}"
+
+# Each pattern runs over the same trace as CSV (rycsv) and as JSON lines
+# (ryjson --ondemand), which both read only the referenced fields.
+hyperfine \
+    --warmup 3 \
+    --runs 25 \
+    --export-json "${TESTDATA_DIR}/rycsv.${commit_hash}.results.json" \
+    --command-name AbsentAQ1000-csv \
+        "rycsv ${RYCSV_FLAGS} 'historically((once[:1000]{q}) -> ((not{p}) since {q}))' ${TESTDATA_DIR}/AbsentAQ1000.csv" \
+    --command-name AbsentAQ1000-jsonl \
+        "ryjson ${RYCSV_FLAGS} --ondemand 'historically((once[:1000]{q}) -> ((not{p}) since {q}))' ${TESTDATA_DIR}/AbsentAQ1000.jsonl" \
+    --command-name RecurGLB1000-csv \
+        "rycsv ${RYCSV_FLAGS} 'historically(once[:1000]{p})' ${TESTDATA_DIR}/RecurGLB1000.csv" \
+    --command-name RecurGLB1000-jsonl \
+        "ryjson ${RYCSV_FLAGS} --ondemand 'historically(once[:1000]{p})' ${TESTDATA_DIR}/RecurGLB1000.jsonl"
@@ -0,0 +1,29 @@
+#!/usr/bin/env bash
+set -xeuo pipefail
+
+commit_hash=$(git rev-parse HEAD)
+echo "Running DOM versus On-Demand input benchmark for commit ${commit_hash}"
+
+RYJSON_FLAGS=${RYJSON_FLAGS:-"-x"}
+TESTDATA_DIR="${TESTDATA_DIR:-$1}"
+
+hyperfine \
+    --warmup 3 \
+    --runs 25 \
+    --export-json "${TESTDATA_DIR}/ryjson.${commit_hash}.ondemand.results.json" \
+    --command-name AbsentAQ1000-dom \
+        "ryjson ${RYJSON_FLAGS} 'historically((once[:1000]{q}) -> ((not{p}) since {q}))' ${TESTDATA_DIR}/AbsentAQ1000.jsonl" \
+    --command-name AbsentAQ1000-ondemand \
+        "ryjson ${RYJSON_FLAGS} --ondemand 'historically((once[:1000]{q}) -> ((not{p}) since {q}))' ${TESTDATA_DIR}/AbsentAQ1000.jsonl" \
+    --command-name AlwaysBQR1000-dom \
+        "ryjson ${RYJSON_FLAGS} 'historically(({r} && !{q} && once{q}) -> ({p} since[300:1000] {q}))' ${TESTDATA_DIR}/AlwaysBQR1000.jsonl" \
+    --command-name AlwaysBQR1000-ondemand \
+        "ryjson ${RYJSON_FLAGS} --ondemand 'historically(({r} && !{q} && once{q}) -> ({p} since[300:1000] {q}))' ${TESTDATA_DIR}/AlwaysBQR1000.jsonl" \
+    --command-name RecurGLB1000-dom \
+        "ryjson ${RYJSON_FLAGS} 'historically(once[:1000]{p})' ${TESTDATA_DIR}/RecurGLB1000.jsonl" \
+    --command-name RecurGLB1000-ondemand \
+        "ryjson ${RYJSON_FLAGS} --ondemand 'historically(once[:1000]{p})' ${TESTDATA_DIR}/RecurGLB1000.jsonl" \
+    --command-name RespondGLB1000-dom \
+        "ryjson ${RYJSON_FLAGS} 'historically(({s} -> once[300:1000]{p}) and not((not {s}) since[1000:] {p}))' ${TESTDATA_DIR}/RespondGLB1000.jsonl" \
+    --command-name RespondGLB1000-ondemand \
+        "ryjson ${RYJSON_FLAGS} --ondemand 'historically(({s} -> once[300:1000]{p}) and not((not {s}) since[1000:] {p}))' ${TESTDATA_DIR}/RespondGLB1000.jsonl"
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace reelay {
+
+/*
+ * Bounded lock-free single-producer single-consumer queue.
+ *
+ * Exactly one thread may push and exactly one thread may pop. The producer
+ * and the consumer indices live on separate cache lines, and each side keeps
+ * a local copy of the other's index to avoid touching the shared line on
+ * every operation. Blocking push() and pop() spin and yield for a while,
+ * then park on a condition variable until the other side makes progress, so
+ * an idle thread does not hold a core.
+ */
+template<typename T>
+struct spsc_queue {
+  using value_type = T;
+
+  static constexpr std::size_t cache_line_size = 64;
+  static constexpr int spin_limit = 256;  // yields before parking
+
+  explicit spsc_queue(std::size_t capacity) : slots(round_up(capacity))
+  {
+    mask = slots.size() - 1;
+  }
+
+  spsc_queue(const spsc_queue&) = delete;
+  spsc_queue& operator=(const spsc_queue&) = delete;
+
+  std::size_t capacity() const
+  {
+    return slots.size();
+  }
+
+  bool try_push(T& value)
+  {
+    if(not put(value)) {
+      return false;
+    }
+    wake(consumer_parked);
+    return true;
+  }
+
+  bool try_pop(T& value)
+  {
+    if(not take(value)) {
+      return false;
+    }
+    wake(producer_parked);
+    return true;
+  }
+
+  void push(T value)
+  {
+    wait(producer_parked, [this, &value]() { return put(value); });
+    wake(consumer_parked);
+  }
+
+  T pop()
+  {
+    T value;
+    wait(consumer_parked, [this, &value]() { return take(value); });
+    wake(producer_parked);
+    return value;
+  }
+
+ private:
+  std::vector<T> slots;
+  std::size_t mask = 0;
+
+  // Consumer side
+  alignas(cache_line_size) std::atomic<std::size_t> head = 0;
+  std::size_t cached_tail = 0;
+
+  // Producer side
+  alignas(cache_line_size) std::atomic<std::size_t> tail = 0;
+  std::size_t cached_head = 0;
+
+  bool put(T& value)
+  {
+    const std::size_t t = tail.load(std::memory_order_relaxed);
+    if(t - cached_head == slots.size()) {
+      cached_head = head.load(std::memory_order_acquire);
+      if(t - cached_head == slots.size()) {
+        return false;
+      }
+    }
+    slots[t & mask] = std::move(value);
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool take(T& value)
+  {
+    const std::size_t h = head.load(std::memory_order_relaxed);
+    if(h == cached_tail) {
+      cached_tail = tail.load(std::memory_order_acquire);
+      if(h == cached_tail) {
+        return false;
+      }
+    }
+    value = std::move(slots[h & mask]);
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Parking, touched only by a side that has run out of work
+  alignas(cache_line_size) std::atomic<bool> consumer_parked = false;
+  std::atomic<bool> producer_parked = false;
+  std::mutex parking;
+  std::condition_variable wakeup;
+
+  template<typename TryT>
+  void wait(std::atomic<bool>& parked, TryT&& attempt)
+  {
+    for(int i = 0; i < spin_limit; i++) {
+      if(attempt()) {
+        return;
+      }
+      std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> lock(parking);
+    parked.store(true, std::memory_order_relaxed);
+    // Either the other side sees `parked` or this side sees its update
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while(not attempt()) {
+      wakeup.wait(lock);
+    }
+    parked.store(false, std::memory_order_relaxed);
+  }
+
+  void wake(std::atomic<bool>& parked)
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(parked.load(std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> lock(parking);
+      wakeup.notify_all();
+    }
+  }
+
+  static std::size_t round_up(std::size_t n)
+  {
+    if(n == 0) {
+      throw std::invalid_argument("Queue capacity must be positive");
+    }
+    std::size_t result = 1;
+    while(result < n) {
+      result <<= 1;
+    }
+    return result;
+  }
+};
+
+}  // namespace reelay
@@ -8,10 +8,15 @@
 
 #pragma once
 
+#include <cstddef>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace reelay {
 
@@ -23,6 +28,125 @@ template<typename input_t>
 struct datafield {
 };
 
+/*
+ * Datafields may provide a non-owning `as_string_view(container, key)`
+ * whose result stays valid while the container is alive. String atomics
+ * read values through `string_field`, which prefers this accessor and falls
+ * back to the owning `as_string` otherwise.
+ */
+template<typename input_t, typename key_t, typename = void>
+struct has_string_view_field : std::false_type {
+};
+
+template<typename input_t, typename key_t>
+struct has_string_view_field<
+  input_t,
+  key_t,
+  std::void_t<decltype(datafield<input_t>::as_string_view(
+    std::declval<const input_t&>(), std::declval<const key_t&>()))>>
+    : std::true_type {
+};
+
+/*
+ * Datafields of tree-shaped inputs may provide a pointer-returning
+ * `find(container, key)` that yields nullptr for missing keys. Nested record
+ * propositions walk their path through `find_path` once per event and
+ * evaluate their children on the record in place, without copying it.
+ */
+template<typename input_t, typename = void>
+struct has_pointer_field : std::false_type {
+};
+
+template<typename input_t>
+struct has_pointer_field<
+  input_t,
+  std::void_t<decltype(datafield<input_t>::find(
+    std::declval<const input_t&>(), std::declval<const std::string&>()))>>
+    : std::true_type {
+};
+
+template<typename input_t>
+inline const input_t* find_path(
+  const input_t& container, const std::vector<std::string>& path)
+{
+  if constexpr(has_pointer_field<input_t>::value) {
+    const input_t* record = &container;
+    for(const auto& key : path) {
+      record = datafield<input_t>::find(*record, key);
+      if(record == nullptr) {
+        return nullptr;
+      }
+    }
+    return record;
+  }
+  else {
+    throw std::invalid_argument("Nested fields are not supported");
+  }
+}
+
+/*
+ * Datafields of inputs with a fixed field layout, such as binary rows and
+ * slot records, may declare a `key_type` that atoms keep instead of a plain
+ * string. A `layout_key` finds its slot by name in the first layout it reads
+ * and from then on reaches the slot by a pointer comparison, so atoms make
+ * no string comparisons per event. The binding belongs to the atom alone and
+ * layouts are never written after construction. A monitor is expected to
+ * read inputs of one layout object at a time, as a new layout at the address
+ * of a destroyed one would not be noticed.
+ */
+struct layout_key {
+  std::string name;
+
+  layout_key() = default;
+  explicit layout_key(std::string key) : name(std::move(key)) {}
+
+  operator const std::string&() const  // NOLINT(google-explicit-constructor)
+  {
+    return name;
+  }
+
+  // Slot of the key in `layout`, found by `find(name)` once per layout
+  template<typename LayoutT, typename FindT>
+  std::size_t slot(const LayoutT* layout, FindT&& find) const
+  {
+    if(bound != layout) {
+      index = find(name);
+      bound = layout;
+    }
+    return index;
+  }
+
+ private:
+  mutable const void* bound = nullptr;
+  mutable std::size_t index = 0;
+};
+
+template<typename input_t, typename = void>
+struct datafield_key {
+  using type = std::string;
+};
+
+template<typename input_t>
+struct datafield_key<
+  input_t,
+  std::void_t<typename datafield<input_t>::key_type>> {
+  using type = typename datafield<input_t>::key_type;
+};
+
+template<typename input_t>
+using datafield_key_t = typename datafield_key<input_t>::type;
+
+template<typename input_t, typename key_t>
+inline auto string_field(const input_t& container, const key_t& key)
+{
+  if constexpr(has_string_view_field<input_t, key_t>::value) {
+    return std::string_view(datafield<input_t>::as_string_view(container, key));
+  }
+  else {
+    return datafield<input_t>::as_string(container, key);
+  }
+}
+
 template<typename T>
 struct timefield<T, std::unordered_map<std::string, std::string>> {
   using input_t = std::unordered_map<std::string, std::string>;
@@ -69,6 +193,12 @@ struct datafield<std::unordered_map<std::string, std::string>> {
     return container.at(key);
   }
 
+  inline static std::string_view as_string_view(
+    const input_t& container, const std::string& key)
+  {
+    return container.at(key);
+  }
+
   inline static bool contains(const input_t& container, std::size_t index)
   {
     throw std::runtime_error("");
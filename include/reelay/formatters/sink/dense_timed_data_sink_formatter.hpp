@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "reelay/formatters/formatter.hpp"
+#include "reelay/intervals.hpp"
+#include "reelay/unordered_data.hpp"
+
+#include <utility>
+
+namespace reelay {
+
+/*
+ * Push-based counterpart of the dense timed data formatter. The sink
+ * `sink(time, value)` receives the lower bound of each piece whose
+ * satisfaction differs from the last reported one.
+ */
+template<typename TimeT>
+struct dense_timed_data_sink_formatter {
+  using time_t = TimeT;
+  using value_t = bool;
+
+  using interval_map = reelay::data_interval_map<time_t>;
+
+  data_mgr_t manager;
+
+  bool lastval = false;
+
+  dense_timed_data_sink_formatter() = default;
+
+  explicit dense_timed_data_sink_formatter(data_mgr_t mgr)
+      : manager(std::move(mgr))
+  {
+  }
+
+  template<typename SinkT>
+  inline void format(
+    const interval_map& result, time_t previous, time_t now, SinkT&& sink)
+  {
+    for(const auto& intv : result) {
+      bool value = (intv.second != manager->zero());
+      if(lastval != value or now == 0) {
+        sink(intv.first.lower(), value);
+        lastval = value;
+      }
+    }
+  }
+};
+
+}  // namespace reelay
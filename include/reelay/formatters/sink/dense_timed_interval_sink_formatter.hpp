@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "reelay/formatters/formatter.hpp"
+#include "reelay/intervals.hpp"
+#include "reelay/unordered_data.hpp"
+
+#include <optional>
+
+namespace reelay {
+
+/*
+ * Interval counterpart of the dense timed sink formatters. Instead of change
+ * points, the sink `sink(begin, end, value)` receives maximal intervals over
+ * which the verdict holds the same value, each once it is final, that is,
+ * once a later segment has a different value. The last interval is open
+ * until `close(sink)` reports it up to the current time, e.g. at the end of
+ * the input. Punctual results give intervals with `begin == end`.
+ */
+template<typename TimeT>
+struct dense_timed_interval_sink_formatter {
+  using time_t = TimeT;
+  using value_t = bool;
+
+  using interval_set = reelay::interval_set<time_t>;
+  using interval_map = reelay::data_interval_map<time_t>;
+
+  std::optional<time_t> begin;
+  value_t lastval = false;
+  time_t current = 0;
+
+  template<typename SinkT>
+  void format(
+    const interval_set& result, time_t previous, time_t now, SinkT&& sink)
+  {
+    if(now == previous) {
+      return;  // Nothing to report at time zero
+    }
+    time_t time = previous;
+    for(const auto& intv : result) {
+      if(time < intv.lower()) {
+        extend(time, false, sink);
+      }
+      extend(intv.lower(), true, sink);
+      time = intv.upper();
+    }
+    if(time < now) {
+      extend(time, false, sink);
+    }
+    current = now;
+  }
+
+  template<typename SinkT>
+  void format(
+    const interval_map& result,
+    const data_mgr_t& manager,
+    time_t previous,
+    time_t now,
+    SinkT&& sink)
+  {
+    if(now == previous) {
+      return;
+    }
+    for(const auto& intv : result) {
+      extend(intv.first.lower(), intv.second != manager->zero(), sink);
+    }
+    current = now;
+  }
+
+  template<typename SinkT>
+  void close(SinkT&& sink)
+  {
+    if(begin and *begin < current) {
+      sink(*begin, current, lastval);
+      begin = current;
+    }
+  }
+
+ private:
+  // A segment with `value` starts at `time` and ends the previous interval
+  // if the value differs
+  template<typename SinkT>
+  void extend(time_t time, value_t value, SinkT& sink)
+  {
+    if(not begin) {
+      begin = time;
+      lastval = value;
+    }
+    else if(value != lastval) {
+      sink(*begin, time, lastval);
+      begin = time;
+      lastval = value;
+    }
+  }
+};
+
+}  // namespace reelay
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "reelay/formatters/formatter.hpp"
+#include "reelay/intervals.hpp"
+
+namespace reelay {
+
+/*
+ * Push-based counterpart of the dense timed robustness formatter. The sink
+ * `sink(time, value)` receives the lower bound of each piece whose value
+ * differs from the last reported one.
+ */
+template<typename TimeT, typename ValueT>
+struct dense_timed_robustness_sink_formatter {
+  using time_t = TimeT;
+  using value_t = ValueT;
+
+  using interval_map = reelay::robustness_interval_map<time_t, value_t>;
+
+  value_t lastval = false;
+
+  template<typename SinkT>
+  inline void format(
+    const interval_map& result, time_t previous, time_t now, SinkT&& sink)
+  {
+    for(const auto& intv : result) {
+      if(lastval != intv.second or now == 0) {
+        sink(intv.first.lower(), intv.second);
+        lastval = intv.second;
+      }
+    }
+  }
+};
+
+}  // namespace reelay
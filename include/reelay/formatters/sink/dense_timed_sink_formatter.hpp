@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "reelay/formatters/formatter.hpp"
+#include "reelay/intervals.hpp"
+
+namespace reelay {
+
+/*
+ * Push-based counterpart of the dense timed formatter. Interval boundaries of
+ * the result are delivered directly to the sink as `sink(time, value)` pairs,
+ * following the same rules as the JSON formatter: the first segment always
+ * reports its initial value, later segments only report changes, and the
+ * current point (now) is never reported as it may be extended.
+ */
+template<typename TimeT>
+struct dense_timed_sink_formatter {
+  using time_t = TimeT;
+  using value_t = bool;
+
+  using interval = reelay::interval<time_t>;
+  using interval_set = reelay::interval_set<time_t>;
+
+  bool lastval = false;
+
+  template<typename SinkT>
+  void format(
+    const interval_set& result, time_t previous, time_t now, SinkT&& sink)
+  {
+    if(now == 0) {
+      return;  // Nothing to report at time zero
+    }
+    else if(previous == 0) {
+      _init_1(result, previous, now, sink);
+    }
+    else {
+      _format(result, previous, now, sink);
+    }
+  }
+
+  template<typename SinkT>
+  void _init_1(
+    const interval_set& result, time_t previous, time_t now, SinkT& sink)
+  {
+    // The variable `lastval` is meaningless for the first segment
+    if(result.empty() or result.begin()->lower() != previous) {
+      sink(previous, false);
+      lastval = false;
+    }
+    for(const auto& intv : result) {
+      sink(intv.lower(), true);
+      lastval = true;
+      if(intv.upper() != now) {
+        sink(intv.upper(), false);
+        lastval = false;
+      }
+    }
+  }
+
+  template<typename SinkT>
+  void _format(
+    const interval_set& result, time_t previous, time_t now, SinkT& sink)
+  {
+    if(result.empty()) {
+      if(lastval) {
+        sink(previous, false);
+        lastval = false;
+      }
+      return;
+    }
+    for(const auto& intv : result) {
+      if(not lastval) {
+        sink(intv.lower(), true);
+        lastval = true;
+      }
+      if(intv.upper() != now) {
+        sink(intv.upper(), false);
+        lastval = false;
+      }
+    }
+  }
+};
+
+}  // namespace reelay
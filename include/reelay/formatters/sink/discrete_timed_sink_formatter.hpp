@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "reelay/formatters/formatter.hpp"
+
+#include <limits>
+
+namespace reelay {
+
+/*
+ * Push-based counterpart of the condensing discrete timed formatter. Instead
+ * of returning an output object per event, the sink `sink(time, value)` is
+ * invoked only when the verdict changes (and once at time zero).
+ */
+template<typename TimeT, typename ValueT>
+struct discrete_timed_sink_formatter {
+  using time_t = TimeT;
+  using value_t = ValueT;
+
+  value_t lastval = std::numeric_limits<value_t>::lowest();
+
+  template<typename SinkT>
+  inline void format(value_t result, time_t now, SinkT&& sink)
+  {
+    if(result != lastval or now == 0) {
+      lastval = result;
+      sink(now, result);
+    }
+  }
+};
+
+}  // namespace reelay
@@ -0,0 +1,15 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "reelay/formatters/sink/dense_timed_data_sink_formatter.hpp"
+#include "reelay/formatters/sink/dense_timed_interval_sink_formatter.hpp"
+#include "reelay/formatters/sink/dense_timed_robustness_sink_formatter.hpp"
+#include "reelay/formatters/sink/dense_timed_sink_formatter.hpp"
+#include "reelay/formatters/sink/discrete_timed_sink_formatter.hpp"
@@ -0,0 +1,488 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "reelay/datafield.hpp"
+#include "reelay/io/scalar_kind.hpp"
+
+namespace reelay {
+
+/*
+ * Self-describing binary row format (.rybr)
+ *
+ * A row file starts with a header that lists field names, types and byte
+ * offsets, followed by fixed-width rows in native byte order:
+ *
+ *   char     magic[4]      "RYBR"
+ *   uint16   version
+ *   uint16   field_count
+ *   uint32   row_size
+ *   uint32   data_offset   (header size including field table)
+ *   field_count times:
+ *     uint8  kind          (scalar_kind)
+ *     uint8  name_length
+ *     uint16 reserved
+ *     uint32 offset        (byte offset of the field within a row)
+ *     char   name[name_length]
+ *
+ * Rows start at `data_offset`, which is a multiple of 8.
+ */
+struct binary_field {
+  std::string name;
+  scalar_kind kind;
+  uint32_t offset;
+};
+
+struct binary_schema {
+  static constexpr char magic[4] = {'R', 'Y', 'B', 'R'};
+  static constexpr uint16_t version = 1;
+
+  std::vector<binary_field> fields;
+  uint32_t row_size = 0;
+  const binary_field* time_field = nullptr;
+
+  binary_schema() = default;
+
+  explicit binary_schema(std::vector<binary_field> fieldlist)
+      : fields(std::move(fieldlist))
+  {
+    uint64_t end = 0;
+    for(const auto& field : fields) {
+      end = std::max(end, uint64_t(field.offset) + scalar_size(field.kind));
+    }
+    if(end > std::numeric_limits<uint32_t>::max()) {
+      throw std::invalid_argument("Binary row fields exceed the row size limit");
+    }
+    row_size = static_cast<uint32_t>(end);
+    time_field = find("time");
+  }
+
+  // Lays out fields back to back in the given order.
+  static binary_schema packed(
+    const std::vector<std::pair<std::string, scalar_kind>>& columns)
+  {
+    auto fieldlist = std::vector<binary_field>();
+    uint32_t offset = 0;
+    for(const auto& [name, kind] : columns) {
+      fieldlist.push_back(binary_field{name, kind, offset});
+      offset += static_cast<uint32_t>(scalar_size(kind));
+    }
+    return binary_schema(fieldlist);
+  }
+
+  binary_schema(const binary_schema& other)
+      : fields(other.fields), row_size(other.row_size)
+  {
+    time_field = find("time");
+  }
+
+  binary_schema& operator=(const binary_schema& other)
+  {
+    if(this != &other) {
+      fields = other.fields;
+      row_size = other.row_size;
+      time_field = find("time");
+    }
+    return *this;
+  }
+
+  // Index of the field called `name`, or the number of fields if none
+  std::size_t index_of(const std::string& name) const
+  {
+    for(std::size_t i = 0; i < fields.size(); i++) {
+      if(fields[i].name == name) {
+        return i;
+      }
+    }
+    return fields.size();
+  }
+
+  const binary_field* find(const std::string& name) const
+  {
+    std::size_t i = index_of(name);
+    return i < fields.size() ? &fields[i] : nullptr;
+  }
+
+  // Field of an atom key, which is bound to this schema on first use
+  const binary_field* find(const layout_key& key) const
+  {
+    std::size_t i = key.slot(
+      this, [this](const std::string& name) { return index_of(name); });
+    return i < fields.size() ? &fields[i] : nullptr;
+  }
+
+  // Parses a header and returns the schema with the offset of the first row.
+  static std::pair<binary_schema, std::size_t> read(
+    const char* data, std::size_t size)
+  {
+    auto need = [&](std::size_t pos, std::size_t n) {
+      if(pos + n > size) {
+        throw std::runtime_error("Corrupted binary row header");
+      }
+    };
+
+    need(0, 16);
+    if(std::memcmp(data, magic, sizeof(magic)) != 0) {
+      throw std::runtime_error("Not a binary row file");
+    }
+    uint16_t file_version = load<uint16_t>(data + 4);
+    if(file_version != version) {
+      throw std::runtime_error(
+        "Unsupported binary row version: " + std::to_string(file_version));
+    }
+    auto field_count = load<uint16_t>(data + 6);
+    auto file_row_size = load<uint32_t>(data + 8);
+    auto data_offset = load<uint32_t>(data + 12);
+    if(file_row_size == 0) {
+      throw std::runtime_error("Corrupted binary row header");
+    }
+
+    auto fieldlist = std::vector<binary_field>();
+    std::size_t pos = 16;
+    for(uint16_t i = 0; i < field_count; i++) {
+      need(pos, 8);
+      auto kind = static_cast<scalar_kind>(load<uint8_t>(data + pos));
+      auto name_length = load<uint8_t>(data + pos + 1);
+      auto offset = load<uint32_t>(data + pos + 4);
+      if(scalar_size(kind) == 0) {
+        throw std::runtime_error("Unknown field type in binary row header");
+      }
+      if(scalar_size(kind) > file_row_size
+         or offset > file_row_size - scalar_size(kind)) {
+        throw std::runtime_error("Corrupted binary row header");
+      }
+      need(pos + 8, name_length);
+      fieldlist.push_back(
+        binary_field{std::string(data + pos + 8, name_length), kind, offset});
+      pos += 8 + name_length;
+    }
+
+    auto schema = binary_schema(fieldlist);
+    if(data_offset < pos or data_offset > size) {
+      throw std::runtime_error("Corrupted binary row header");
+    }
+    schema.row_size = file_row_size;
+    return {schema, data_offset};
+  }
+
+  void write(std::ostream& os) const
+  {
+    auto buffer = std::vector<char>(16);
+    std::memcpy(buffer.data(), magic, sizeof(magic));
+    store<uint16_t>(buffer.data() + 4, version);
+    store<uint16_t>(buffer.data() + 6, static_cast<uint16_t>(fields.size()));
+    store<uint32_t>(buffer.data() + 8, row_size);
+
+    for(const auto& field : fields) {
+      if(field.name.size() > 255) {
+        throw std::invalid_argument("Field name too long: " + field.name);
+      }
+      std::size_t pos = buffer.size();
+      buffer.resize(pos + 8 + field.name.size());
+      store<uint8_t>(buffer.data() + pos, static_cast<uint8_t>(field.kind));
+      store<uint8_t>(
+        buffer.data() + pos + 1, static_cast<uint8_t>(field.name.size()));
+      store<uint32_t>(buffer.data() + pos + 4, field.offset);
+      std::memcpy(buffer.data() + pos + 8, field.name.data(), field.name.size());
+    }
+    buffer.resize((buffer.size() + 7) / 8 * 8);
+    store<uint32_t>(buffer.data() + 12, static_cast<uint32_t>(buffer.size()));
+
+    os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  }
+
+  template<typename T>
+  static T load(const char* ptr)
+  {
+    T value;
+    std::memcpy(&value, ptr, sizeof(T));
+    return value;
+  }
+
+  template<typename T>
+  static void store(char* ptr, T value)
+  {
+    std::memcpy(ptr, &value, sizeof(T));
+  }
+};
+
+/*
+ * Lightweight view of a single row; this is the input type of monitors.
+ */
+struct binary_row {
+  const binary_schema* schema = nullptr;
+  const char* data = nullptr;
+
+  template<typename T>
+  T get(const binary_field& field) const
+  {
+    const char* ptr = data + field.offset;
+    switch(field.kind) {
+      case scalar_kind::boolean:
+        return static_cast<T>(binary_schema::load<bool>(ptr));
+      case scalar_kind::int32:
+        return static_cast<T>(binary_schema::load<int32_t>(ptr));
+      case scalar_kind::int64:
+        return static_cast<T>(binary_schema::load<int64_t>(ptr));
+      case scalar_kind::float64:
+        return static_cast<T>(binary_schema::load<double>(ptr));
+    }
+    throw std::runtime_error("Unknown field type: " + field.name);
+  }
+
+  template<typename T, typename KeyT>
+  T get(const KeyT& key) const
+  {
+    const binary_field* field = schema->find(key);
+    if(field == nullptr) {
+      throw std::out_of_range("Key not found: " + std::string(key));
+    }
+    return get<T>(*field);
+  }
+};
+
+/*
+ * Iterates rows of a contiguous row buffer; compatible with batch push().
+ */
+struct binary_row_iterator {
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = binary_row;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const binary_row*;
+  using reference = const binary_row&;
+
+  binary_row row;
+
+  binary_row_iterator() = default;
+  binary_row_iterator(const binary_schema* schema, const char* data)
+      : row{schema, data}
+  {
+  }
+
+  reference operator*() const
+  {
+    return row;
+  }
+
+  pointer operator->() const
+  {
+    return &row;
+  }
+
+  binary_row_iterator& operator++()
+  {
+    row.data += row.schema->row_size;
+    return *this;
+  }
+
+  binary_row_iterator operator++(int)
+  {
+    auto tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  binary_row_iterator operator+(std::size_t n) const
+  {
+    return binary_row_iterator(row.schema, row.data + n * row.schema->row_size);
+  }
+
+  bool operator==(const binary_row_iterator& other) const
+  {
+    return row.data == other.row.data;
+  }
+
+  bool operator!=(const binary_row_iterator& other) const
+  {
+    return row.data != other.row.data;
+  }
+};
+
+/*
+ * Buffered writer for binary row files.
+ */
+struct binary_row_writer {
+  static constexpr std::size_t buffer_size = 64 * 1024;  // 64 KiB
+
+  binary_row_writer(std::ostream& os, binary_schema rowschema)
+      : output(os), schema(std::move(rowschema)), row(schema.row_size)
+  {
+    schema.write(output);
+    buffer.reserve(buffer_size);
+  }
+
+  binary_row_writer(const binary_row_writer&) = delete;
+  binary_row_writer& operator=(const binary_row_writer&) = delete;
+
+  ~binary_row_writer()
+  {
+    flush();
+  }
+
+  // Sets a field of the pending row; missing fields keep zero values.
+  template<typename T>
+  void set(const std::string& key, T value)
+  {
+    const binary_field* field = schema.find(key);
+    if(field == nullptr) {
+      throw std::out_of_range("Key not found: " + key);
+    }
+    char* ptr = row.data() + field->offset;
+    switch(field->kind) {
+      case scalar_kind::boolean:
+        return binary_schema::store<bool>(ptr, static_cast<bool>(value));
+      case scalar_kind::int32:
+        return binary_schema::store<int32_t>(ptr, static_cast<int32_t>(value));
+      case scalar_kind::int64:
+        return binary_schema::store<int64_t>(ptr, static_cast<int64_t>(value));
+      case scalar_kind::float64:
+        return binary_schema::store<double>(ptr, static_cast<double>(value));
+    }
+  }
+
+  // Appends the pending row and starts a new one.
+  void commit()
+  {
+    if(buffer.size() + row.size() > buffer_size) {
+      flush();
+    }
+    buffer.insert(buffer.end(), row.begin(), row.end());
+    std::fill(row.begin(), row.end(), 0);
+  }
+
+  void flush()
+  {
+    if(not buffer.empty()) {
+      output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      buffer.clear();
+    }
+    output.flush();
+  }
+
+ private:
+  std::ostream& output;
+  const binary_schema schema;
+  std::vector<char> row;
+  std::vector<char> buffer;
+};
+
+template<typename T>
+struct timefield<T, binary_row> {
+  using input_t = binary_row;
+  inline static T get_time(const input_t& row)
+  {
+    if(row.schema->time_field == nullptr) {
+      throw std::out_of_range("Key not found: time");
+    }
+    return row.get<T>(*row.schema->time_field);
+  }
+};
+
+template<>
+struct datafield<binary_row> {
+  using input_t = binary_row;
+  using key_type = layout_key;
+
+  inline static input_t at(const input_t& /*container*/, const std::string& key)
+  {
+    throw std::invalid_argument("Nested fields are not supported: " + key);
+  }
+
+  inline static input_t at(const input_t& /*container*/, std::size_t /*index*/)
+  {
+    throw std::invalid_argument("Nested fields are not supported");
+  }
+
+  inline static bool contains(const input_t& row, const std::string& key)
+  {
+    return row.schema->find(key) != nullptr;
+  }
+
+  inline static bool as_bool(const input_t& row, const std::string& key)
+  {
+    return row.get<bool>(key);
+  }
+
+  inline static int64_t as_integer(const input_t& row, const std::string& key)
+  {
+    return row.get<int64_t>(key);
+  }
+
+  inline static double as_floating(const input_t& row, const std::string& key)
+  {
+    return row.get<double>(key);
+  }
+
+  // Atoms read through their bound keys
+  inline static bool contains(const input_t& row, const key_type& key)
+  {
+    return row.schema->find(key) != nullptr;
+  }
+
+  inline static bool as_bool(const input_t& row, const key_type& key)
+  {
+    return row.get<bool>(key);
+  }
+
+  inline static int64_t as_integer(const input_t& row, const key_type& key)
+  {
+    return row.get<int64_t>(key);
+  }
+
+  inline static double as_floating(const input_t& row, const key_type& key)
+  {
+    return row.get<double>(key);
+  }
+
+  inline static std::string as_string(
+    const input_t& /*container*/, const std::string& key)
+  {
+    throw std::invalid_argument("String fields are not supported: " + key);
+  }
+
+  inline static bool contains(const input_t& row, std::size_t index)
+  {
+    return index < row.schema->fields.size();
+  }
+
+  inline static bool as_bool(const input_t& row, std::size_t index)
+  {
+    return row.get<bool>(row.schema->fields.at(index));
+  }
+
+  inline static int64_t as_integer(const input_t& row, std::size_t index)
+  {
+    return row.get<int64_t>(row.schema->fields.at(index));
+  }
+
+  inline static double as_floating(const input_t& row, std::size_t index)
+  {
+    return row.get<double>(row.schema->fields.at(index));
+  }
+
+  inline static std::string as_string(
+    const input_t& /*container*/, std::size_t /*index*/)
+  {
+    throw std::invalid_argument("String fields are not supported");
+  }
+};
+
+}  // namespace reelay
@@ -0,0 +1,521 @@
+/*
+ * Copyright (c) 2019-2025 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "reelay/datafield.hpp"
+#include "reelay/io/mapped_file.hpp"
+
+namespace reelay {
+
+/*
+ * Delimited text input (CSV, TSV)
+ *
+ * The first line of the file names the columns. Only the columns referenced
+ * by the specification are bound to slots, once when the header is read, and
+ * rows are split without copying: cells of unbound columns are skipped and
+ * the rest of a row is skipped once all bound cells are read. Cells are typed
+ * as they are read, numbers with std::from_chars, `true` and `false` as
+ * booleans, and anything else as a string. Empty cells are missing.
+ *
+ * Quoted cells are not supported; delimiters and newlines cannot appear in
+ * cell text. Lines may end with CRLF.
+ */
+namespace csv {
+
+// Returns the first delimiter or newline in [first, last), or last
+inline const char* scan(const char* first, const char* last, char delimiter)
+{
+#if defined(__SSE2__)
+  const __m128i delimiters = _mm_set1_epi8(delimiter);
+  const __m128i newlines = _mm_set1_epi8('\n');
+  for(; last - first >= 16; first += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    int mask = _mm_movemask_epi8(_mm_or_si128(
+      _mm_cmpeq_epi8(chunk, delimiters), _mm_cmpeq_epi8(chunk, newlines)));
+    if(mask != 0) {
+      return first + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+  }
+#endif
+  for(; first != last; ++first) {
+    if(*first == delimiter or *first == '\n') {
+      return first;
+    }
+  }
+  return last;
+}
+
+// Returns the end of the line starting at `first`, without the newline
+inline const char* line_end(const char* first, const char* last)
+{
+  const void* pos =
+    std::memchr(first, '\n', static_cast<std::size_t>(last - first));
+  return pos == nullptr ? last : static_cast<const char*>(pos);
+}
+
+// Trims blanks and carriage returns around a cell
+inline std::string_view trim(const char* first, const char* last)
+{
+  while(first != last and (*first == ' ' or *first == '\t')) {
+    ++first;
+  }
+  while(last != first and
+        (last[-1] == ' ' or last[-1] == '\t' or last[-1] == '\r')) {
+    --last;
+  }
+  return std::string_view(first, static_cast<std::size_t>(last - first));
+}
+
+}  // namespace csv
+
+/*
+ * Column binding of a delimited file. For timed tables, which dense monitors
+ * read, the time column is slot zero, followed by the referenced keys in
+ * order. Keys missing from the header are rejected here rather than row by
+ * row.
+ */
+struct csv_table {
+  static constexpr std::size_t unbound = std::numeric_limits<std::size_t>::max();
+
+  char delimiter = ',';
+  bool timed = true;
+  std::vector<std::string> columns;
+  std::vector<std::string> keys;
+  std::vector<std::size_t> slot_of;  // per column, slot index or unbound
+  std::size_t last_bound = 0;        // last column to read in a row
+
+  csv_table(
+    std::string_view header,
+    const std::vector<std::string>& keylist,
+    char delim = ',',
+    bool with_time = true)
+      : delimiter(delim), timed(with_time)
+  {
+    const char* first = header.data();
+    const char* last = first + header.size();
+    if(header.size() >= 3 and std::memcmp(first, "\xEF\xBB\xBF", 3) == 0) {
+      first += 3;  // UTF-8 byte order mark
+    }
+    while(true) {
+      const char* pos = csv::scan(first, last, delimiter);
+      columns.emplace_back(csv::trim(first, pos));
+      if(pos == last or *pos == '\n') {
+        break;
+      }
+      first = pos + 1;
+    }
+
+    // Repeated keys share a slot, as a column maps to one slot only
+    if(timed) {
+      keys.emplace_back("time");
+    }
+    for(const auto& key : keylist) {
+      if(resolve(key) == unbound) {
+        keys.push_back(key);
+      }
+    }
+
+    slot_of.assign(columns.size(), unbound);
+    for(std::size_t i = 0; i < keys.size(); i++) {
+      std::size_t column = find(keys[i]);
+      if(column == unbound) {
+        throw std::out_of_range("Column not found: " + keys[i]);
+      }
+      slot_of[column] = i;
+      last_bound = std::max(last_bound, column);
+    }
+  }
+
+  std::size_t size() const
+  {
+    return keys.size();
+  }
+
+  // Column index of `name` in the header, or unbound
+  std::size_t find(const std::string& name) const
+  {
+    for(std::size_t i = 0; i < columns.size(); i++) {
+      if(columns[i] == name) {
+        return i;
+      }
+    }
+    return unbound;
+  }
+
+  // Slot of a bound key, or unbound
+  std::size_t resolve(std::string_view key) const
+  {
+    for(std::size_t i = 0; i < keys.size(); i++) {
+      if(keys[i] == key) {
+        return i;
+      }
+    }
+    return unbound;
+  }
+
+  // Slot of an atom key, which is bound to this table on first use
+  std::size_t resolve(const layout_key& key) const
+  {
+    return key.slot(
+      this, [this](const std::string& name) { return resolve(name); });
+  }
+
+  template<typename KeyT>
+  std::size_t slot(const KeyT& key) const
+  {
+    std::size_t i = resolve(key);
+    if(i == unbound) {
+      throw std::out_of_range("Unbound column: " + std::string(key));
+    }
+    return i;
+  }
+};
+
+enum class csv_kind : uint8_t { missing, boolean, number, string };
+
+struct csv_slot {
+  csv_kind kind = csv_kind::missing;
+  bool boolean = false;
+  bool integral = false;
+  int64_t integer = 0;
+  double floating = 0.0;
+  std::string_view string;
+
+  void assign(std::string_view text)
+  {
+    const char* first = text.data();
+    const char* last = first + text.size();
+    if(first == last) {
+      kind = csv_kind::missing;
+      return;
+    }
+
+    auto [pos, ec] = std::from_chars(first, last, integer);
+    if(ec == std::errc() and pos == last) {
+      kind = csv_kind::number;
+      integral = true;
+      floating = static_cast<double>(integer);
+      return;
+    }
+    auto [fpos, fec] = std::from_chars(first, last, floating);
+    if(fec == std::errc() and fpos == last) {
+      kind = csv_kind::number;
+      integral = false;
+      return;
+    }
+
+    if(text == "true") {
+      kind = csv_kind::boolean;
+      boolean = true;
+    }
+    else if(text == "false") {
+      kind = csv_kind::boolean;
+      boolean = false;
+    }
+    else {
+      kind = csv_kind::string;
+      string = text;
+    }
+  }
+
+  // Non-integral numbers are truncated, which needs them in range
+  int64_t as_integer() const
+  {
+    if(integral) {
+      return integer;
+    }
+    if(not(floating >= -0x1p63 and floating < 0x1p63)) {
+      throw std::out_of_range("Number out of integer range");
+    }
+    return static_cast<int64_t>(floating);
+  }
+};
+
+/*
+ * Monitor input holding the bound cells of the current row. String slots
+ * refer to the input buffer and are valid as long as it is.
+ */
+struct csv_record {
+  const csv_table* table = nullptr;
+  std::vector<csv_slot> slots;
+
+  csv_record() = default;
+  explicit csv_record(const csv_table& t) : table(&t), slots(t.size()) {}
+
+  // Reads the row in [first, last), which excludes the newline
+  void parse(const char* first, const char* last)
+  {
+    for(auto& slot : slots) {
+      slot.kind = csv_kind::missing;
+    }
+
+    const std::size_t* slot_of = table->slot_of.data();
+    for(std::size_t column = 0; column <= table->last_bound; column++) {
+      const char* pos = csv::scan(first, last, table->delimiter);
+      if(slot_of[column] != csv_table::unbound) {
+        slots[slot_of[column]].assign(csv::trim(first, pos));
+      }
+      if(pos == last) {
+        break;  // Short rows leave trailing slots missing
+      }
+      first = pos + 1;
+    }
+  }
+
+  template<typename KeyT>
+  const csv_slot& at(const KeyT& key) const
+  {
+    return slots[table->slot(key)];
+  }
+
+  static const csv_slot& expect(const csv_slot& slot, csv_kind kind)
+  {
+    if(slot.kind != kind) {
+      throw std::invalid_argument("Unexpected cell type");
+    }
+    return slot;
+  }
+};
+
+/*
+ * Calls `fn` with the record of every non-empty row in [first, last).
+ */
+template<typename FunctionT>
+void for_each_row(
+  const char* first, const char* last, csv_record& record, FunctionT&& fn)
+{
+  while(first < last) {
+    const char* eol = csv::line_end(first, last);
+    if(csv::trim(first, eol).size() > 0) {
+      record.parse(first, eol);
+      fn(record);
+    }
+    first = eol + 1;
+  }
+}
+
+/*
+ * Delimited file mapped into memory. The header is available on opening so
+ * that columns can be bound before the rows are read.
+ */
+struct csv_reader {
+  static constexpr std::size_t release_size = 64 * 1024 * 1024;  // 64 MiB
+
+  explicit csv_reader(const std::string& filename) : file(filename)
+  {
+    file.advise_sequential();
+    const char* first = file.data();
+    const char* last = first + file.size();
+    header_end = first == nullptr ? nullptr : csv::line_end(first, last);
+  }
+
+  std::string_view header() const
+  {
+    if(header_end == nullptr) {
+      return std::string_view();
+    }
+    return std::string_view(
+      file.data(), static_cast<std::size_t>(header_end - file.data()));
+  }
+
+  // Calls `fn` with the record of every row and drops pages behind
+  template<typename FunctionT>
+  void for_each(const csv_table& table, FunctionT&& fn) const
+  {
+    if(header_end == nullptr) {
+      return;
+    }
+    const char* last = file.data() + file.size();
+    const char* first = header_end + 1;
+    auto record = csv_record(table);
+    while(first < last) {
+      std::size_t length = static_cast<std::size_t>(last - first);
+      const char* chunk = first + std::min(release_size, length);
+      chunk = chunk == last ? last : csv::line_end(chunk, last);
+      for_each_row(first, chunk, record, fn);
+      file.release(
+        static_cast<std::size_t>(first - file.data()),
+        static_cast<std::size_t>(chunk - first));
+      first = chunk + 1;
+    }
+  }
+
+ private:
+  mapped_file file;
+  const char* header_end = nullptr;
+};
+
+template<typename T>
+struct timefield<T, csv_record> {
+  using input_t = csv_record;
+  inline static T get_time(const input_t& container)
+  {
+    if(not container.table->timed) {
+      throw std::out_of_range("Unbound column: time");
+    }
+    const auto& slot = input_t::expect(container.slots[0], csv_kind::number);
+    if constexpr(std::is_integral_v<T>) {
+      return static_cast<T>(slot.as_integer());
+    }
+    else {
+      return static_cast<T>(slot.floating);
+    }
+  }
+};
+
+template<>
+struct datafield<csv_record> {
+  using input_t = csv_record;
+  using key_type = layout_key;
+
+  inline static input_t at(const input_t& /*container*/, const std::string& key)
+  {
+    throw std::invalid_argument("Nested fields are not supported: " + key);
+  }
+
+  inline static input_t at(const input_t& /*container*/, std::size_t /*index*/)
+  {
+    throw std::invalid_argument("Nested fields are not supported");
+  }
+
+  inline static bool contains(const input_t& container, const std::string& key)
+  {
+    return container.at(key).kind != csv_kind::missing;
+  }
+
+  inline static bool contains(const input_t& container, std::string_view key)
+  {
+    std::size_t slot = container.table->resolve(key);
+    return slot != csv_table::unbound and
+           container.slots[slot].kind != csv_kind::missing;
+  }
+
+  // Integer cells are booleans too as 0 and 1 are common in delimited files
+  inline static bool as_bool(const input_t& container, const std::string& key)
+  {
+    const auto& slot = container.at(key);
+    if(slot.kind == csv_kind::number and slot.integral) {
+      return slot.integer != 0;
+    }
+    return input_t::expect(slot, csv_kind::boolean).boolean;
+  }
+
+  inline static int64_t as_integer(
+    const input_t& container, const std::string& key)
+  {
+    return input_t::expect(container.at(key), csv_kind::number).as_integer();
+  }
+
+  inline static double as_floating(
+    const input_t& container, const std::string& key)
+  {
+    return input_t::expect(container.at(key), csv_kind::number).floating;
+  }
+
+  inline static std::string as_string(
+    const input_t& container, const std::string& key)
+  {
+    return std::string(
+      input_t::expect(container.at(key), csv_kind::string).string);
+  }
+
+  inline static std::string_view as_string_view(
+    const input_t& container, const std::string& key)
+  {
+    return input_t::expect(container.at(key), csv_kind::string).string;
+  }
+
+  // Atoms read through their bound keys
+  inline static bool contains(const input_t& container, const key_type& key)
+  {
+    return container.at(key).kind != csv_kind::missing;
+  }
+
+  inline static bool as_bool(const input_t& container, const key_type& key)
+  {
+    const auto& slot = container.at(key);
+    if(slot.kind == csv_kind::number and slot.integral) {
+      return slot.integer != 0;
+    }
+    return input_t::expect(slot, csv_kind::boolean).boolean;
+  }
+
+  inline static int64_t as_integer(
+    const input_t& container, const key_type& key)
+  {
+    return input_t::expect(container.at(key), csv_kind::number).as_integer();
+  }
+
+  inline static double as_floating(
+    const input_t& container, const key_type& key)
+  {
+    return input_t::expect(container.at(key), csv_kind::number).floating;
+  }
+
+  inline static std::string as_string(
+    const input_t& container, const key_type& key)
+  {
+    return std::string(
+      input_t::expect(container.at(key), csv_kind::string).string);
+  }
+
+  inline static std::string_view as_string_view(
+    const input_t& container, const key_type& key)
+  {
+    return input_t::expect(container.at(key), csv_kind::string).string;
+  }
+
+  inline static bool contains(
+    const input_t& /*container*/, std::size_t /*index*/)
+  {
+    throw std::invalid_argument("Array records are not supported");
+  }
+
+  inline static bool as_bool(const input_t& /*container*/, std::size_t /*index*/)
+  {
+    throw std::invalid_argument("Array records are not supported");
+  }
+
+  inline static int64_t as_integer(
+    const input_t& /*container*/, std::size_t /*index*/)
+  {
+    throw std::invalid_argument("Array records are not supported");
+  }
+
+  inline static double as_floating(
+    const input_t& /*container*/, std::size_t /*index*/)
+  {
+    throw std::invalid_argument("Array records are not supported");
+  }
+
+  inline static std::string as_string(
+    const input_t& /*container*/, std::size_t /*index*/)
+  {
+    throw std::invalid_argument("Array records are not supported");
+  }
+};
+
+}  // namespace reelay
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace reelay {
+
+/*
+ * Non-owning view over a contiguous range of fixed-width records.
+ */
+template<typename RecordT>
+struct record_span {
+  using value_type = RecordT;
+
+  const RecordT* first = nullptr;
+  const RecordT* last = nullptr;
+
+  const RecordT* begin() const
+  {
+    return first;
+  }
+
+  const RecordT* end() const
+  {
+    return last;
+  }
+
+  std::size_t size() const
+  {
+    return static_cast<std::size_t>(last - first);
+  }
+
+  bool empty() const
+  {
+    return first == last;
+  }
+
+  record_span subspan(std::size_t offset, std::size_t count) const
+  {
+    offset = std::min(offset, size());
+    count = std::min(count, size() - offset);
+    return record_span{first + offset, first + offset + count};
+  }
+};
+
+/*
+ * Read-only memory mapping of a whole file (POSIX only).
+ *
+ * The mapping is owned by the object and released on destruction. Empty files
+ * are valid and yield a null data pointer with zero size.
+ */
+struct mapped_file {
+  mapped_file() = default;
+
+  explicit mapped_file(const std::string& filename)
+  {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if(fd < 0) {
+      throw std::runtime_error(
+        "Error opening file: " + filename + " (" + std::strerror(errno) + ")");
+    }
+
+    struct stat st {};
+    if(::fstat(fd, &st) < 0) {
+      ::close(fd);
+      throw std::runtime_error("Error reading file size: " + filename);
+    }
+    length = static_cast<std::size_t>(st.st_size);
+
+    if(length > 0) {
+      void* addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(addr == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("Error mapping file: " + filename);
+      }
+      address = static_cast<const char*>(addr);
+    }
+    ::close(fd);
+  }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  mapped_file(mapped_file&& other) noexcept
+      : address(std::exchange(other.address, nullptr)),
+        length(std::exchange(other.length, 0))
+  {
+  }
+
+  mapped_file& operator=(mapped_file&& other) noexcept
+  {
+    if(this != &other) {
+      unmap();
+      address = std::exchange(other.address, nullptr);
+      length = std::exchange(other.length, 0);
+    }
+    return *this;
+  }
+
+  ~mapped_file()
+  {
+    unmap();
+  }
+
+  const char* data() const
+  {
+    return address;
+  }
+
+  std::size_t size() const
+  {
+    return length;
+  }
+
+  /*
+   * Hints the kernel that the mapping will be read once from front to back.
+   * This enables aggressive readahead and, where supported, transparent huge
+   * pages for the page cache. Hints are best effort and never fail.
+   */
+  void advise_sequential() const
+  {
+    if(address == nullptr) {
+      return;
+    }
+    void* addr = const_cast<char*>(address);
+    ::madvise(addr, length, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    ::madvise(addr, length, MADV_HUGEPAGE);
+#endif
+  }
+
+  /*
+   * Drops the pages fully contained in [offset, offset + count) from the
+   * mapping so that resident memory stays bounded while streaming large
+   * files. The data remains readable and is paged in again on access.
+   */
+  void release(std::size_t offset, std::size_t count) const
+  {
+    static const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+
+    std::size_t first = (offset + page - 1) / page * page;
+    std::size_t last = std::min(offset + count, length) / page * page;
+    if(address == nullptr or first >= last) {
+      return;
+    }
+    ::madvise(const_cast<char*>(address) + first, last - first, MADV_DONTNEED);
+  }
+
+  /*
+   * Returns the records stored from `offset` to the end of the file. Any
+   * trailing partial record is excluded.
+   */
+  template<typename RecordT>
+  record_span<RecordT> records(std::size_t offset = 0) const
+  {
+    static_assert(std::is_trivially_copyable_v<RecordT>);
+
+    if(offset >= length) {
+      return record_span<RecordT>{};
+    }
+    const char* ptr = address + offset;
+    if(reinterpret_cast<std::uintptr_t>(ptr) % alignof(RecordT) != 0) {
+      throw std::invalid_argument("Misaligned records in mapped file");
+    }
+    std::size_t count = (length - offset) / sizeof(RecordT);
+    const auto* first = reinterpret_cast<const RecordT*>(ptr);
+    return record_span<RecordT>{first, first + count};
+  }
+
+ private:
+  const char* address = nullptr;
+  std::size_t length = 0;
+
+  void unmap()
+  {
+    if(address != nullptr) {
+      ::munmap(const_cast<char*>(address), length);
+      address = nullptr;
+      length = 0;
+    }
+  }
+};
+
+}  // namespace reelay
@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "reelay/parser/ptl_plan.hpp"
+
+namespace reelay {
+
+/*
+ * Binary plan file format (.rypl)
+ *
+ * A plan file stores the construction steps recorded by ptl_parser so that
+ * networks can be instantiated without parsing the specification. The file
+ * starts with an 8-byte header (magic and version) followed by the plan in
+ * native byte order:
+ *
+ *   string setting, string source
+ *   u32 step count, then per step:
+ *     string name, u8 flags, u32 argument count, u32 arguments...,
+ *     u32 keyword count, then per keyword: string name, u8 kind, payload
+ *   u32 state count, u32 states..., u32 root
+ *
+ * Strings are a u32 length and bytes. Keyword payloads are a string (text),
+ * an i64 (index), an f64 (bound) or a u32 count and strings (names). Readers
+ * reject other versions, since steps name setting factories directly.
+ */
+#pragma pack(push, 1)
+struct plan_header {
+  char magic[4];
+  uint16_t version;
+  uint16_t reserved;
+};
+#pragma pack(pop)
+static_assert(sizeof(plan_header) == 8);
+
+static constexpr char plan_magic[4] = {'R', 'Y', 'P', 'L'};
+static constexpr uint16_t plan_version = 2;
+
+struct plan_writer {
+  explicit plan_writer(std::ostream& os) : output(os) {}
+
+  void write(const ptl_plan& plan)
+  {
+    plan_header header{};
+    std::memcpy(header.magic, plan_magic, sizeof(plan_magic));
+    header.version = plan_version;
+    put(&header, sizeof(header));
+
+    put_string(plan.setting);
+    put_string(plan.source);
+
+    put_u32(plan.steps.size());
+    for(const auto& step : plan.steps) {
+      put_string(step.name);
+      uint8_t flags = (step.is_state ? 1 : 0) | (step.nested ? 2 : 0) |
+                      (step.has_args ? 4 : 0);
+      put(&flags, sizeof(flags));
+      put_u32(step.args.size());
+      for(auto arg : step.args) {
+        put_u32(arg);
+      }
+      put_u32(step.kw.size());
+      for(const auto& arg : step.kw) {
+        put_argument(arg);
+      }
+    }
+
+    put_u32(plan.states.size());
+    for(auto state : plan.states) {
+      put_u32(state);
+    }
+    put_u32(plan.root);
+
+    if(not output) {
+      throw std::runtime_error("Error writing plan");
+    }
+  }
+
+ private:
+  std::ostream& output;
+
+  void put(const void* ptr, std::size_t n)
+  {
+    output.write(static_cast<const char*>(ptr), std::streamsize(n));
+  }
+
+  void put_u32(std::size_t value)
+  {
+    auto word = uint32_t(value);
+    put(&word, sizeof(word));
+  }
+
+  void put_string(const std::string& str)
+  {
+    put_u32(str.size());
+    put(str.data(), str.size());
+  }
+
+  void put_argument(const ptl_plan::argument& arg)
+  {
+    using kind = ptl_plan::argument::kind;
+    put_string(arg.name);
+    put(&arg.type, sizeof(arg.type));
+    switch(arg.type) {
+      case kind::text:
+        put_string(arg.text);
+        break;
+      case kind::index:
+        put(&arg.index, sizeof(arg.index));
+        break;
+      case kind::bound:
+        put(&arg.bound, sizeof(arg.bound));
+        break;
+      case kind::names:
+        put_u32(arg.names.size());
+        for(const auto& name : arg.names) {
+          put_string(name);
+        }
+        break;
+    }
+  }
+};
+
+/*
+ * Reader for plan files. Step references are validated so that a corrupted
+ * file fails here rather than during instantiation.
+ */
+struct plan_reader {
+  explicit plan_reader(std::istream& is) : input(is) {}
+
+  ptl_plan read()
+  {
+    plan_header header{};
+    get(&header, sizeof(header));
+    if(std::memcmp(header.magic, plan_magic, sizeof(plan_magic)) != 0) {
+      throw std::runtime_error("Not a plan file");
+    }
+    if(header.version != plan_version) {
+      throw std::runtime_error(
+        "Unsupported plan file version: " + std::to_string(header.version));
+    }
+
+    ptl_plan plan;
+    plan.setting = get_string();
+    plan.source = get_string();
+
+    std::size_t count = get_u32();
+    for(std::size_t i = 0; i < count; i++) {
+      ptl_plan::step step;
+      step.name = get_string();
+      uint8_t flags = 0;
+      get(&flags, sizeof(flags));
+      step.is_state = (flags & 1) != 0;
+      step.nested = (flags & 2) != 0;
+      step.has_args = (flags & 4) != 0;
+
+      std::size_t nargs = get_u32();
+      for(std::size_t j = 0; j < nargs; j++) {
+        auto index = get_index(i);  // Only earlier steps
+        if(step.nested) {
+          check_state(plan, index);
+        }
+        step.args.push_back(index);
+      }
+      std::size_t nkw = get_u32();
+      for(std::size_t j = 0; j < nkw; j++) {
+        step.kw.push_back(get_argument());
+      }
+      plan.steps.push_back(std::move(step));
+    }
+
+    std::size_t nstates = get_u32();
+    for(std::size_t i = 0; i < nstates; i++) {
+      auto index = get_index(count);
+      check_state(plan, index);
+      plan.states.push_back(index);
+    }
+    plan.root = get_index(count);
+    return plan;
+  }
+
+ private:
+  std::istream& input;
+
+  void get(void* ptr, std::size_t n)
+  {
+    input.read(static_cast<char*>(ptr), std::streamsize(n));
+    if(not input) {
+      throw std::runtime_error("Truncated plan file");
+    }
+  }
+
+  std::size_t get_u32()
+  {
+    uint32_t word = 0;
+    get(&word, sizeof(word));
+    return word;
+  }
+
+  std::size_t get_index(std::size_t bound)
+  {
+    std::size_t index = get_u32();
+    if(index >= bound) {
+      throw std::runtime_error("Corrupted plan file");
+    }
+    return index;
+  }
+
+  // States and nested arguments are cast to states when instantiated
+  static void check_state(const ptl_plan& plan, std::size_t index)
+  {
+    if(not plan.steps[index].is_state) {
+      throw std::runtime_error("Corrupted plan file");
+    }
+  }
+
+  // Lengths are checked against the rest of the stream before allocating
+  std::string get_string()
+  {
+    std::size_t length = get_u32();
+    if(length > remaining()) {
+      throw std::runtime_error("Truncated plan file");
+    }
+    std::string str(length, '\0');
+    get(str.data(), str.size());
+    return str;
+  }
+
+  // Bytes left in the stream, or the maximum if it cannot seek
+  std::size_t remaining()
+  {
+    auto current = input.tellg();
+    if(current == std::istream::pos_type(-1)) {
+      return std::numeric_limits<std::size_t>::max();
+    }
+    input.seekg(0, std::ios::end);
+    auto end = input.tellg();
+    input.seekg(current);
+    if(end == std::istream::pos_type(-1) or not input) {
+      throw std::runtime_error("Truncated plan file");
+    }
+    return static_cast<std::size_t>(end - current);
+  }
+
+  ptl_plan::argument get_argument()
+  {
+    using kind = ptl_plan::argument::kind;
+    ptl_plan::argument arg;
+    arg.name = get_string();
+    get(&arg.type, sizeof(arg.type));
+    switch(arg.type) {
+      case kind::text:
+        arg.text = get_string();
+        break;
+      case kind::index:
+        get(&arg.index, sizeof(arg.index));
+        break;
+      case kind::bound:
+        get(&arg.bound, sizeof(arg.bound));
+        break;
+      case kind::names: {
+        std::size_t n = get_u32();
+        for(std::size_t i = 0; i < n; i++) {
+          arg.names.push_back(get_string());
+        }
+        break;
+      }
+      default:
+        throw std::runtime_error("Corrupted plan file");
+    }
+    return arg;
+  }
+};
+
+inline void save_plan(const std::string& filename, const ptl_plan& plan)
+{
+  std::ofstream output(filename, std::ios::binary);
+  if(not output) {
+    throw std::runtime_error("Error creating plan file: " + filename);
+  }
+  plan_writer(output).write(plan);
+}
+
+inline ptl_plan load_plan(const std::string& filename)
+{
+  std::ifstream input(filename, std::ios::binary);
+  if(not input) {
+    throw std::runtime_error("Error opening plan file: " + filename);
+  }
+  return plan_reader(input).read();
+}
+
+}  // namespace reelay
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace reelay {
+
+/*
+ * Type tags of fixed-width scalars stored in binary files.
+ */
+enum class scalar_kind : uint8_t {
+  boolean = 1,
+  int32 = 2,
+  int64 = 3,
+  float64 = 4
+};
+
+template<typename T>
+struct scalar_kind_of {
+  static_assert(sizeof(T) == 0, "Unsupported scalar type for binary files");
+};
+template<>
+struct scalar_kind_of<bool> {
+  static constexpr scalar_kind value = scalar_kind::boolean;
+};
+template<>
+struct scalar_kind_of<int32_t> {
+  static constexpr scalar_kind value = scalar_kind::int32;
+};
+template<>
+struct scalar_kind_of<int64_t> {
+  static constexpr scalar_kind value = scalar_kind::int64;
+};
+template<>
+struct scalar_kind_of<double> {
+  static constexpr scalar_kind value = scalar_kind::float64;
+};
+
+inline std::size_t scalar_size(scalar_kind kind)
+{
+  switch(kind) {
+    case scalar_kind::boolean:
+      return sizeof(bool);
+    case scalar_kind::int32:
+      return sizeof(int32_t);
+    case scalar_kind::int64:
+      return sizeof(int64_t);
+    case scalar_kind::float64:
+      return sizeof(double);
+  }
+  return 0;
+}
+
+}  // namespace reelay
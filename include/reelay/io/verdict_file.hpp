@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "reelay/io/mapped_file.hpp"
+#include "reelay/io/scalar_kind.hpp"
+#include "reelay/json.hpp"
+
+namespace reelay {
+
+/*
+ * Binary verdict file format (.rylb)
+ *
+ * A verdict file starts with a fixed 16-byte header followed by packed
+ * fixed-width records in native byte order. Records are either points
+ * (time, value) or intervals (begin, end, value) as declared in the header.
+ * Reading the file back needs no parsing: records can be used in place.
+ */
+enum class verdict_model : uint8_t { discrete = 0, dense = 1 };
+enum class verdict_layout : uint8_t { point = 0, interval = 1 };
+
+#pragma pack(push, 1)
+struct verdict_header {
+  char magic[4];
+  uint16_t version;
+  verdict_model model;
+  verdict_layout layout;
+  scalar_kind time_kind;
+  scalar_kind value_kind;
+  uint16_t record_size;
+  uint32_t reserved;
+};
+
+template<typename TimeT, typename ValueT>
+struct verdict_point {
+  TimeT time;
+  ValueT value;
+};
+
+template<typename TimeT, typename ValueT>
+struct verdict_interval {
+  TimeT begin;
+  TimeT end;
+  ValueT value;
+};
+#pragma pack(pop)
+static_assert(sizeof(verdict_header) == 16);
+
+static constexpr char verdict_magic[4] = {'R', 'Y', 'L', 'B'};
+static constexpr uint16_t verdict_version = 1;
+
+/*
+ * Buffered writer for verdict files.
+ *
+ * The writer is a callable sink and can be passed to the push() member of
+ * monitors directly. Records are accumulated in memory and written in large
+ * blocks; the stream is never flushed per record.
+ */
+template<typename TimeT, typename ValueT>
+struct verdict_writer {
+  using time_t = TimeT;
+  using value_t = ValueT;
+
+  using point_t = verdict_point<time_t, value_t>;
+  using interval_t = verdict_interval<time_t, value_t>;
+
+  static constexpr std::size_t buffer_size = 64 * 1024;  // 64 KiB
+
+  explicit verdict_writer(
+    std::ostream& os,
+    verdict_model model = verdict_model::discrete,
+    verdict_layout layout = verdict_layout::point)
+      : output(os), layout(layout)
+  {
+    verdict_header header{};
+    std::memcpy(header.magic, verdict_magic, sizeof(verdict_magic));
+    header.version = verdict_version;
+    header.model = model;
+    header.layout = layout;
+    header.time_kind = scalar_kind_of<time_t>::value;
+    header.value_kind = scalar_kind_of<value_t>::value;
+    header.record_size = static_cast<uint16_t>(
+      layout == verdict_layout::point ? sizeof(point_t) : sizeof(interval_t));
+
+    buffer.reserve(buffer_size);
+    append(&header, sizeof(header));
+  }
+
+  verdict_writer(const verdict_writer&) = delete;
+  verdict_writer& operator=(const verdict_writer&) = delete;
+
+  ~verdict_writer()
+  {
+    flush();
+  }
+
+  void operator()(time_t time, value_t value)
+  {
+    if(layout != verdict_layout::point) {
+      throw std::logic_error("Verdict file expects interval records");
+    }
+    point_t record{time, value};
+    append(&record, sizeof(record));
+  }
+
+  void operator()(time_t begin, time_t end, value_t value)
+  {
+    if(layout != verdict_layout::interval) {
+      throw std::logic_error("Verdict file expects point records");
+    }
+    interval_t record{begin, end, value};
+    append(&record, sizeof(record));
+  }
+
+  void flush()
+  {
+    if(not buffer.empty()) {
+      output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      buffer.clear();
+    }
+    output.flush();
+  }
+
+ private:
+  std::ostream& output;
+  verdict_layout layout;
+  std::vector<char> buffer;
+
+  void append(const void* ptr, std::size_t n)
+  {
+    if(buffer.size() + n > buffer_size) {
+      output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      buffer.clear();
+    }
+    const char* bytes = static_cast<const char*>(ptr);
+    buffer.insert(buffer.end(), bytes, bytes + n);
+  }
+};
+
+/*
+ * Memory-mapped reader for verdict files.
+ *
+ * Typed record access returns a pointer into the mapping; the caller must
+ * request the time and value types declared in the header.
+ */
+struct verdict_reader {
+  explicit verdict_reader(const std::string& filename) : file(filename)
+  {
+    if(file.size() < sizeof(verdict_header)) {
+      throw std::runtime_error("Not a verdict file: " + filename);
+    }
+    std::memcpy(&head, file.data(), sizeof(verdict_header));
+    if(std::memcmp(head.magic, verdict_magic, sizeof(verdict_magic)) != 0) {
+      throw std::runtime_error("Not a verdict file: " + filename);
+    }
+    if(head.version != verdict_version) {
+      throw std::runtime_error(
+        "Unsupported verdict file version: " + std::to_string(head.version));
+    }
+    if(head.record_size == 0) {
+      throw std::runtime_error("Corrupted verdict file: " + filename);
+    }
+  }
+
+  const verdict_header& header() const
+  {
+    return head;
+  }
+
+  std::size_t size() const
+  {
+    return (file.size() - sizeof(verdict_header)) / head.record_size;
+  }
+
+  template<typename TimeT, typename ValueT>
+  const verdict_point<TimeT, ValueT>* points() const
+  {
+    check<TimeT, ValueT>(verdict_layout::point);
+    return reinterpret_cast<const verdict_point<TimeT, ValueT>*>(records());
+  }
+
+  template<typename TimeT, typename ValueT>
+  const verdict_interval<TimeT, ValueT>* intervals() const
+  {
+    check<TimeT, ValueT>(verdict_layout::interval);
+    return reinterpret_cast<const verdict_interval<TimeT, ValueT>*>(
+      records());
+  }
+
+  /*
+   * Writes records as JSON lines in the same shape as the text output of
+   * command line apps, using `t_name` and `y_name` as field names.
+   */
+  void to_json_lines(
+    std::ostream& os,
+    const std::string& t_name = "time",
+    const std::string& y_name = "value") const
+  {
+    switch(head.time_kind) {
+      case scalar_kind::int32:
+        return dispatch_value<int32_t>(os, t_name, y_name);
+      case scalar_kind::int64:
+        return dispatch_value<int64_t>(os, t_name, y_name);
+      case scalar_kind::float64:
+        return dispatch_value<double>(os, t_name, y_name);
+      default:
+        throw std::runtime_error("Unsupported time type in verdict file");
+    }
+  }
+
+ private:
+  mapped_file file;
+  verdict_header head{};
+
+  const char* records() const
+  {
+    return file.data() + sizeof(verdict_header);
+  }
+
+  template<typename TimeT, typename ValueT>
+  void check(verdict_layout layout) const
+  {
+    if(
+      head.layout != layout or
+      head.time_kind != scalar_kind_of<TimeT>::value or
+      head.value_kind != scalar_kind_of<ValueT>::value) {
+      throw std::invalid_argument("Verdict file record type mismatch");
+    }
+    // Records are read in place, so their size must match the types exactly
+    std::size_t expected = layout == verdict_layout::point
+                             ? sizeof(verdict_point<TimeT, ValueT>)
+                             : sizeof(verdict_interval<TimeT, ValueT>);
+    if(head.record_size != expected) {
+      throw std::runtime_error("Corrupted verdict file: record size mismatch");
+    }
+  }
+
+  template<typename TimeT>
+  void dispatch_value(
+    std::ostream& os, const std::string& t_name, const std::string& y_name)
+    const
+  {
+    switch(head.value_kind) {
+      case scalar_kind::boolean:
+        return write_json<TimeT, bool>(os, t_name, y_name);
+      case scalar_kind::int64:
+        return write_json<TimeT, int64_t>(os, t_name, y_name);
+      case scalar_kind::float64:
+        return write_json<TimeT, double>(os, t_name, y_name);
+      default:
+        throw std::runtime_error("Unsupported value type in verdict file");
+    }
+  }
+
+  template<typename TimeT, typename ValueT>
+  void write_json(
+    std::ostream& os, const std::string& t_name, const std::string& y_name)
+    const
+  {
+    const std::size_t n = size();
+    if(head.layout == verdict_layout::point) {
+      const auto* ptr = points<TimeT, ValueT>();
+      for(std::size_t i = 0; i < n; i++) {
+        TimeT time = ptr[i].time;
+        ValueT value = ptr[i].value;
+        os << json({{t_name, time}, {y_name, value}}) << '\n';
+      }
+    }
+    else {
+      const auto* ptr = intervals<TimeT, ValueT>();
+      for(std::size_t i = 0; i < n; i++) {
+        TimeT begin = ptr[i].begin;
+        TimeT end = ptr[i].end;
+        ValueT value = ptr[i].value;
+        os << json({{"begin", begin}, {"end", end}, {y_name, value}}) << '\n';
+      }
+    }
+  }
+};
+
+}  // namespace reelay
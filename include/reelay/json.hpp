@@ -12,6 +12,7 @@
 #include "reelay/third_party/nlohmann/json.hpp"
 
 #include <string>
+#include <string_view>
 #include <unordered_set>
 
 namespace reelay {
@@ -31,14 +32,22 @@ template<>
 struct datafield<json> {
   using input_t = json;
 
-  inline static input_t at(const input_t& container, const std::string& key)
+  inline static const input_t& at(
+    const input_t& container, const std::string& key)
+  {
+    return container.at(key);
+  }
+
+  inline static const input_t& at(const input_t& container, std::size_t index)
   {
-    return container[key];
+    return container.at(index);
   }
 
-  inline static input_t at(const input_t& container, std::size_t index)
+  inline static const input_t* find(
+    const input_t& container, const std::string& key)
   {
-    return container[index];
+    auto it = container.find(key);
+    return it != container.end() ? &*it : nullptr;
   }
 
   inline static bool contains(const input_t& container, const std::string& key)
@@ -46,6 +55,11 @@ struct datafield<json> {
     return container.find(key) != container.end();
   }
 
+  inline static bool contains(const input_t& container, std::string_view key)
+  {
+    return container.find(key) != container.end();
+  }
+
   inline static bool as_bool(const input_t& container, const std::string& key)
   {
     return container.at(key);
@@ -68,6 +82,12 @@ struct datafield<json> {
     return container.at(key);
   }
 
+  inline static std::string_view as_string_view(
+    const input_t& container, const std::string& key)
+  {
+    return container.at(key).get_ref<const std::string&>();
+  }
+
   inline static bool contains(const input_t& container, std::size_t index)
   {
     return index < container.size();
@@ -93,6 +113,12 @@ struct datafield<json> {
   {
     return container.at(index);
   }
+
+  inline static std::string_view as_string_view(
+    const input_t& container, std::size_t index)
+  {
+    return container.at(index).get_ref<const std::string&>();
+  }
 };
 
 }  // namespace reelay
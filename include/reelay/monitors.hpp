@@ -14,6 +14,9 @@
 #include "reelay/monitors/dense_timed_robustness_0_monitor.hpp"
 #include "reelay/monitors/discrete_timed_data_monitor.hpp"
 #include "reelay/monitors/discrete_timed_monitor.hpp"
+#include "reelay/monitors/discrete_timed_monitor_set.hpp"
+#include "reelay/monitors/discrete_timed_parallel_monitor.hpp"
+#include "reelay/monitors/discrete_timed_regex_monitor.hpp"
 #include "reelay/monitors/discrete_timed_robustness_monitor.hpp"
 #include "reelay/monitors/monitor.hpp"
 #include "reelay/networks.hpp"
@@ -218,4 +221,69 @@ static monitor<InputT, OutputT> make_monitor(
     "Error: Data references are not supported for robustness settings.");
 }
 
+/*
+ * Monitors from plans loaded by `load_plan`. The plan records the setting it
+ * was compiled for, which selects the monitor in place of an inspection.
+ */
+template<typename TimeT, typename InputT, typename OutputT>
+static monitor<InputT, OutputT> make_monitor(
+  const ptl_plan& plan,
+  const dense_monitor_options<TimeT, InputT, OutputT>& options)
+{
+  using data_monitor_t = dense_timed_data_monitor<TimeT, InputT, OutputT>;
+  using monitor_t = dense_timed_monitor<TimeT, InputT, OutputT>;
+
+  using type = monitor<InputT, OutputT>;
+
+  if(plan.setting == data_monitor_t::network_t::setting_name) {
+    return type(std::make_shared<data_monitor_t>(
+      data_monitor_t::from_plan(plan, options.get_basic_options())));
+  }
+
+  return type(std::make_shared<monitor_t>(
+    monitor_t::from_plan(plan, options.get_basic_options())));
+}
+
+template<typename TimeT, typename InputT, typename OutputT>
+static monitor<InputT, OutputT> make_monitor(
+  const ptl_plan& plan,
+  const discrete_monitor_options<TimeT, InputT, OutputT>& options)
+{
+  using time_type = TimeT;
+  using input_type = InputT;
+  using output_type = OutputT;
+
+  using type = monitor<InputT, OutputT>;
+
+  bool has_references =
+    plan.setting ==
+    discrete_timed_data_network<time_type, input_type>::setting_name;
+
+  if(has_references and options.is_condensing()) {
+    using monitor_t =
+      discrete_timed_data_monitor<time_type, input_type, output_type, true>;
+    return type(std::make_shared<monitor_t>(
+      monitor_t::from_plan(plan, options.get_basic_options())));
+  }
+
+  if(has_references and not options.is_condensing()) {
+    using monitor_t =
+      discrete_timed_data_monitor<time_type, input_type, output_type, false>;
+    return type(std::make_shared<monitor_t>(
+      monitor_t::from_plan(plan, options.get_basic_options())));
+  }
+
+  if(options.is_condensing()) {
+    using monitor_t =
+      discrete_timed_monitor<time_type, input_type, output_type, true>;
+    return type(std::make_shared<monitor_t>(
+      monitor_t::from_plan(plan, options.get_basic_options())));
+  }
+
+  using monitor_t =
+    discrete_timed_monitor<time_type, input_type, output_type, false>;
+  return type(std::make_shared<monitor_t>(
+    monitor_t::from_plan(plan, options.get_basic_options())));
+}
+
 }  // namespace reelay
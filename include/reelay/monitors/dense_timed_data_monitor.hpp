@@ -11,6 +11,8 @@
 #include <string>
 
 #include "reelay/formatters/formatter.hpp"
+#include "reelay/formatters/sink_formatter.hpp"
+#include "reelay/io/plan_file.hpp"
 #include "reelay/monitors/abstract_monitor.hpp"
 #include "reelay/networks/dense_timed_data_network.hpp"
 //
@@ -31,18 +33,55 @@ struct dense_timed_data_monitor final
   using network_t = dense_timed_data_network<time_type, input_type>;
   using formatter_t
       = dense_timed_data_formatter<time_type, value_type, output_type>;
+  using sink_formatter_t = dense_timed_data_sink_formatter<time_type>;
+  using interval_formatter_t = dense_timed_interval_sink_formatter<time_type>;
 
   dense_timed_data_monitor() = default;
 
   explicit dense_timed_data_monitor(
       const data_mgr_t mgr, const network_t &n, const formatter_t &f)
-      : manager(mgr), network(n), formatter(f) {}
+      : manager(mgr), network(n), formatter(f), sink_formatter(mgr) {}
 
   output_type update(const input_type &args) override {
     auto result = network.update(args);
     return formatter.format(result, network.previous, network.current);
   }
 
+  template <typename SinkT>
+  void push(const input_type &args, SinkT &&sink) {
+    auto result = network.update(args);
+    sink_formatter.format(result, network.previous, network.current, sink);
+  }
+
+  template <typename InputIt, typename SinkT>
+  void push(InputIt first, InputIt last, SinkT &&sink) {
+    for (; first != last; ++first) {
+      push(*first, sink);
+    }
+  }
+
+  // Same as `push` but reports verdicts as final intervals, see
+  // dense_timed_interval_sink_formatter
+  template <typename SinkT>
+  void push_intervals(const input_type &args, SinkT &&sink) {
+    const auto &result = network.update(args);
+    interval_formatter.format(
+        result, manager, network.previous, network.current, sink);
+  }
+
+  template <typename InputIt, typename SinkT>
+  void push_intervals(InputIt first, InputIt last, SinkT &&sink) {
+    for (; first != last; ++first) {
+      push_intervals(*first, sink);
+    }
+  }
+
+  // Reports the last interval up to the current time
+  template <typename SinkT>
+  void close_intervals(SinkT &&sink) {
+    interval_formatter.close(sink);
+  }
+
   output_type now() override {
     return formatter.now(network.current);
   }
@@ -62,9 +101,22 @@ struct dense_timed_data_monitor final
     return std::make_shared<type>(mgr, net, formatter);
   }
 
+  static type from_plan(const ptl_plan &plan, const basic_options &options) {
+    auto mgr = options.get_data_manager();
+    auto net = network_t::from_plan(plan, options);
+    auto formatter = formatter_t(options);
+    return type(mgr, net, formatter);
+  }
+
+  static type from_plan(const std::string &path, const basic_options &options) {
+    return from_plan(load_plan(path), options);
+  }
+
  private:
   data_mgr_t manager;
   network_t network;
   formatter_t formatter;
+  sink_formatter_t sink_formatter;
+  interval_formatter_t interval_formatter;
 };
 }  // namespace reelay
\ No newline at end of file
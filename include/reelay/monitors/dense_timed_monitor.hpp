@@ -8,9 +8,12 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "reelay/formatters/formatter.hpp"
+#include "reelay/formatters/sink_formatter.hpp"
+#include "reelay/io/plan_file.hpp"
 #include "reelay/monitors/abstract_monitor.hpp"
 #include "reelay/networks/dense_timed_network.hpp"
 //
@@ -29,6 +32,8 @@ struct dense_timed_monitor final : public abstract_monitor<InputT, OutputT> {
 
   using network_t = dense_timed_network<time_type, input_type>;
   using formatter_t = dense_timed_formatter<time_type, value_type, output_type>;
+  using sink_formatter_t = dense_timed_sink_formatter<time_type>;
+  using interval_formatter_t = dense_timed_interval_sink_formatter<time_type>;
 
   dense_timed_monitor() = default;
 
@@ -39,11 +44,50 @@ struct dense_timed_monitor final : public abstract_monitor<InputT, OutputT> {
     return formatter.now(network.current);
   }
 
+  // The verdict once it can no longer change, if so
+  std::optional<bool> decided() const {
+    return network.decided();
+  }
+
   output_type update(const input_type &args) override {
-    auto result = network.update(args);
+    const auto &result = network.update(args);
     return formatter.format(result, network.previous, network.current);
   }
 
+  template <typename SinkT>
+  void push(const input_type &args, SinkT &&sink) {
+    const auto &result = network.update(args);
+    sink_formatter.format(result, network.previous, network.current, sink);
+  }
+
+  template <typename InputIt, typename SinkT>
+  void push(InputIt first, InputIt last, SinkT &&sink) {
+    for (; first != last; ++first) {
+      push(*first, sink);
+    }
+  }
+
+  // Same as `push` but reports verdicts as final intervals, see
+  // dense_timed_interval_sink_formatter
+  template <typename SinkT>
+  void push_intervals(const input_type &args, SinkT &&sink) {
+    const auto &result = network.update(args);
+    interval_formatter.format(result, network.previous, network.current, sink);
+  }
+
+  template <typename InputIt, typename SinkT>
+  void push_intervals(InputIt first, InputIt last, SinkT &&sink) {
+    for (; first != last; ++first) {
+      push_intervals(*first, sink);
+    }
+  }
+
+  // Reports the last interval up to the current time
+  template <typename SinkT>
+  void close_intervals(SinkT &&sink) {
+    interval_formatter.close(sink);
+  }
+
   static type make(const std::string &pattern, const basic_options &options) {
     auto net = network_t::make(pattern, options);
     auto formatter = formatter_t(options);
@@ -57,8 +101,20 @@ struct dense_timed_monitor final : public abstract_monitor<InputT, OutputT> {
     return std::make_shared<type>(net, formatter);
   }
 
+  static type from_plan(const ptl_plan &plan, const basic_options &options) {
+    auto net = network_t::from_plan(plan, options);
+    auto formatter = formatter_t(options);
+    return type(net, formatter);
+  }
+
+  static type from_plan(const std::string &path, const basic_options &options) {
+    return from_plan(load_plan(path), options);
+  }
+
  private:
   network_t network;
   formatter_t formatter;
+  sink_formatter_t sink_formatter;
+  interval_formatter_t interval_formatter;
 };
 }  // namespace reelay
\ No newline at end of file
@@ -11,6 +11,8 @@
 #include <string>
 
 #include "reelay/formatters/formatter.hpp"
+#include "reelay/formatters/sink_formatter.hpp"
+#include "reelay/io/plan_file.hpp"
 #include "reelay/monitors/abstract_monitor.hpp"
 #include "reelay/networks/dense_timed_robustness_0_network.hpp"
 //
@@ -33,6 +35,8 @@ struct dense_timed_robustness_0_monitor final
       = dense_timed_robustness_0_network<time_type, value_type, input_type>;
   using formatter_t
       = dense_timed_robustness_formatter<time_type, value_type, output_type>;
+  using sink_formatter_t
+      = dense_timed_robustness_sink_formatter<time_type, value_type>;
 
   dense_timed_robustness_0_monitor() = default;
 
@@ -49,6 +53,19 @@ struct dense_timed_robustness_0_monitor final
     return formatter.format(result, network.previous, network.current);
   }
 
+  template <typename SinkT>
+  void push(const input_type &args, SinkT &&sink) {
+    auto result = network.update(args);
+    sink_formatter.format(result, network.previous, network.current, sink);
+  }
+
+  template <typename InputIt, typename SinkT>
+  void push(InputIt first, InputIt last, SinkT &&sink) {
+    for (; first != last; ++first) {
+      push(*first, sink);
+    }
+  }
+
   static type make(const std::string &pattern, const basic_options &options) {
     auto net = network_t::make(pattern, options);
     auto formatter = formatter_t(options);
@@ -62,8 +79,19 @@ struct dense_timed_robustness_0_monitor final
     return std::make_shared<type>(net, formatter);
   }
 
+  static type from_plan(const ptl_plan &plan, const basic_options &options) {
+    auto net = network_t::from_plan(plan, options);
+    auto formatter = formatter_t(options);
+    return type(net, formatter);
+  }
+
+  static type from_plan(const std::string &path, const basic_options &options) {
+    return from_plan(load_plan(path), options);
+  }
+
  private:
   network_t network;
   formatter_t formatter;
+  sink_formatter_t sink_formatter;
 };
 }  // namespace reelay
\ No newline at end of file
@@ -15,6 +15,8 @@
 #include <utility>
 
 #include "reelay/formatters/formatter.hpp"
+#include "reelay/formatters/sink_formatter.hpp"
+#include "reelay/io/plan_file.hpp"
 #include "reelay/monitors/abstract_monitor.hpp"
 #include "reelay/networks/discrete_timed_data_network.hpp"
 //
@@ -44,6 +46,7 @@ struct discrete_timed_data_monitor final
   using network_t = discrete_timed_data_network<time_type, input_type>;
   using formatter_t
       = discrete_timed_formatter<time_type, value_type, output_type, condensing>;
+  using sink_formatter_t = discrete_timed_sink_formatter<time_type, value_type>;
 
   discrete_timed_data_monitor() = default;
 
@@ -59,6 +62,19 @@ struct discrete_timed_data_monitor final
     auto result = network.update(args);
     return formatter.format(result != manager->zero(), network.now());
   }
+
+  template <typename SinkT>
+  void push(const input_type &args, SinkT &&sink) {
+    auto result = network.update(args);
+    sink_formatter.format(result != manager->zero(), network.now(), sink);
+  }
+
+  template <typename InputIt, typename SinkT>
+  void push(InputIt first, InputIt last, SinkT &&sink) {
+    for (; first != last; ++first) {
+      push(*first, sink);
+    }
+  }
   
   static type make(const std::string &pattern, const basic_options &options) {
     auto mgr = options.get_data_manager();
@@ -75,10 +91,22 @@ struct discrete_timed_data_monitor final
     return std::make_shared<type>(mgr, net, fmt);
   }
 
+  static type from_plan(const ptl_plan &plan, const basic_options &options) {
+    auto mgr = options.get_data_manager();
+    auto net = network_t::from_plan(plan, options);
+    auto fmt = formatter_t(options);
+    return type(mgr, net, fmt);
+  }
+
+  static type from_plan(const std::string &path, const basic_options &options) {
+    return from_plan(load_plan(path), options);
+  }
+
  private:
   data_mgr_t manager;
   network_t network;
   formatter_t formatter;
+  sink_formatter_t sink_formatter;
 };
 }  // namespace reelay
 #endif
@@ -8,10 +8,16 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <utility>
 
 #include "reelay/formatters/formatter.hpp"
+#include "reelay/formatters/sink_formatter.hpp"
+#include "reelay/io/plan_file.hpp"
 #include "reelay/monitors/abstract_monitor.hpp"
+#include "reelay/networks/discrete_timed_automaton.hpp"
 #include "reelay/networks/discrete_timed_network.hpp"
 //
 #include "reelay/options.hpp"
@@ -37,8 +43,10 @@ struct discrete_timed_monitor final : public abstract_monitor<InputT, OutputT> {
   using network_type = discrete_timed_network<time_type, input_type>;
 
   using network_t = discrete_timed_network<time_type, input_type>;
+  using automaton_t = discrete_timed_automaton<time_type, input_type>;
   using formatter_t
       = discrete_timed_formatter<time_type, value_type, output_type, condensing>;
+  using sink_formatter_t = discrete_timed_sink_formatter<time_type, value_type>;
 
   discrete_timed_monitor() = default;
 
@@ -46,29 +54,83 @@ struct discrete_timed_monitor final : public abstract_monitor<InputT, OutputT> {
       : network(n), formatter(f) {}
 
   output_type update(const input_type &args) override {
-    auto result = network.update(args);
-    return formatter.format(result, network.now());
+    auto result = step(args);
+    return formatter.format(result, current());
   }
 
   output_type now() override {
-    return formatter.now(network.now());
+    return formatter.now(current());
   }
 
+  // The verdict once it can no longer change, if so
+  std::optional<bool> decided() const {
+    return automaton ? automaton->decided() : network.decided();
+  }
+
+  // Whether the specification runs on a transition table
+  bool is_automaton() const {
+    return automaton.has_value();
+  }
+
+  template <typename SinkT>
+  void push(const input_type &args, SinkT &&sink) {
+    auto result = step(args);
+    sink_formatter.format(result, current(), sink);
+  }
+
+  template <typename InputIt, typename SinkT>
+  void push(InputIt first, InputIt last, SinkT &&sink) {
+    for (; first != last; ++first) {
+      push(*first, sink);
+    }
+  }
+
+  // With the automaton option, the network is built only if the
+  // specification does not compile into a transition table
   static type make(const std::string &pattern, const basic_options &options) {
-    auto net = network_t::make(pattern, options);
     auto formatter = formatter_t(options);
-    return type(net, formatter);
+    if (options.is_automaton()) {
+      if (auto compiled = automaton_t::compile(pattern, options)) {
+        auto result = type(network_t(), formatter);
+        result.automaton = std::move(compiled);
+        return result;
+      }
+    }
+    return type(network_t::make(pattern, options), formatter);
   }
 
   static std::shared_ptr<type> make_shared(
       const std::string &pattern, const basic_options &options) {
-    auto net = network_t::make(pattern, options);
-    auto formatter = formatter_t(options);
-    return std::make_shared<type>(net, formatter);
+    return std::make_shared<type>(make(pattern, options));
+  }
+
+  // Instantiates the monitor from a recorded plan without parsing. Plans
+  // record networks, so the automaton option is rejected here.
+  static type from_plan(const ptl_plan &plan, const basic_options &options) {
+    if (options.is_automaton()) {
+      throw std::invalid_argument(
+          "Automata cannot be instantiated from plans: " + plan.source);
+    }
+    return type(network_t::from_plan(plan, options), formatter_t(options));
+  }
+
+  static type from_plan(const std::string &path, const basic_options &options) {
+    return from_plan(load_plan(path), options);
   }
 
  private:
   network_t network;
+  // Replaces the network if the specification compiles within the limit
+  std::optional<automaton_t> automaton;
   formatter_t formatter;
+  sink_formatter_t sink_formatter;
+
+  value_type step(const input_type &args) {
+    return automaton ? automaton->update(args) : network.update(args);
+  }
+
+  time_type current() const {
+    return automaton ? automaton->now() : network.now();
+  }
 };
 }  // namespace reelay
\ No newline at end of file
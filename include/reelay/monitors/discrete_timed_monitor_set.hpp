@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "reelay/networks/basic_structure.hpp"
+#include "reelay/networks/discrete_timed_network.hpp"
+#include "reelay/parser/ptl_plan.hpp"
+//
+#include "reelay/options.hpp"
+
+namespace reelay {
+
+/*
+ * Monitors many discrete timed specifications over the same input stream.
+ *
+ * The specifications are merged into one network whose atoms and identical
+ * subformulas are shared (see ptl_plan_set), so every distinct subformula is
+ * updated once per event however many specifications contain it. Verdicts
+ * are reported together: `push` calls `sink(time, index, value)` for each
+ * specification whose verdict changed, and for all of them at time zero.
+ */
+template <typename TimeT, typename InputT>
+struct discrete_timed_monitor_set {
+  using time_type = TimeT;
+  using value_type = bool;
+  using input_type = InputT;
+
+  using type = discrete_timed_monitor_set<time_type, input_type>;
+
+  using network_t = discrete_timed_network<time_type, input_type>;
+  using node_ptr_t = typename network_t::node_ptr_t;
+  using state_ptr_t = typename network_t::state_ptr_t;
+
+  discrete_timed_monitor_set() = default;
+
+  explicit discrete_timed_monitor_set(const ptl_plan_set &plans,
+                                      const basic_options &options) {
+    if (plans.setting != network_t::setting_name) {
+      throw std::invalid_argument("Plans recorded for another setting: " +
+                                  plans.setting);
+    }
+    auto parser = ptl_parser<network_t>(network_t::settings(options));
+    auto nodes = parser.replay(plans.steps);
+    for (auto i : plans.states) {
+      states.push_back(std::static_pointer_cast<
+                       typename network_t::state_t>(nodes[i]));
+    }
+    for (auto i : plans.roots) {
+      roots.push_back(nodes[i]);
+    }
+    values.assign(roots.size(), false);
+    steps = plans.steps.size();
+  }
+
+  template <typename SinkT>
+  void push(const input_type &args, SinkT &&sink) {
+    current = current + time_type(1);
+    bool pruning = false;
+    for (const auto &state : states) {
+      state->update(args, current);
+      pruning = pruning or state->decided();
+    }
+    if (pruning) {
+      prune();
+    }
+
+    for (std::size_t i = 0; i < roots.size(); i++) {
+      bool result = roots[i]->output(current);
+      if (result != values[i] or current == 0) {
+        values[i] = result;
+        sink(current, i, result);
+      }
+    }
+  }
+
+  template <typename InputIt, typename SinkT>
+  void push(InputIt first, InputIt last, SinkT &&sink) {
+    for (; first != last; ++first) {
+      push(*first, sink);
+    }
+  }
+
+  // Verdict of the specification at `index` after the last event
+  value_type output(std::size_t index) const { return values.at(index); }
+
+  // The verdict of the specification once it can no longer change, if so
+  std::optional<bool> decided(std::size_t index) const {
+    return roots.at(index)->decided();
+  }
+
+  // Whether no verdict can change anymore. Readers may stop there.
+  bool decided() const { return settled; }
+
+  time_type now() const { return current; }
+
+  // Number of specifications
+  std::size_t size() const { return roots.size(); }
+
+  // Number of distinct nodes and of states still updated per event
+  std::size_t width() const { return steps; }
+  std::size_t active() const { return states.size(); }
+
+  static type make(const std::vector<std::string> &patterns,
+                   const basic_options &options) {
+    auto plans = ptl_plan_set();
+    for (const auto &pattern : patterns) {
+      plans.add(*network_t::compile(pattern, options));
+    }
+    return type(plans, options);
+  }
+
+ private:
+  std::vector<state_ptr_t> states;
+  std::vector<node_ptr_t> roots;
+  std::vector<value_type> values;
+  std::size_t steps = 0;
+  time_type current = -1;
+  bool settled = false;
+
+  // Retires decided subformulas, and everything once all roots decide
+  void prune() {
+    settled = true;
+    for (const auto &root : roots) {
+      settled = settled and root->decided().has_value();
+    }
+    if (settled) {
+      states.clear();
+      return;
+    }
+    prune_states(states);
+  }
+};
+
+}  // namespace reelay
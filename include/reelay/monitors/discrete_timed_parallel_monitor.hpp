@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "reelay/formatters/formatter.hpp"
+#include "reelay/formatters/sink_formatter.hpp"
+#include "reelay/io/plan_file.hpp"
+#include "reelay/monitors/abstract_monitor.hpp"
+#include "reelay/networks/discrete_timed_parallel_network.hpp"
+//
+#include "reelay/options.hpp"
+
+namespace reelay {
+
+template <
+    typename TimeT, typename InputT, typename OutputT,
+    bool condensing = true>
+struct discrete_timed_parallel_monitor final
+    : public abstract_monitor<InputT, OutputT> {
+  using time_type = TimeT;
+  using value_type = bool;
+  using input_type = InputT;
+  using output_type = OutputT;
+
+  using type = discrete_timed_parallel_monitor<
+      TimeT, InputT, OutputT, condensing>;
+
+  using network_t = discrete_timed_parallel_network<time_type, input_type>;
+  using formatter_t
+      = discrete_timed_formatter<time_type, value_type, output_type, condensing>;
+  using sink_formatter_t = discrete_timed_sink_formatter<time_type, value_type>;
+
+  explicit discrete_timed_parallel_monitor(network_t n, const formatter_t &f)
+      : network(std::move(n)), formatter(f) {}
+
+  output_type update(const input_type &args) override {
+    auto result = network.update(args);
+    return formatter.format(result, network.now());
+  }
+
+  output_type now() override {
+    return formatter.now(network.now());
+  }
+
+  // The verdict once it can no longer change, if so
+  std::optional<bool> decided() const {
+    return network.decided();
+  }
+
+  template <typename SinkT>
+  void push(const input_type &args, SinkT &&sink) {
+    auto result = network.update(args);
+    sink_formatter.format(result, network.now(), sink);
+  }
+
+  template <typename InputIt, typename SinkT>
+  void push(InputIt first, InputIt last, SinkT &&sink) {
+    network.update(first, last, [this, &sink](time_type time, bool value) {
+      sink_formatter.format(value, time, sink);
+    });
+  }
+
+  static type make(const std::string &pattern, const basic_options &options,
+                   const parallel_options &parallel = parallel_options()) {
+    auto network = network_t::make(pattern, options, parallel);
+    auto formatter = formatter_t(options);
+    return type(std::move(network), formatter);
+  }
+
+  static std::shared_ptr<type> make_shared(
+      const std::string &pattern, const basic_options &options,
+      const parallel_options &parallel = parallel_options()) {
+    return std::make_shared<type>(make(pattern, options, parallel));
+  }
+
+  static type from_plan(const ptl_plan &plan, const basic_options &options,
+                        const parallel_options &parallel = parallel_options()) {
+    auto network = network_t::from_plan(plan, options, parallel);
+    auto formatter = formatter_t(options);
+    return type(std::move(network), formatter);
+  }
+
+  static type from_plan(const std::string &path, const basic_options &options,
+                        const parallel_options &parallel = parallel_options()) {
+    return from_plan(load_plan(path), options, parallel);
+  }
+
+ private:
+  network_t network;
+  formatter_t formatter;
+  sink_formatter_t sink_formatter;
+};
+}  // namespace reelay
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "reelay/formatters/formatter.hpp"
+#include "reelay/formatters/sink_formatter.hpp"
+#include "reelay/monitors/abstract_monitor.hpp"
+#include "reelay/networks/discrete_timed_regex.hpp"
+//
+#include "reelay/options.hpp"
+
+namespace reelay {
+
+template <
+    typename TimeT, typename InputT, typename OutputT,
+    bool condensing = true>
+struct discrete_timed_regex_monitor final
+    : public abstract_monitor<InputT, OutputT> {
+  using time_type = TimeT;
+  using value_type = bool;
+  using input_type = InputT;
+  using output_type = OutputT;
+
+  using type = discrete_timed_regex_monitor<
+      TimeT, InputT, OutputT, condensing>;
+
+  using regex_t = discrete_timed_regex<time_type, input_type>;
+  using formatter_t
+      = discrete_timed_formatter<time_type, value_type, output_type, condensing>;
+  using sink_formatter_t = discrete_timed_sink_formatter<time_type, value_type>;
+
+  explicit discrete_timed_regex_monitor(const regex_t &r, const formatter_t &f)
+      : regex(r), formatter(f) {}
+
+  output_type update(const input_type &args) override {
+    auto result = regex.update(args);
+    return formatter.format(result, regex.now());
+  }
+
+  output_type now() override {
+    return formatter.now(regex.now());
+  }
+
+  // The verdict once it can no longer change, if so
+  std::optional<bool> decided() const {
+    return regex.decided();
+  }
+
+  template <typename SinkT>
+  void push(const input_type &args, SinkT &&sink) {
+    auto result = regex.update(args);
+    sink_formatter.format(result, regex.now(), sink);
+  }
+
+  template <typename InputIt, typename SinkT>
+  void push(InputIt first, InputIt last, SinkT &&sink) {
+    for (; first != last; ++first) {
+      push(*first, sink);
+    }
+  }
+
+  static type make(const std::string &pattern, const basic_options &options) {
+    auto regex = regex_t::make(pattern);
+    auto formatter = formatter_t(options);
+    return type(regex, formatter);
+  }
+
+  static std::shared_ptr<type> make_shared(
+      const std::string &pattern, const basic_options &options) {
+    return std::make_shared<type>(make(pattern, options));
+  }
+
+ private:
+  regex_t regex;
+  formatter_t formatter;
+  sink_formatter_t sink_formatter;
+};
+}  // namespace reelay
@@ -11,6 +11,8 @@
 #include <string>
 
 #include "reelay/formatters/formatter.hpp"
+#include "reelay/formatters/sink_formatter.hpp"
+#include "reelay/io/plan_file.hpp"
 #include "reelay/monitors/abstract_monitor.hpp"
 #include "reelay/networks/discrete_timed_robustness_network.hpp"
 //
@@ -37,6 +39,7 @@ struct discrete_timed_robustness_monitor final
       = discrete_timed_robustness_network<time_type, value_type, input_type>;
   using formatter_t = discrete_timed_formatter<
       time_type, value_type, output_type, condensing>;
+  using sink_formatter_t = discrete_timed_sink_formatter<time_type, value_type>;
 
   discrete_timed_robustness_monitor() = default;
 
@@ -52,6 +55,19 @@ struct discrete_timed_robustness_monitor final
     auto result = network.update(args);
     return formatter.format(result, network.now());
   }
+
+  template <typename SinkT>
+  void push(const input_type &args, SinkT &&sink) {
+    auto result = network.update(args);
+    sink_formatter.format(result, network.now(), sink);
+  }
+
+  template <typename InputIt, typename SinkT>
+  void push(InputIt first, InputIt last, SinkT &&sink) {
+    for (; first != last; ++first) {
+      push(*first, sink);
+    }
+  }
   
   static type make(const std::string &pattern, const basic_options &options) {
     auto net = network_t::make(pattern, options);
@@ -66,8 +82,19 @@ struct discrete_timed_robustness_monitor final
     return std::make_shared<type>(net, formatter);
   }
 
+  static type from_plan(const ptl_plan &plan, const basic_options &options) {
+    auto net = network_t::from_plan(plan, options);
+    auto formatter = formatter_t(options);
+    return type(net, formatter);
+  }
+
+  static type from_plan(const std::string &path, const basic_options &options) {
+    return from_plan(load_plan(path), options);
+  }
+
  private:
   network_t network;
   formatter_t formatter;
+  sink_formatter_t sink_formatter;
 };
 }  // namespace reelay
\ No newline at end of file
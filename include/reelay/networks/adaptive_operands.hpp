@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "reelay/common.hpp"
+
+namespace reelay {
+
+// Whether n-ary connectives should order their operands adaptively
+inline bool is_adaptive(const kwargs& kw)
+{
+  return kw.count("adaptive") > 0 and any_cast<bool>(kw.at("adaptive"));
+}
+
+struct operand_statistics {
+  std::size_t index = 0;     // syntactic position of the operand
+  uint64_t evaluations = 0;  // times the operand was evaluated
+  uint64_t hits = 0;         // times the operand decided the result
+};
+
+/*
+ * Operands of an n-ary boolean connective over discrete-time nodes, evaluated
+ * with short-circuiting in an order learned at runtime.
+ *
+ * An operand that yields the absorbing value (false for conjunctions, true
+ * for disjunctions) is a hit. Every `period` evaluations the operands are
+ * sorted by their recent hit rate per unit cost, so cheap operands that
+ * usually decide the result come first. Operands after a hit are not
+ * evaluated. Operands are evaluated by their output only, since states among
+ * them are updated by the network, so skipping one never changes a later
+ * verdict.
+ */
+template<typename NodePtrT>
+struct adaptive_operands {
+  using node_ptr_t = NodePtrT;
+
+  static constexpr uint64_t period = 1024;
+
+  explicit adaptive_operands(const std::vector<node_ptr_t>& nodes)
+  {
+    for(std::size_t i = 0; i < nodes.size(); i++) {
+      operands.push_back(operand{nodes[i], operand_statistics{i, 0, 0}});
+    }
+  }
+
+  // Folds `evaluate(node)` over the operands until the absorbing value
+  template<typename EvaluateT>
+  bool fold(bool absorbing, EvaluateT&& evaluate)
+  {
+    bool result = not absorbing;
+    for(auto& item : operands) {
+      item.stats.evaluations++;
+      item.recent_evaluations++;
+      if(evaluate(item.node) == absorbing) {
+        item.stats.hits++;
+        item.recent_hits++;
+        result = absorbing;
+        break;
+      }
+    }
+    if(++calls % period == 0) {
+      reorder();
+    }
+    return result;
+  }
+
+  // Average number of nodes evaluated per call, including this one
+  double cost() const
+  {
+    if(calls == 0) {
+      return 1.0;
+    }
+    double total = 0.0;
+    for(const auto& item : operands) {
+      total += double(item.stats.evaluations) * item.node->cost();
+    }
+    return 1.0 + total / double(calls);
+  }
+
+  // Statistics of operands in their syntactic order
+  std::vector<operand_statistics> statistics() const
+  {
+    auto result = std::vector<operand_statistics>(operands.size());
+    for(const auto& item : operands) {
+      result[item.stats.index] = item.stats;
+    }
+    return result;
+  }
+
+  // Syntactic positions of operands in their current evaluation order
+  std::vector<std::size_t> order() const
+  {
+    auto result = std::vector<std::size_t>();
+    for(const auto& item : operands) {
+      result.push_back(item.stats.index);
+    }
+    return result;
+  }
+
+ private:
+  struct operand {
+    node_ptr_t node;
+    operand_statistics stats;
+    uint64_t recent_evaluations = 0;
+    uint64_t recent_hits = 0;
+    double rank = 0.0;
+  };
+
+  std::vector<operand> operands;
+  uint64_t calls = 0;
+
+  void reorder()
+  {
+    for(auto& item : operands) {
+      // Unevaluated operands start from an even hit rate
+      double rate = (double(item.recent_hits) + 1.0) /
+                    (double(item.recent_evaluations) + 2.0);
+      item.rank = rate / item.node->cost();
+      // Older observations fade so that the order follows phase changes
+      item.recent_evaluations /= 2;
+      item.recent_hits /= 2;
+    }
+    std::stable_sort(
+      operands.begin(), operands.end(), [](const auto& a, const auto& b) {
+        return a.rank > b.rank;
+      });
+  }
+};
+
+}  // namespace reelay
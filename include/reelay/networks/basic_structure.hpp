@@ -9,6 +9,7 @@
 #pragma once
 
 #include "memory"
+#include "optional"
 #include "vector"
 
 namespace reelay {
@@ -17,12 +18,42 @@ template<typename OutputT, typename TimeT>
 struct discrete_timed_node {
   virtual ~discrete_timed_node() {}
   virtual OutputT output(TimeT) = 0;
+
+  // The output of a boolean node once it can no longer change, if so
+  virtual std::optional<bool> decided() const
+  {
+    return std::nullopt;
+  }
+
+  // Relative cost of computing the output, used to order operands
+  virtual double cost() const
+  {
+    return 1.0;
+  }
 };
 
 template<typename OutputT, typename TimeT>
 struct dense_timed_node {
   virtual ~dense_timed_node() {}
   virtual OutputT output(TimeT, TimeT) = 0;
+
+  // The output of a boolean node once it can no longer change, if so
+  virtual std::optional<bool> decided() const
+  {
+    return std::nullopt;
+  }
+
+  // Same as `output` but the result lives in a buffer owned by the node and
+  // stays valid until the next call. Nodes override this to refresh the
+  // buffer in place, and parents read their children through it.
+  virtual const OutputT& output_ref(TimeT previous, TimeT now)
+  {
+    segment = output(previous, now);
+    return segment;
+  }
+
+ protected:
+  OutputT segment = OutputT();
 };
 
 template<typename InputT, typename OutputT, typename TimeT>
@@ -32,6 +63,12 @@ struct discrete_timed_state : discrete_timed_node<OutputT, TimeT> {
   virtual void update(const InputT&, TimeT) = 0;
 };
 
+/*
+ * Dense networks do not keep the previous sample: both input arguments of
+ * `update` refer to the current sample, which holds over (previous, now].
+ * States that need earlier values, such as interpolating atoms, keep them
+ * themselves.
+ */
 template<typename InputT, typename OutputT, typename TimeT>
 struct dense_timed_state : dense_timed_node<OutputT, TimeT> {
   virtual ~dense_timed_state() {}
@@ -39,4 +76,42 @@ struct dense_timed_state : dense_timed_node<OutputT, TimeT> {
   virtual void update(const InputT&, const InputT&, TimeT, TimeT) = 0;
 };
 
+/*
+ * Decided output of a conjunction (`absorbing` is false) or a disjunction
+ * (`absorbing` is true) over the given nodes, if any.
+ */
+template<typename NodePtrT>
+std::optional<bool> decided_fold(
+  const std::vector<NodePtrT>& args, bool absorbing)
+{
+  bool all = true;
+  for(const auto& arg : args) {
+    auto value = arg->decided();
+    if(value == absorbing) {
+      return absorbing;
+    }
+    all = all and value.has_value();
+  }
+  if(all) {
+    return not absorbing;
+  }
+  return std::nullopt;
+}
+
+/*
+ * Removes the states that no longer need updates from the update list of a
+ * network. These are decided states and states no other node refers to, so
+ * that releasing a subformula also retires its subtree. The list is in
+ * topological order and a single backward pass visits parents first.
+ */
+template<typename StatePtrT>
+void prune_states(std::vector<StatePtrT>& states)
+{
+  for(auto i = states.size(); i-- > 0;) {
+    if(states[i]->decided() or states[i].use_count() == 1) {
+      states.erase(states.begin() + i);
+    }
+  }
+}
+
 }  // namespace reelay
@@ -45,12 +45,12 @@ struct dense_timed_data_network
   using setting_t = dense_timed_data_setting::factory<input_t, time_t>;
   using options_t = basic_options;
 
+  static constexpr auto setting_name = "dense_timed_data";
+
   data_mgr_t manager;
   node_ptr_t root;
   std::vector<state_ptr_t> states;
 
-  input_t prevargs = input_t{};
-
   time_t previous = 0;  // Time Zero
   time_t current = 0;   // Time Zero
 
@@ -77,13 +77,13 @@ struct dense_timed_data_network
     return root->output(tp, tn);
   }
 
+  // States keep the previous values they need, so the current sample is
+  // passed in place of the previous one and nothing is copied
   output_t update(const input_t &args) {
     previous = current;
     current = timefield<time_t, input_t>::get_time(args);
 
-    this->update(prevargs, args, previous, current);
-
-    prevargs = args;
+    this->update(args, args, previous, current);
 
     return this->output(previous, current);
   }
@@ -113,6 +113,24 @@ struct dense_timed_data_network
     auto parser = ptl_parser<type>(kw);
     return parser.make_shared(pattern, options);
   }
+
+  static type from_plan(
+      const ptl_plan &plan, const options_t &options = options_t()) {
+    auto manager = options.get_data_manager();
+    kwargs kw = {{"manager", manager}};
+
+    auto parser = ptl_parser<type>(kw);
+    return parser.load(plan, options);
+  }
+
+  static std::shared_ptr<const ptl_plan> compile(
+      const std::string &pattern, const options_t &options = options_t()) {
+    auto manager = options.get_data_manager();
+    kwargs kw = {{"manager", manager}};
+
+    auto parser = ptl_parser<type>(kw);
+    return parser.compile(pattern);
+  }
 };
 
 }  // namespace reelay
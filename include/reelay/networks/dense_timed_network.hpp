@@ -9,6 +9,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 //
 #include "reelay/datafield.hpp"
@@ -43,11 +44,11 @@ struct dense_timed_network : public dense_timed_state<X, interval_set<T>, T> {
   using setting_t = dense_timed_setting::factory<input_t, time_t>;
   using options_t = basic_options;
 
+  static constexpr auto setting_name = "dense_timed";
+
   node_ptr_t root;
   std::vector<state_ptr_t> states;
 
-  input_t prevargs = input_t{};
-
   time_t previous = 0;  // Time Zero
   time_t current = 0;   // Time Zero
 
@@ -72,9 +73,30 @@ struct dense_timed_network : public dense_timed_state<X, interval_set<T>, T> {
   void update(
     const input_t& pargs, const input_t& args, time_t tp, time_t tn) override
   {
+    bool pruning = false;
     for(const auto& state : this->states) {
       state->update(pargs, args, tp, tn);
+      pruning = pruning or state->decided();
+    }
+    if(pruning) {
+      prune();
+    }
+  }
+
+  // The verdict once it can no longer change, if so. Readers may stop there.
+  std::optional<bool> decided() const override
+  {
+    return root->decided();
+  }
+
+  // Retires decided subformulas. Nothing is updated after the root decides.
+  void prune()
+  {
+    if(root->decided()) {
+      this->states.clear();
+      return;
     }
+    prune_states(this->states);
   }
 
   output_t output(time_t tp, time_t tn) override
@@ -82,16 +104,21 @@ struct dense_timed_network : public dense_timed_state<X, interval_set<T>, T> {
     return root->output(tp, tn);
   }
 
-  output_t update(const input_t& args)
+  const output_t& output_ref(time_t tp, time_t tn) override
+  {
+    return root->output_ref(tp, tn);
+  }
+
+  // States keep the previous values they need, so the current sample is
+  // passed in place of the previous one and nothing is copied
+  const output_t& update(const input_t& args)
   {
     previous = current;
     current = timefield<time_t, input_t>::get_time(args);
 
-    this->update(prevargs, args, previous, current);
+    this->update(args, args, previous, current);
 
-    prevargs = args;
-
-    return this->output(previous, current);
+    return output_ref(previous, current);
   }
 
   output_t output()
@@ -130,6 +157,36 @@ struct dense_timed_network : public dense_timed_state<X, interval_set<T>, T> {
     auto parser = ptl_parser<type>();
     return parser.make_shared(pattern, options);
   }
+
+  static type from_plan(
+    const ptl_plan& plan, const options_t& options = options_t())
+  {
+    kwargs kw;
+    if(options.get_interpolation() == piecewise::constant) {
+      kw["order"] = 0;
+    }
+    else if(options.get_interpolation() == piecewise::linear) {
+      kw["order"] = 1;
+    }
+
+    auto parser = ptl_parser<type>(kw);
+    return parser.load(plan, options);
+  }
+
+  static std::shared_ptr<const ptl_plan> compile(
+    const std::string& pattern, const options_t& options = options_t())
+  {
+    kwargs kw;
+    if(options.get_interpolation() == piecewise::constant) {
+      kw["order"] = 0;
+    }
+    else if(options.get_interpolation() == piecewise::linear) {
+      kw["order"] = 1;
+    }
+
+    auto parser = ptl_parser<type>(kw);
+    return parser.compile(pattern);
+  }
 };
 
 }  // namespace reelay
@@ -45,11 +45,11 @@ struct dense_timed_robustness_0_network
   using setting_t = dense_timed_robustness_0_setting::factory<input_t, value_t, time_t>;
   using options_t = basic_options;
 
+  static constexpr auto setting_name = "dense_timed_robustness_0";
+
   node_ptr_t root;
   std::vector<state_ptr_t> states;
 
-  input_t prevargs = input_t{};
-
   time_t previous = 0;  // Time Zero
   time_t current = 0;   // Time Zero
 
@@ -76,13 +76,13 @@ struct dense_timed_robustness_0_network
     return root->output(previous, now);
   }
 
+  // States keep the previous values they need, so the current sample is
+  // passed in place of the previous one and nothing is copied
   base_t update(const input_t &args) {
     previous = current;
     current = timefield<time_t, input_t>::get_time(args);
 
-    this->update(prevargs, args, previous, current);
-
-    prevargs = args;
+    this->update(args, args, previous, current);
 
     return output(previous, current);
   }
@@ -102,6 +102,18 @@ struct dense_timed_robustness_0_network
     auto parser = ptl_parser<type>();
     return parser.make_shared(pattern, options);
   }
+
+  static type from_plan(
+      const ptl_plan &plan, const options_t &options = options_t()) {
+    auto parser = ptl_parser<type>();
+    return parser.load(plan, options);
+  }
+
+  static std::shared_ptr<const ptl_plan> compile(
+      const std::string &pattern, const options_t &options = options_t()) {
+    auto parser = ptl_parser<type>();
+    return parser.compile(pattern);
+  }
 };
 
 }  // namespace reelay
@@ -0,0 +1,437 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "reelay/networks/discrete_timed_network.hpp"
+#include "reelay/parser/ptl_simplifier.hpp"
+
+namespace reelay {
+
+/*
+ * Table-driven monitor for discrete-time past temporal logic.
+ *
+ * Between two events, a discrete-time network is a finite-state machine
+ * whenever its temporal operators keep finitely many values: unbounded
+ * operators keep a single bit and bounded operators keep the recent values of
+ * their operands within the window. The compiler explores the states reachable
+ * from the initial one under every valuation of the atoms and tabulates the
+ * transition function, so that evaluation is one table lookup per event after
+ * the atoms have been evaluated against the input.
+ *
+ * Compilation fails, and `compile` returns nothing, when the formula has
+ * quantifiers, too many distinct atoms, or when the table would exceed the
+ * given number of entries. Callers then fall back to the network.
+ */
+template<typename T, typename X>
+struct discrete_timed_automaton {
+  using time_t = T;
+  using input_t = X;
+  using output_t = bool;
+
+  using type = discrete_timed_automaton<time_t, input_t>;
+  using network_t = discrete_timed_network<time_t, input_t>;
+
+  // Default bound on the number of table entries (4 bytes each)
+  static constexpr std::size_t default_limit = std::size_t(1) << 20;
+  // Atoms are evaluated into a bitmask that indexes the table
+  static constexpr std::size_t max_width = 16;
+
+  time_t current = -1;
+
+  static std::optional<type> compile(
+    const std::string& pattern, std::size_t limit = default_limit)
+  {
+    return compile(pattern, basic_options(), limit);
+  }
+
+  // Atoms are networks of their own, built with the given options
+  static std::optional<type> compile(
+    const std::string& pattern,
+    const basic_options& options,
+    std::size_t limit = default_limit)
+  {
+    auto root = ptl_simplifier().normalize(pattern);
+    if(root == nullptr) {
+      return std::nullopt;  // Let the network report the syntax error
+    }
+
+    auto automaton = type();
+    auto machine = compiler();
+    if(not machine.flatten(*root, automaton, options)) {
+      return std::nullopt;
+    }
+    if(not machine.explore(automaton, limit)) {
+      return std::nullopt;
+    }
+    return automaton;
+  }
+
+  output_t update(const input_t& args)
+  {
+    current = current + time_t(1);
+    if(settled) {
+      return value;  // Like a pruned network, inputs are no longer read
+    }
+
+    uint32_t mask = 0;
+    for(std::size_t i = 0; i < atoms.size(); i++) {
+      mask |= uint32_t(atoms[i].update(args)) << i;
+    }
+    uint32_t entry = table[(std::size_t(state) << atoms.size()) | mask];
+    state = entry >> 1;
+    value = (entry & 1) != 0;
+    settled = verdicts[state] == int8_t(value);
+    return value;
+  }
+
+  output_t output() const
+  {
+    return value;
+  }
+
+  time_t now() const
+  {
+    return current;
+  }
+
+  // The verdict once it can no longer change, if so
+  std::optional<bool> decided() const
+  {
+    if(not settled) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  // Number of reachable states
+  std::size_t size() const
+  {
+    return verdicts.size();
+  }
+
+  // Number of distinct atoms
+  std::size_t width() const
+  {
+    return atoms.size();
+  }
+
+ private:
+  std::vector<network_t> atoms;
+  // Entries are (next state << 1 | output) indexed by (state << width | mask)
+  std::vector<uint32_t> table;
+  // Per state, 1 (0) if every continuation outputs true (false), else -1
+  std::vector<int8_t> verdicts;
+  uint32_t state = 0;
+  bool value = false;
+  bool settled = false;
+
+  /*
+   * Flattens the formula into instructions in evaluation order and runs them
+   * over explicit operator states. The state of a temporal operator is one
+   * word: a bit for unbounded operators, the age of the most recent witness
+   * for windows starting now, and a shift register of witnesses otherwise.
+   */
+  struct compiler {
+    using expr_t = ptl_expression;
+    using op = ptl_expression::op;
+    using word_t = uint64_t;
+
+    enum class mode : uint8_t { bit, age, shift, sticky };
+
+    struct instruction {
+      op kind;
+      mode form = mode::bit;
+      std::vector<std::size_t> args;
+      std::size_t atom = 0;
+      std::size_t slot = 0;
+      word_t lbound = 0;
+      word_t ubound = 0;
+    };
+
+    std::vector<instruction> program;
+    std::vector<word_t> initial;
+    std::unordered_map<std::string, std::size_t> atom_index;
+
+    bool flatten(
+      const expr_t& root, type& automaton, const basic_options& options)
+    {
+      if(not emit(root)) {
+        return false;
+      }
+      if(atom_index.size() > max_width) {
+        return false;
+      }
+
+      automaton.atoms.resize(atom_index.size());
+      for(const auto& [text, index] : atom_index) {
+        automaton.atoms[index] = network_t::make(text, options);
+      }
+      return true;
+    }
+
+    bool emit(const expr_t& expr)
+    {
+      auto instr = instruction();
+      instr.kind = expr.kind;
+      for(const auto& arg : expr.args) {
+        if(not emit(*arg)) {
+          return false;
+        }
+        instr.args.push_back(program.size() - 1);
+      }
+
+      switch(expr.kind) {
+        case op::atom:
+          instr.atom = atom_index.emplace(expr.text, atom_index.size())
+                         .first->second;
+          break;
+        case op::negation:
+        case op::conjunction:
+        case op::disjunction:
+        case op::implication:
+          break;
+        case op::previous:
+          instr.slot = slot(0);
+          break;
+        case op::once:
+        case op::historically:
+        case op::since:
+          if(not window(expr, instr)) {
+            return false;
+          }
+          break;
+        default:
+          return false;  // Quantifiers and leftover constants
+      }
+
+      program.push_back(instr);
+      return true;
+    }
+
+    std::size_t slot(word_t init)
+    {
+      initial.push_back(init);
+      return initial.size() - 1;
+    }
+
+    bool window(const expr_t& expr, instruction& instr)
+    {
+      if(expr.lbound != std::floor(expr.lbound) or expr.lbound > 62) {
+        return false;
+      }
+      instr.lbound = word_t(expr.lbound);
+
+      if(std::isinf(expr.ubound)) {
+        // Unbounded operators keep one bit, half-bounded ones the witnesses
+        // younger than the lower bound and a sticky bit for the older ones.
+        instr.form = expr.lbound == 0 ? mode::bit : mode::sticky;
+        instr.slot = slot(0);
+        return true;
+      }
+
+      if(expr.ubound != std::floor(expr.ubound) or expr.ubound > 1e9) {
+        return false;
+      }
+      instr.ubound = word_t(expr.ubound);
+      if(instr.lbound == 0) {
+        // Only the youngest witness matters, no witness is encoded as ubound+1
+        instr.form = mode::age;
+        instr.slot = slot(instr.ubound + 1);
+        return true;
+      }
+      if(instr.ubound > 62) {
+        return false;
+      }
+      instr.form = mode::shift;
+      instr.slot = slot(0);
+      return true;
+    }
+
+    // Evaluates the formula on `mask` and updates `next` from `current`
+    bool step(
+      const std::vector<word_t>& current,
+      uint32_t mask,
+      std::vector<word_t>& next,
+      std::vector<char>& values) const
+    {
+      for(std::size_t i = 0; i < program.size(); i++) {
+        const auto& instr = program[i];
+        const auto& args = instr.args;
+        bool result = false;
+        switch(instr.kind) {
+          case op::atom:
+            result = ((mask >> instr.atom) & 1) != 0;
+            break;
+          case op::negation:
+            result = not values[args[0]];
+            break;
+          case op::conjunction:
+            result = true;
+            for(auto j : args) {
+              result = result and values[j];
+            }
+            break;
+          case op::disjunction:
+            result = false;
+            for(auto j : args) {
+              result = result or values[j];
+            }
+            break;
+          case op::implication:
+            result = not values[args[0]] or values[args[1]];
+            break;
+          case op::previous:
+            result = current[instr.slot] != 0;
+            next[instr.slot] = values[args[0]];
+            break;
+          case op::once:
+            result = temporal(instr, current, next, true, values[args[0]]);
+            break;
+          case op::historically:
+            result = not temporal(instr, current, next, true, not values[args[0]]);
+            break;
+          case op::since:
+            result =
+              temporal(instr, current, next, values[args[0]], values[args[1]]);
+            break;
+          default:
+            break;
+        }
+        values[i] = result;
+      }
+      return values.back();
+    }
+
+    // Once is since with a true left operand and historically is the dual of
+    // once, so all three keep the witnesses of a since operator.
+    static bool temporal(
+      const instruction& instr,
+      const std::vector<word_t>& current,
+      std::vector<word_t>& next,
+      bool keep,
+      bool witness)
+    {
+      word_t s = current[instr.slot];
+      word_t& result = next[instr.slot];
+
+      switch(instr.form) {
+        case mode::bit:
+          result = witness or (keep and s != 0);
+          return result != 0;
+        case mode::age: {
+          word_t none = instr.ubound + 1;
+          if(witness) {
+            result = 0;
+          }
+          else if(keep and s < none) {
+            result = s + 1;
+          }
+          else {
+            result = none;
+          }
+          return result < none;
+        }
+        case mode::shift: {
+          word_t bits = (word_t(1) << (instr.ubound + 1)) - 1;
+          result = ((keep ? s << 1 : 0) | word_t(witness)) & bits;
+          return (result >> instr.lbound) != 0;
+        }
+        case mode::sticky: {
+          word_t old = word_t(1) << instr.lbound;
+          word_t bits = (old << 1) - 1;
+          result = (keep ? (s << 1) | (s & old) : 0) | word_t(witness);
+          result = result & bits;
+          return (result & old) != 0;
+        }
+      }
+      return false;
+    }
+
+    bool explore(type& automaton, std::size_t limit)
+    {
+      const std::size_t width = atom_index.size();
+      const std::size_t masks = std::size_t(1) << width;
+
+      std::map<std::vector<word_t>, uint32_t> index;
+      std::deque<std::vector<word_t>> queue;
+      index.emplace(initial, 0);
+      queue.push_back(initial);
+
+      auto next = initial;
+      auto values = std::vector<char>(program.size());
+
+      for(std::size_t id = 0; not queue.empty(); id++) {
+        if((id + 1) * masks > limit) {
+          return false;
+        }
+        auto current = std::move(queue.front());
+        queue.pop_front();
+
+        for(uint32_t mask = 0; mask < masks; mask++) {
+          bool output = step(current, mask, next, values);
+          auto [it, inserted] = index.emplace(next, uint32_t(index.size()));
+          if(inserted) {
+            queue.push_back(next);
+          }
+          automaton.table.push_back((it->second << 1) | uint32_t(output));
+        }
+      }
+
+      automaton.verdicts = verdicts(automaton.table, index.size(), masks);
+      return true;
+    }
+
+    // Greatest fixpoint of states whose every continuation outputs the same
+    static std::vector<int8_t> verdicts(
+      const std::vector<uint32_t>& table, std::size_t size, std::size_t masks)
+    {
+      auto result = std::vector<int8_t>(size, -1);
+      for(std::size_t s = 0; s < size; s++) {
+        int8_t first = int8_t(table[s * masks] & 1);
+        result[s] = first;
+        for(std::size_t m = 0; m < masks; m++) {
+          if(int8_t(table[s * masks + m] & 1) != first) {
+            result[s] = -1;
+            break;
+          }
+        }
+      }
+
+      bool changed = true;
+      while(changed) {
+        changed = false;
+        for(std::size_t s = 0; s < size; s++) {
+          if(result[s] < 0) {
+            continue;
+          }
+          for(std::size_t m = 0; m < masks; m++) {
+            if(result[table[s * masks + m] >> 1] != result[s]) {
+              result[s] = -1;
+              changed = true;
+              break;
+            }
+          }
+        }
+      }
+      return result;
+    }
+  };
+};
+
+}  // namespace reelay
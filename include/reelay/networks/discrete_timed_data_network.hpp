@@ -41,6 +41,8 @@ struct discrete_timed_data_network
   using setting_t = discrete_timed_data_setting::factory<input_t, time_t>;
   using options_t = basic_options;
 
+  static constexpr auto setting_name = "discrete_timed_data";
+
   data_mgr_t manager;
   node_ptr_t root;
   std::vector<state_ptr_t> states;
@@ -99,5 +101,23 @@ struct discrete_timed_data_network
     return parser.make_shared(pattern, options);
   }
 
+  static type from_plan(
+      const ptl_plan &plan, const options_t &options = options_t()) {
+    auto manager = options.get_data_manager();
+    kwargs kw = {{"manager", manager}};
+
+    auto parser = ptl_parser<type>(kw);
+    return parser.load(plan, options);
+  }
+
+  static std::shared_ptr<const ptl_plan> compile(
+      const std::string &pattern, const options_t &options = options_t()) {
+    auto manager = options.get_data_manager();
+    kwargs kw = {{"manager", manager}};
+
+    auto parser = ptl_parser<type>(kw);
+    return parser.compile(pattern);
+  }
+
 };
 }  // namespace reelay
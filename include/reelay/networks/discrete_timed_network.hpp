@@ -10,6 +10,7 @@
 
 #include "functional"
 #include "memory"
+#include "optional"
 #include "string"
 //
 #include "reelay/intervals.hpp"
@@ -40,6 +41,8 @@ struct discrete_timed_network : public discrete_timed_state<X, bool, T> {
   using setting_t = discrete_timed_setting::factory<input_t, time_t>;
   using options_t = basic_options;
 
+  static constexpr auto setting_name = "discrete_timed";
+
   node_ptr_t root;
   std::vector<state_ptr_t> states;
 
@@ -59,13 +62,30 @@ struct discrete_timed_network : public discrete_timed_state<X, bool, T> {
   time_t now() const { return current; }
 
   void update(const input_t& args, time_t tn) override {
+    bool pruning = false;
     for (const auto& state : this->states) {
       state->update(args, tn);
+      pruning = pruning or state->decided();
+    }
+    if (pruning) {
+      prune();
     }
   }
 
   output_t output(time_t tn) override { return root->output(tn); }
 
+  // The verdict once it can no longer change, if so. Readers may stop there.
+  std::optional<bool> decided() const override { return root->decided(); }
+
+  // Retires decided subformulas. Nothing is updated after the root decides.
+  void prune() {
+    if (root->decided()) {
+      this->states.clear();
+      return;
+    }
+    prune_states(this->states);
+  }
+
   output_t update(const input_t& args) {
     current = current + time_t(1);
     this->update(args, current);
@@ -76,15 +96,35 @@ struct discrete_timed_network : public discrete_timed_state<X, bool, T> {
 
   static type make(const std::string& pattern,
                    const options_t& options = options_t()) {
-    auto parser = ptl_parser<type>();
+    auto parser = ptl_parser<type>(settings(options));
     return parser.parse(pattern, options);
   }
 
   static std::shared_ptr<type> make_shared(
       const std::string& pattern, const options_t& options = options_t()) {
-    auto parser = ptl_parser<type>();
+    auto parser = ptl_parser<type>(settings(options));
     return parser.make_shared(pattern, options);
   }
+
+  static kwargs settings(const options_t& options) {
+    kwargs kw;
+    if (options.is_adaptive_ordering()) {
+      kw["adaptive"] = true;
+    }
+    return kw;
+  }
+
+  static type from_plan(
+      const ptl_plan& plan, const options_t& options = options_t()) {
+    auto parser = ptl_parser<type>(settings(options));
+    return parser.load(plan, options);
+  }
+
+  static std::shared_ptr<const ptl_plan> compile(
+      const std::string& pattern, const options_t& options = options_t()) {
+    auto parser = ptl_parser<type>(settings(options));
+    return parser.compile(pattern);
+  }
 };
 
 }  // namespace reelay
@@ -0,0 +1,483 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "reelay/concurrency/spsc_queue.hpp"
+#include "reelay/networks/basic_structure.hpp"
+#include "reelay/networks/discrete_timed_network.hpp"
+#include "reelay/parser/ptl_plan.hpp"
+//
+#include "reelay/options.hpp"
+
+namespace reelay {
+
+struct parallel_options {
+  std::size_t threads = 2;        // worker threads, at most one per lane
+  std::size_t batch_size = 4096;  // events per batch
+  std::size_t depth = 4;          // batches in flight
+};
+
+/*
+ * Evaluates a discrete timed specification over several threads.
+ *
+ * The network is split below its top-level boolean connectives into lanes,
+ * the subtrees that share no node with each other. Lanes are distributed
+ * over worker threads, each of which updates its lanes over a batch of
+ * events and records their outputs per event. The calling thread then
+ * replays the connectives over the recorded outputs in event order while the
+ * workers run ahead on the following batches, so verdicts are exactly those
+ * of discrete_timed_network. Batches are handed over through SPSC queues.
+ *
+ * Pipelining pays off for wide specifications, e.g. a conjunction of many
+ * temporal properties; a single event still crosses every thread, so use
+ * the range overload of `update` whenever events arrive together. Idle
+ * workers park on their job queues between calls.
+ *
+ * An exception thrown while updating a lane, e.g. by reading a field of the
+ * wrong type, is kept with its batch and rethrown by `update` once the
+ * batches in flight are drained. By then workers may have updated their
+ * lanes past the failing event, so unlike discrete_timed_network the network
+ * is unusable afterwards and any further `update` throws std::logic_error.
+ */
+template <typename T, typename X>
+struct discrete_timed_parallel_network {
+  using time_t = T;
+  using value_t = bool;
+  using input_t = X;
+  using output_t = bool;
+
+  using type = discrete_timed_parallel_network<time_t, input_t>;
+  using network_t = discrete_timed_network<time_t, input_t>;
+
+  using node_t = typename network_t::node_t;
+  using state_t = typename network_t::state_t;
+  using node_ptr_t = typename network_t::node_ptr_t;
+  using state_ptr_t = typename network_t::state_ptr_t;
+
+  using options_t = basic_options;
+
+  discrete_timed_parallel_network() = default;
+
+  discrete_timed_parallel_network(const ptl_plan &plan,
+                                  const options_t &options,
+                                  const parallel_options &parallel)
+      : engine(std::make_unique<pipeline>(plan, options, parallel)) {}
+
+  time_t now() const { return engine->current; }
+
+  output_t output() const { return engine->value; }
+
+  // The verdict once it can no longer change, if so. Readers may stop there.
+  std::optional<bool> decided() const { return engine->root->decided(); }
+
+  // Number of lanes and of worker threads
+  std::size_t lanes() const { return engine->proxies.size(); }
+  std::size_t threads() const { return engine->workers.size(); }
+
+  output_t update(const input_t &args) {
+    update(&args, &args + 1, [](time_t, bool) {});
+    return output();
+  }
+
+  // Calls `sink(time, value)` for every event in order. Events must stay
+  // valid until the call returns.
+  template <typename InputIt, typename SinkT>
+  void update(InputIt first, InputIt last, SinkT &&sink) {
+    engine->run(first, last, sink);
+  }
+
+  static type make(const std::string &pattern,
+                   const options_t &options = options_t(),
+                   const parallel_options &parallel = parallel_options()) {
+    return type(*network_t::compile(pattern, options), options, parallel);
+  }
+
+  static type from_plan(const ptl_plan &plan,
+                        const options_t &options = options_t(),
+                        const parallel_options &parallel = parallel_options()) {
+    if (plan.setting != network_t::setting_name) {
+      throw std::invalid_argument("Plan recorded for another setting: " +
+                                  plan.setting);
+    }
+    return type(plan, options, parallel);
+  }
+
+ private:
+  // Output of a lane for the event being replayed
+  struct lane_node final : public discrete_timed_node<bool, time_t> {
+    bool value = false;
+    std::optional<bool> settled;
+
+    bool output(time_t) override { return value; }
+    std::optional<bool> decided() const override { return settled; }
+  };
+
+  // Outputs of the lanes of one worker over one batch
+  struct batch_record {
+    std::vector<std::vector<char>> outputs;  // per lane, per event
+    std::vector<std::optional<bool>> settled;
+  };
+
+  struct job {
+    std::size_t slot = 0;
+    const std::function<void(std::size_t)> *run = nullptr;
+  };
+
+  struct worker {
+    std::vector<state_ptr_t> states;
+    std::vector<node_ptr_t> roots;     // of the lanes, in lane order
+    std::vector<std::size_t> lanes;    // global indices of the lanes
+    std::vector<batch_record> records;  // per slot
+    std::vector<std::exception_ptr> errors;  // per slot
+    spsc_queue<job> jobs;
+    spsc_queue<std::size_t> done;
+    std::thread thread;
+
+    explicit worker(std::size_t depth) : jobs(depth), done(depth) {}
+
+    template <typename InputIt>
+    void process(InputIt first, std::size_t slot, time_t start,
+                 std::size_t count) {
+      auto &record = records[slot];
+      auto it = first;  // Rows may refer into the iterator itself
+      for (std::size_t i = 0; i < count; i++, ++it) {
+        const input_t &args = *it;
+        bool pruning = false;
+        for (const auto &state : states) {
+          state->update(args, start + time_t(i));
+          pruning = pruning or state->decided();
+        }
+        for (std::size_t k = 0; k < roots.size(); k++) {
+          record.outputs[k][i] = roots[k]->output(start + time_t(i));
+        }
+        if (pruning) {
+          prune();
+        }
+      }
+      for (std::size_t k = 0; k < roots.size(); k++) {
+        record.settled[k] = roots[k]->decided();
+      }
+    }
+
+    // Nothing is updated once all lanes of the worker decide
+    void prune() {
+      auto settled = std::all_of(roots.begin(), roots.end(),
+                                 [](const node_ptr_t &root) {
+                                   return root->decided().has_value();
+                                 });
+      if (settled) {
+        states.clear();
+        return;
+      }
+      prune_states(states);
+    }
+
+    void loop() {
+      for (;;) {
+        job next = jobs.pop();
+        if (next.run == nullptr) {
+          return;
+        }
+        try {
+          (*next.run)(next.slot);
+        } catch (...) {
+          errors[next.slot] = std::current_exception();
+        }
+        done.push(next.slot);
+      }
+    }
+  };
+
+  struct pipeline {
+    std::vector<std::unique_ptr<worker>> workers;
+    std::vector<std::shared_ptr<lane_node>> proxies;
+    node_ptr_t root;
+    std::size_t batch_size;
+    std::size_t depth;
+    time_t current = -1;
+    bool value = false;
+    std::atomic<bool> settled = false;  // workers skip batches once set
+    std::atomic<bool> failed = false;   // likewise, once a lane throws
+
+    pipeline(const ptl_plan &plan, const options_t &options,
+             const parallel_options &parallel)
+        : batch_size(std::max<std::size_t>(parallel.batch_size, 1)),
+          depth(std::max<std::size_t>(parallel.depth, 2)) {
+      auto parser = ptl_parser<network_t>(network_t::settings(options));
+      const auto &steps = plan.steps;
+
+      // Top-level connectives are expanded, their other operands are lanes
+      auto top = std::vector<bool>(steps.size(), false);
+      auto lanes = std::vector<std::size_t>();
+      auto pending = std::vector<std::size_t>{plan.root};
+      while (not pending.empty()) {
+        auto i = pending.back();
+        pending.pop_back();
+        const auto &step = steps[i];
+        if (top[i] or std::find(lanes.begin(), lanes.end(), i) != lanes.end()) {
+          continue;
+        }
+        if (step.is_state or step.nested) {
+          lanes.push_back(i);
+        } else {
+          top[i] = true;
+          pending.insert(pending.end(), step.args.begin(), step.args.end());
+        }
+      }
+      std::sort(lanes.begin(), lanes.end());
+
+      // Lanes reaching a common step are evaluated together
+      auto group = std::vector<std::size_t>(steps.size(), steps.size());
+      auto parent = std::vector<std::size_t>(lanes.size());
+      std::iota(parent.begin(), parent.end(), 0);
+      auto find = [&parent](std::size_t k) {
+        while (parent[k] != k) {
+          k = parent[k] = parent[parent[k]];
+        }
+        return k;
+      };
+      for (std::size_t k = 0; k < lanes.size(); k++) {
+        group[lanes[k]] = k;
+      }
+      for (auto i = steps.size(); i-- > 0;) {
+        if (group[i] == steps.size()) {
+          continue;
+        }
+        for (auto arg : steps[i].args) {
+          if (group[arg] == steps.size()) {
+            group[arg] = group[i];
+          } else {
+            parent[find(group[arg])] = find(group[i]);
+          }
+        }
+      }
+
+      // Groups go to the least loaded worker, largest first
+      auto weights = std::vector<std::size_t>(lanes.size(), 0);
+      for (auto i : plan.states) {
+        if (group[i] != steps.size()) {
+          weights[find(group[i])]++;
+        }
+      }
+      auto groups = std::vector<std::size_t>();
+      for (std::size_t k = 0; k < lanes.size(); k++) {
+        if (find(k) == k) {
+          groups.push_back(k);
+        }
+      }
+      std::stable_sort(groups.begin(), groups.end(),
+                       [&weights](std::size_t a, std::size_t b) {
+                         return weights[a] > weights[b];
+                       });
+      auto count = std::min(std::max<std::size_t>(parallel.threads, 1),
+                            std::max<std::size_t>(groups.size(), 1));
+      auto owner = std::vector<std::size_t>(lanes.size(), 0);
+      auto loads = std::vector<std::size_t>(count, 0);
+      for (auto g : groups) {
+        auto w = std::size_t(
+            std::min_element(loads.begin(), loads.end()) - loads.begin());
+        owner[g] = w;
+        loads[w] += weights[g] + 1;
+      }
+
+      // Workers replay the steps of their lanes only
+      for (std::size_t w = 0; w < count; w++) {
+        auto unit = std::make_unique<worker>(depth);
+        auto mapping = std::vector<std::size_t>(steps.size(), steps.size());
+        auto recipe = std::vector<ptl_plan::step>();
+        for (std::size_t i = 0; i < steps.size(); i++) {
+          if (group[i] != steps.size() and owner[find(group[i])] == w) {
+            mapping[i] = recipe.size();
+            recipe.push_back(steps[i]);
+            for (auto &arg : recipe.back().args) {
+              arg = mapping[arg];
+            }
+          }
+        }
+        auto nodes = parser.replay(recipe);
+        for (auto i : plan.states) {
+          if (mapping[i] != steps.size()) {
+            unit->states.push_back(
+                std::static_pointer_cast<state_t>(nodes[mapping[i]]));
+          }
+        }
+        for (std::size_t k = 0; k < lanes.size(); k++) {
+          if (mapping[lanes[k]] != steps.size()) {
+            unit->roots.push_back(nodes[mapping[lanes[k]]]);
+            unit->lanes.push_back(k);
+          }
+        }
+        unit->records.resize(depth);
+        unit->errors.resize(depth);
+        for (auto &record : unit->records) {
+          record.outputs.assign(unit->roots.size(),
+                                std::vector<char>(batch_size, 0));
+          record.settled.assign(unit->roots.size(), std::nullopt);
+        }
+        workers.push_back(std::move(unit));
+      }
+
+      // The calling thread replays the connectives over lane outputs
+      auto mapping = std::vector<std::size_t>(steps.size(), steps.size());
+      auto recipe = std::vector<ptl_plan::step>();
+      auto given = std::vector<node_ptr_t>();
+      for (std::size_t i = 0; i < steps.size(); i++) {
+        if (top[i] or std::binary_search(lanes.begin(), lanes.end(), i)) {
+          mapping[i] = recipe.size();
+          recipe.push_back(steps[i]);
+          for (auto &arg : recipe.back().args) {
+            arg = mapping[arg];
+          }
+          given.push_back(nullptr);
+        }
+      }
+      for (std::size_t k = 0; k < lanes.size(); k++) {
+        proxies.push_back(std::make_shared<lane_node>());
+        given[mapping[lanes[k]]] = proxies.back();
+      }
+      root = parser.replay(recipe, given).at(mapping[plan.root]);
+
+      for (auto &unit : workers) {
+        unit->thread = std::thread(&worker::loop, unit.get());
+      }
+    }
+
+    ~pipeline() {
+      for (auto &unit : workers) {
+        unit->jobs.push(job());
+      }
+      for (auto &unit : workers) {
+        unit->thread.join();
+      }
+    }
+
+    pipeline(const pipeline &) = delete;
+    pipeline &operator=(const pipeline &) = delete;
+
+    template <typename InputIt, typename SinkT>
+    void run(InputIt first, InputIt last, SinkT &sink) {
+      if (failed.load(std::memory_order_relaxed)) {
+        throw std::logic_error("Parallel network stopped by an earlier error");
+      }
+      auto total = std::size_t(std::distance(first, last));
+      auto batches = (total + batch_size - 1) / batch_size;
+      time_t origin = current + time_t(1);
+
+      // Workers run these over the events of the batch in `slot`
+      auto tasks = std::vector<std::function<void(std::size_t)>>();
+      auto starts = std::vector<std::size_t>(depth, 0);
+      for (auto &unit : workers) {
+        tasks.emplace_back([this, worker = unit.get(), first, origin, total,
+                            &starts](std::size_t slot) {
+          if (settled.load(std::memory_order_acquire) or
+              failed.load(std::memory_order_acquire)) {
+            return;
+          }
+          auto offset = starts[slot];
+          auto n = std::min(batch_size, total - offset);
+          worker->process(first + offset, slot, origin + time_t(offset), n);
+        });
+      }
+
+      std::size_t issued = 0;
+      auto issue = [&]() {
+        auto slot = issued % depth;
+        starts[slot] = issued * batch_size;
+        for (std::size_t w = 0; w < workers.size(); w++) {
+          workers[w]->jobs.push(job{slot, &tasks[w]});
+        }
+        issued++;
+      };
+
+      // Batches in flight refer to `tasks`, so they finish before a throw
+      std::size_t received = 0;
+      try {
+        while (issued < std::min(batches, depth)) {
+          issue();
+        }
+        for (std::size_t b = 0; b < batches; b++) {
+          auto slot = b % depth;
+          auto offset = b * batch_size;
+          auto n = std::min(batch_size, total - offset);
+          for (auto &unit : workers) {
+            unit->done.pop();
+          }
+          received++;
+          for (auto &unit : workers) {
+            if (auto error = std::exchange(unit->errors[slot], nullptr)) {
+              std::rethrow_exception(error);
+            }
+          }
+          combine(slot, n, sink);
+          if (issued < batches) {
+            issue();
+          }
+        }
+      } catch (...) {
+        failed.store(true, std::memory_order_release);
+        for (; received < issued; received++) {
+          for (auto &unit : workers) {
+            unit->done.pop();
+          }
+        }
+        throw;
+      }
+    }
+
+    template <typename SinkT>
+    void combine(std::size_t slot, std::size_t count, SinkT &sink) {
+      if (settled.load(std::memory_order_relaxed)) {
+        for (std::size_t i = 0; i < count; i++) {
+          current = current + time_t(1);
+          sink(current, value);
+        }
+        return;
+      }
+      for (std::size_t i = 0; i < count; i++) {
+        current = current + time_t(1);
+        for (auto &unit : workers) {
+          const auto &record = unit->records[slot];
+          for (std::size_t k = 0; k < unit->lanes.size(); k++) {
+            proxies[unit->lanes[k]]->value = record.outputs[k][i] != 0;
+          }
+        }
+        value = root->output(current);
+        sink(current, value);
+      }
+      for (auto &unit : workers) {
+        const auto &record = unit->records[slot];
+        for (std::size_t k = 0; k < unit->lanes.size(); k++) {
+          proxies[unit->lanes[k]]->settled = record.settled[k];
+        }
+      }
+      if (auto verdict = root->decided()) {
+        value = *verdict;
+        settled.store(true, std::memory_order_release);
+      }
+    }
+  };
+
+  std::unique_ptr<pipeline> engine;
+};
+
+}  // namespace reelay
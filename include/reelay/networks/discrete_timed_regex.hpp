@@ -0,0 +1,521 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "reelay/networks/discrete_timed_network.hpp"
+#include "reelay/parser/ptl_simplifier.hpp"
+#include "reelay/parser/regex.hpp"
+
+namespace reelay {
+
+/*
+ * Monitor for regular expressions over discrete-time inputs.
+ *
+ * The output at each time point is true if and only if a segment of the input
+ * ending there matches the expression, so a nullable expression always holds.
+ *
+ * The expression is compiled into its Glushkov automaton, whose states are the
+ * positions of letters in the expression, and simulated bit-parallel: the set
+ * of active positions is a bitset of 64 positions per word. Every position is
+ * entered by the same letter, so an update is the union of the follow sets of
+ * active positions, read from tables indexed by bytes of the bitset, masked
+ * by the positions whose letters hold now. Repetitions of a single letter are
+ * one position with a counter rather than copies of the letter. Letters are
+ * evaluated by discrete-time networks, one per distinct letter.
+ */
+template<typename T, typename X>
+struct discrete_timed_regex {
+  using time_t = T;
+  using input_t = X;
+  using output_t = bool;
+
+  using type = discrete_timed_regex<time_t, input_t>;
+  using network_t = discrete_timed_network<time_t, input_t>;
+  using expr_t = regex_expression;
+
+  // Positions after unrolling repetitions and intersecting expressions
+  static constexpr std::size_t max_positions = 1024;
+
+  time_t current = -1;
+
+  static type make(const std::string& pattern)
+  {
+    auto root = regex_parser().parse(pattern);
+    auto fragment = compiler().compile(*root, true);
+    return type(fragment);
+  }
+
+  output_t update(const input_t& args)
+  {
+    current = current + time_t(1);
+
+    mask = anything;
+    for(std::size_t i = 0; i < letters.size(); i++) {
+      values[i] = letters[i].update(args);
+      if(values[i]) {
+        const word_t* bits = &masks[i * words];
+        for(std::size_t w = 0; w < words; w++) {
+          mask[w] |= bits[w];
+        }
+      }
+    }
+
+    // Matches may start at any time point, so first positions are reachable
+    reach = first;
+    for(std::size_t k = 0; k < chunks; k++) {
+      auto byte = (state[k / 8] >> (8 * (k % 8))) & 0xff;
+      if(byte != 0) {
+        const word_t* bits = &table[(k * 256 + byte) * words];
+        for(std::size_t w = 0; w < words; w++) {
+          reach[w] |= bits[w];
+        }
+      }
+    }
+
+    bool matched = nullable;
+    for(std::size_t w = 0; w < words; w++) {
+      state[w] = reach[w] & mask[w];
+    }
+    for(auto& c : counters) {
+      count(c);
+    }
+    for(std::size_t w = 0; w < words; w++) {
+      matched = matched or (state[w] & last[w]) != 0;
+    }
+    value = matched;
+    return value;
+  }
+
+  output_t output() const
+  {
+    return value;
+  }
+
+  time_t now() const
+  {
+    return current;
+  }
+
+  // The verdict once it can no longer change, if so
+  std::optional<bool> decided() const
+  {
+    if(nullable) {
+      return true;
+    }
+    return std::nullopt;
+  }
+
+  // Number of positions of the automaton
+  std::size_t size() const
+  {
+    return positions;
+  }
+
+  // Number of distinct letters
+  std::size_t width() const
+  {
+    return letters.size();
+  }
+
+ private:
+  using word_t = uint64_t;
+
+  /*
+   * A position entered by a run of its letter and active while the run since
+   * some entry is between `lbound` and `ubound` events long. Entries are kept
+   * in order until the run breaks or they grow out of the bounds.
+   */
+  struct counter {
+    std::size_t position;
+    std::size_t letter;  // npos for `{*}`
+    uint64_t lbound;
+    uint64_t ubound;
+    std::deque<time_t> entries;
+  };
+
+  struct position {
+    std::string letter;
+    bool counted = false;
+    uint64_t lbound = 1;
+    uint64_t ubound = 1;
+  };
+
+  // Glushkov automaton of a subexpression with local positions
+  struct fragment {
+    std::vector<position> positions;
+    std::vector<std::vector<std::size_t>> follow;
+    std::vector<std::size_t> first;
+    std::vector<std::size_t> last;
+    bool nullable = false;
+  };
+
+  std::size_t positions = 0;
+  std::size_t words = 1;
+  std::size_t chunks = 0;
+
+  std::vector<network_t> letters;
+  std::vector<char> values;
+  std::vector<word_t> masks;  // positions of each letter, `words` each
+  std::vector<word_t> anything;
+  std::vector<word_t> first;
+  std::vector<word_t> last;
+  std::vector<word_t> table;  // follow sets per byte value of each chunk
+  std::vector<counter> counters;
+
+  std::vector<word_t> state;
+  std::vector<word_t> reach;
+  std::vector<word_t> mask;
+  bool nullable = false;
+  bool value = false;
+
+  explicit discrete_timed_regex(const fragment& automaton)
+      : positions(automaton.positions.size()),
+        words(std::max<std::size_t>(1, (positions + 63) / 64)),
+        chunks((positions + 7) / 8),
+        anything(words),
+        first(words),
+        last(words),
+        table(chunks * 256 * words),
+        state(words),
+        reach(words),
+        mask(words),
+        nullable(automaton.nullable)
+  {
+    auto index = std::unordered_map<std::string, std::size_t>();
+    for(std::size_t i = 0; i < positions; i++) {
+      const auto& pos = automaton.positions[i];
+
+      // Letters folding to a constant have no network, and positions whose
+      // letter never holds are never entered
+      auto constant = ptl_simplifier().evaluate(pos.letter);
+      if(constant == false) {
+        continue;
+      }
+
+      std::size_t letter = std::string::npos;
+      if(not constant) {
+        auto [it, inserted] = index.emplace(pos.letter, letters.size());
+        if(inserted) {
+          letters.push_back(network_t::make(pos.letter));
+          masks.resize(masks.size() + words);
+        }
+        letter = it->second;
+      }
+
+      if(pos.counted) {
+        counters.push_back(counter{i, letter, pos.lbound, pos.ubound, {}});
+      }
+      else if(letter == std::string::npos) {
+        set(anything.data(), i);
+      }
+      else {
+        set(&masks[letter * words], i);
+      }
+    }
+    values.resize(letters.size());
+
+    for(auto i : automaton.first) {
+      set(first.data(), i);
+    }
+    for(auto i : automaton.last) {
+      set(last.data(), i);
+    }
+
+    // Each entry extends the entry without its lowest bit by one follow set
+    for(std::size_t k = 0; k < chunks; k++) {
+      for(std::size_t byte = 1; byte < 256; byte++) {
+        auto low = std::size_t(__builtin_ctzll(byte));
+        word_t* entry = &table[(k * 256 + byte) * words];
+        const word_t* rest = &table[(k * 256 + (byte & (byte - 1))) * words];
+        std::copy(rest, rest + words, entry);
+        if(k * 8 + low < positions) {
+          for(auto j : automaton.follow[k * 8 + low]) {
+            set(entry, j);
+          }
+        }
+      }
+    }
+  }
+
+  static void set(word_t* bits, std::size_t i)
+  {
+    bits[i / 64] |= word_t(1) << (i % 64);
+  }
+
+  bool test(const std::vector<word_t>& bits, std::size_t i) const
+  {
+    return ((bits[i / 64] >> (i % 64)) & 1) != 0;
+  }
+
+  void count(counter& c)
+  {
+    bool holds = c.letter == std::string::npos or values[c.letter];
+    if(not holds) {
+      c.entries.clear();
+    }
+    else if(test(reach, c.position)) {
+      // The oldest entry is all that matters without an upper bound
+      if(c.ubound != expr_t::unbounded or c.entries.empty()) {
+        c.entries.push_back(current);
+      }
+    }
+    while(not c.entries.empty() and
+          uint64_t(current - c.entries.front()) + 1 > c.ubound) {
+      c.entries.pop_front();
+    }
+
+    auto bit = word_t(1) << (c.position % 64);
+    if(not c.entries.empty() and
+       uint64_t(current - c.entries.front()) + 1 >= c.lbound) {
+      state[c.position / 64] |= bit;
+    }
+    else {
+      state[c.position / 64] &= ~bit;
+    }
+  }
+
+  /*
+   * Builds Glushkov automata bottom-up. Repetitions of other expressions are
+   * unrolled into copies, and intersections are products of the automata of
+   * their operands whose letters are the conjunctions of the pairs.
+   */
+  struct compiler {
+    using op = regex_expression::op;
+
+    fragment compile(const expr_t& expr, bool counting)
+    {
+      switch(expr.kind) {
+        case op::letter:
+          return letter(expr.text);
+        case op::concatenation: {
+          auto result = compile(*expr.args[0], counting);
+          for(std::size_t i = 1; i < expr.args.size(); i++) {
+            result = concatenate(result, compile(*expr.args[i], counting));
+          }
+          return result;
+        }
+        case op::alternation: {
+          auto result = compile(*expr.args[0], counting);
+          for(std::size_t i = 1; i < expr.args.size(); i++) {
+            result = alternate(result, compile(*expr.args[i], counting));
+          }
+          return result;
+        }
+        case op::intersection: {
+          // Products need plain positions on both sides
+          auto result = compile(*expr.args[0], false);
+          for(std::size_t i = 1; i < expr.args.size(); i++) {
+            result = intersect(result, compile(*expr.args[i], false));
+          }
+          return result;
+        }
+        case op::star:
+          return star(compile(*expr.args[0], counting), true);
+        case op::plus:
+          return star(compile(*expr.args[0], counting), false);
+        case op::option: {
+          auto result = compile(*expr.args[0], counting);
+          result.nullable = true;
+          return result;
+        }
+        case op::repetition:
+          return repeat(expr, counting);
+      }
+      throw std::logic_error("Unknown regular expression operator");
+    }
+
+    static void check(std::size_t size)
+    {
+      if(size > max_positions) {
+        throw std::invalid_argument(
+          "Regular expression exceeds " + std::to_string(max_positions) +
+          " positions");
+      }
+    }
+
+    static fragment empty()
+    {
+      auto result = fragment();
+      result.nullable = true;
+      return result;
+    }
+
+    static fragment letter(const std::string& text)
+    {
+      auto result = fragment();
+      result.positions.push_back(position{text});
+      result.follow.resize(1);
+      result.first = {0};
+      result.last = {0};
+      return result;
+    }
+
+    // Appends the positions of `b` to those of `a`, returning their offset
+    static std::size_t append(fragment& a, const fragment& b)
+    {
+      auto offset = a.positions.size();
+      check(offset + b.positions.size());
+      a.positions.insert(a.positions.end(), b.positions.begin(), b.positions.end());
+      for(const auto& follow : b.follow) {
+        a.follow.push_back(shift(follow, offset));
+      }
+      return offset;
+    }
+
+    static std::vector<std::size_t> shift(
+      const std::vector<std::size_t>& xs, std::size_t offset)
+    {
+      auto result = xs;
+      for(auto& x : result) {
+        x += offset;
+      }
+      return result;
+    }
+
+    static void unite(
+      std::vector<std::size_t>& xs, const std::vector<std::size_t>& ys)
+    {
+      xs.insert(xs.end(), ys.begin(), ys.end());
+      std::sort(xs.begin(), xs.end());
+      xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+    }
+
+    static fragment concatenate(fragment a, const fragment& b)
+    {
+      auto lasts = a.last;
+      auto offset = append(a, b);
+      auto firsts = shift(b.first, offset);
+      for(auto i : lasts) {
+        unite(a.follow[i], firsts);
+      }
+      if(a.nullable) {
+        unite(a.first, firsts);
+      }
+      auto result_last = shift(b.last, offset);
+      if(b.nullable) {
+        unite(result_last, lasts);
+      }
+      a.last = result_last;
+      a.nullable = a.nullable and b.nullable;
+      return a;
+    }
+
+    static fragment alternate(fragment a, const fragment& b)
+    {
+      auto offset = append(a, b);
+      unite(a.first, shift(b.first, offset));
+      unite(a.last, shift(b.last, offset));
+      a.nullable = a.nullable or b.nullable;
+      return a;
+    }
+
+    static fragment star(fragment a, bool nullable)
+    {
+      for(auto i : a.last) {
+        unite(a.follow[i], a.first);
+      }
+      a.nullable = a.nullable or nullable;
+      return a;
+    }
+
+    static fragment intersect(const fragment& a, const fragment& b)
+    {
+      auto nb = b.positions.size();
+      check(a.positions.size() * nb);
+
+      auto result = fragment();
+      for(const auto& x : a.positions) {
+        for(const auto& y : b.positions) {
+          result.positions.push_back(position{conjoin(x.letter, y.letter)});
+        }
+      }
+      result.follow.resize(result.positions.size());
+      for(std::size_t i = 0; i < a.positions.size(); i++) {
+        for(std::size_t j = 0; j < nb; j++) {
+          for(auto k : a.follow[i]) {
+            for(auto l : b.follow[j]) {
+              result.follow[i * nb + j].push_back(k * nb + l);
+            }
+          }
+          std::sort(
+            result.follow[i * nb + j].begin(), result.follow[i * nb + j].end());
+        }
+      }
+      for(auto i : a.first) {
+        for(auto j : b.first) {
+          result.first.push_back(i * nb + j);
+        }
+      }
+      for(auto i : a.last) {
+        for(auto j : b.last) {
+          result.last.push_back(i * nb + j);
+        }
+      }
+      std::sort(result.first.begin(), result.first.end());
+      std::sort(result.last.begin(), result.last.end());
+      result.nullable = a.nullable and b.nullable;
+      return result;
+    }
+
+    static std::string conjoin(const std::string& x, const std::string& y)
+    {
+      if(x == "true" or x == y) {
+        return y;
+      }
+      if(y == "true") {
+        return x;
+      }
+      return "(" + x + ") and (" + y + ")";
+    }
+
+    fragment repeat(const expr_t& expr, bool counting)
+    {
+      const auto& body = *expr.args[0];
+      if(expr.ubound == 0) {
+        return empty();
+      }
+
+      if(counting and body.kind == op::letter) {
+        auto result = letter(body.text);
+        result.positions[0].counted = true;
+        result.positions[0].lbound = std::max<uint64_t>(1, expr.lbound);
+        result.positions[0].ubound = expr.ubound;
+        result.nullable = expr.lbound == 0;
+        return result;
+      }
+
+      // e[m:n] is m copies of e followed by n - m nested options
+      auto result = empty();
+      for(uint64_t i = 0; i < expr.lbound; i++) {
+        result = concatenate(result, compile(body, counting));
+      }
+      if(expr.ubound == expr_t::unbounded) {
+        return concatenate(result, star(compile(body, counting), true));
+      }
+      auto tail = empty();
+      for(uint64_t i = expr.lbound; i < expr.ubound; i++) {
+        tail = concatenate(compile(body, counting), tail);
+        tail.nullable = true;
+      }
+      return concatenate(result, tail);
+    }
+  };
+};
+
+}  // namespace reelay
@@ -41,6 +41,8 @@ struct discrete_timed_robustness_network
       = discrete_timed_robustness_setting::factory<input_t, value_t, time_t>;
   using options_t = basic_options;
 
+  static constexpr auto setting_name = "discrete_timed_robustness";
+
   node_ptr_t root;
   std::vector<state_ptr_t> states;
 
@@ -86,6 +88,18 @@ struct discrete_timed_robustness_network
     auto parser = ptl_parser<type>();
     return parser.make_shared(pattern, options);
   }
+
+  static type from_plan(
+      const ptl_plan &plan, const options_t &options = options_t()) {
+    auto parser = ptl_parser<type>();
+    return parser.load(plan, options);
+  }
+
+  static std::shared_ptr<const ptl_plan> compile(
+      const std::string &pattern, const options_t &options = options_t()) {
+    auto parser = ptl_parser<type>();
+    return parser.compile(pattern);
+  }
 };
 
 }  // namespace reelay
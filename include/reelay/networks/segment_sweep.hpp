@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "boost/icl/type_traits/is_interval_container.hpp"
+
+namespace reelay {
+
+/*
+ * Synchronizes the outputs of several dense-time operands over a segment.
+ *
+ * This is the plane sweep used by dense-time operators to visit every period
+ * on which all operands are constant. Operands are registered with `add` and
+ * `run` walks their boundaries in one pass, calling `fn(begin, end)` for each
+ * such period in order. Inside the callback, `active(i)` tells whether the
+ * i-th interval set holds on the period and `value(i)` gives the value of the
+ * i-th interval map. Scratch buffers are members and keep their capacity
+ * across segments, so the sweep does not allocate in the steady state.
+ *
+ * Interval sets are swept over their boundaries and the segment end; empty
+ * periods are skipped. Interval maps are swept over the upper bounds of their
+ * segments and the sweep stops as soon as any operand is exhausted.
+ */
+template<typename ContainerT>
+struct segment_sweep {
+  using container_t = ContainerT;
+  using time_t = typename container_t::domain_type;
+  using iterator_t = typename container_t::const_iterator;
+
+  static constexpr bool is_map = boost::icl::is_interval_map<container_t>::value;
+
+  void clear()
+  {
+    inputs.clear();
+  }
+
+  void add(const container_t& input)
+  {
+    inputs.push_back(&input);
+  }
+
+  std::size_t size() const
+  {
+    return inputs.size();
+  }
+
+  bool active(std::size_t i) const
+  {
+    return flags[i];
+  }
+
+  // Whether every (any) interval set operand holds on the current period
+  bool all() const
+  {
+    return count == inputs.size();
+  }
+
+  bool any() const
+  {
+    return count > 0;
+  }
+
+  const auto& value(std::size_t i) const
+  {
+    return cursors[i]->second;
+  }
+
+  template<typename FunctionT>
+  void run(time_t previous, time_t now, FunctionT&& fn)
+  {
+    cursors.clear();
+    for(const auto* input : inputs) {
+      cursors.push_back(input->begin());
+    }
+
+    if constexpr(is_map) {
+      sweep_maps(previous, fn);
+    }
+    else {
+      sweep_sets(previous, now, fn);
+    }
+  }
+
+ private:
+  std::vector<const container_t*> inputs;
+  std::vector<iterator_t> cursors;
+  std::vector<char> flags;
+  std::size_t count = 0;
+
+  template<typename FunctionT>
+  void sweep_sets(time_t previous, time_t now, FunctionT& fn)
+  {
+    const std::size_t k = inputs.size();
+    flags.assign(k, false);
+    count = 0;
+
+    // An operand is inside its current interval iff its flag is set, so its
+    // next boundary is the upper bound if so and the lower bound otherwise.
+    auto boundary = [this](std::size_t i) {
+      return flags[i] ? cursors[i]->upper() : cursors[i]->lower();
+    };
+
+    time_t time = previous;
+    while(true) {
+      time_t next = now;
+      for(std::size_t i = 0; i < k; i++) {
+        if(cursors[i] != inputs[i]->end() and boundary(i) < next) {
+          next = boundary(i);
+        }
+      }
+
+      if(time < next) {
+        fn(time, next);
+      }
+      time = next;
+
+      bool advanced = false;
+      for(std::size_t i = 0; i < k; i++) {
+        if(cursors[i] != inputs[i]->end() and boundary(i) == next) {
+          if(flags[i]) {
+            flags[i] = false;
+            count--;
+            cursors[i]++;
+          }
+          else {
+            flags[i] = true;
+            count++;
+          }
+          advanced = true;
+        }
+      }
+
+      if(not advanced) {
+        break;
+      }
+    }
+  }
+
+  template<typename FunctionT>
+  void sweep_maps(time_t previous, FunctionT& fn)
+  {
+    const std::size_t k = inputs.size();
+    if(k == 0) {
+      return;
+    }
+
+    for(std::size_t i = 0; i < k; i++) {
+      if(cursors[i] == inputs[i]->end()) {
+        return;
+      }
+    }
+
+    time_t time = previous;
+    while(true) {
+      time_t next = cursors[0]->first.upper();
+      for(std::size_t i = 1; i < k; i++) {
+        if(cursors[i]->first.upper() < next) {
+          next = cursors[i]->first.upper();
+        }
+      }
+
+      fn(time, next);
+      time = next;
+
+      bool exhausted = false;
+      for(std::size_t i = 0; i < k; i++) {
+        if(cursors[i]->first.upper() == next) {
+          cursors[i]++;
+          exhausted = exhausted or cursors[i] == inputs[i]->end();
+        }
+      }
+
+      if(exhausted) {
+        return;
+      }
+    }
+  }
+};
+
+}  // namespace reelay
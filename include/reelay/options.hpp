@@ -76,6 +76,18 @@ struct basic_options {
     return *this;
   }
 
+  basic_options& with_adaptive_ordering(bool flag)
+  {
+    adaptive_ordering = flag;
+    return *this;
+  }
+
+  basic_options& with_automaton(bool flag)
+  {
+    automaton = flag;
+    return *this;
+  }
+
   basic_options& enable_condensing()
   {
     condensing = true;
@@ -125,12 +137,24 @@ struct basic_options {
     return condensing;
   }
 
+  [[nodiscard]] bool is_adaptive_ordering() const
+  {
+    return adaptive_ordering;
+  }
+
+  [[nodiscard]] bool is_automaton() const
+  {
+    return automaton;
+  }
+
  private:
   data_mgr_t data_manager;
 
   // Setting options
 
   enum piecewise interpolation_option = piecewise::constant;
+  bool adaptive_ordering = false;
+  bool automaton = false;
 
   // Formatter options
   bool condensing = true;
@@ -280,6 +304,19 @@ struct discrete_monitor_options {
     return *this;
   }
 
+  discrete_monitor_options& with_adaptive_ordering(bool flag)
+  {
+    options.with_adaptive_ordering(flag);
+    return *this;
+  }
+
+  // Compiles untimed and small-window specifications into a transition table
+  discrete_monitor_options& with_automaton(bool flag)
+  {
+    options.with_automaton(flag);
+    return *this;
+  }
+
   discrete_monitor_options& enable_condensing()
   {
     options.enable_condensing();
@@ -8,13 +8,23 @@
  
 #pragma once
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #define PEGLIB_USE_STD_ANY 0
 #include "reelay/third_party/cpp-peglib/peglib.h"
 //
 #include "reelay/parser/ptl_grammar.hpp"
+#include "reelay/parser/ptl_plan.hpp"
+#include "reelay/parser/ptl_simplifier.hpp"
 //
 #include "reelay/options.hpp"
 #include "reelay/settings.hpp"
@@ -37,29 +47,40 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
   using options_t = typename NetworkT::options_t;
   using Setting = typename NetworkT::setting_t;
 
-  peg::parser parser;
   reelay::kwargs meta;
 
   std::vector<state_ptr_t> states = std::vector<state_ptr_t>();
 
   explicit ptl_parser(const reelay::kwargs &mm = reelay::kwargs())
-      : meta(mm) {
+      : meta(mm) {}
 
-    parser = peg::parser(grammar);
+  // Plans are shared by all parsers of this network type
+  static plan_cache &cache() {
+    static plan_cache instance;
+    return instance;
+  }
+
+  void install(peg::parser &parser) {
     parser.log = [](size_t line, size_t col, const std::string &msg) {
       std::cerr << line << ":" << col << ": " << msg << std::endl;
     };
 
     parser["SimpleRecordProposition"] = [&](const peg::SemanticValues &sv) {
       if (sv.size() > 1) {
-        std::vector<node_ptr_t> args;
+        std::vector<state_ptr_t> args;
         for (size_t i = 0; i < sv.size(); i++) {
           node_ptr_t child = reelay::any_cast<node_ptr_t>(sv[i]);
-          args.push_back(child);
+          args.push_back(std::static_pointer_cast<state_t>(child));
         }
+
+        // Children are updated by the record proposition when it needs them
+        for (const auto &child : args) {
+          states.erase(std::remove(states.begin(), states.end(), child),
+                       states.end());
+        }
+
         reelay::kwargs kw = {{"args", args}};
-        kw.insert(meta.begin(), meta.end());
-        auto expr = Setting::make_state("atomic_map", kw);
+        auto expr = make_state<state_ptr_t>("atomic_map", kw);
 
         this->states.push_back(expr);
         return std::static_pointer_cast<node_t>(expr);
@@ -71,22 +92,27 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       }
     };
 
-    // parser["NestedRecordProposition"] = [&](const peg::SemanticValues &sv) {
-    //   auto path = reelay::any_cast<std::vector<std::string>>(sv[0]);
+    parser["NestedRecordProposition"] = [&](const peg::SemanticValues &sv) {
+      auto path = reelay::any_cast<std::vector<std::string>>(sv[0]);
 
-    //   std::vector<state_ptr_t> args;
-    //   for (size_t i = 1; i < sv.size(); i++) {
-    //     node_ptr_t child = reelay::any_cast<node_ptr_t>(sv[i]);
-    //     args.push_back(std::static_pointer_cast<state_t>(child));
-    //   }
+      std::vector<state_ptr_t> args;
+      for (size_t i = 1; i < sv.size(); i++) {
+        node_ptr_t child = reelay::any_cast<node_ptr_t>(sv[i]);
+        args.push_back(std::static_pointer_cast<state_t>(child));
+      }
 
-    //   reelay::kwargs kw = {{"args", args}, {"path", path}};
-    //   kw.insert(meta.begin(), meta.end());
-    //   auto expr = Setting::make_state("atomic_nested", kw);
+      // Children are updated by the nested state on the nested record only
+      for (const auto &child : args) {
+        states.erase(std::remove(states.begin(), states.end(), child),
+                     states.end());
+      }
 
-    //   this->states.push_back(expr);
-    //   return std::static_pointer_cast<node_t>(expr);
-    // };
+      reelay::kwargs kw = {{"args", args}, {"path", path}};
+      auto expr = make_state<state_ptr_t>("atomic_nested", kw);
+
+      this->states.push_back(expr);
+      return std::static_pointer_cast<node_t>(expr);
+    };
 
     // parser["NestedAnyRecordProposition"] = [&](const peg::SemanticValues &sv) {
     //   auto path = reelay::any_cast<std::vector<std::string>>(sv[0]);
@@ -126,8 +152,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto keys = reelay::any_cast<std::vector<std::string>>(sv[0]);
 
       reelay::kwargs kw = {{"key", keys[0]}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("mapping_prop", kw);
+      auto expr = make_state("mapping_prop", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -137,8 +162,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto keys = reelay::any_cast<std::vector<std::string>>(sv[0]);
 
       reelay::kwargs kw = {{"key", keys[0]}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("mapping_true", kw);
+      auto expr = make_state("mapping_true", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -148,8 +172,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto keys = reelay::any_cast<std::vector<std::string>>(sv[0]);
 
       reelay::kwargs kw = {{"key", keys[0]}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("mapping_false", kw);
+      auto expr = make_state("mapping_false", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -160,8 +183,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto cstr = reelay::any_cast<std::string>(sv[1]);
 
       reelay::kwargs kw = {{"key", keys[0]}, {"constant", cstr}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("mapping_number", kw);
+      auto expr = make_state("mapping_number", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -172,8 +194,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto cstr = reelay::any_cast<std::string>(sv[1]);
 
       reelay::kwargs kw = {{"key", keys[0]}, {"constant", cstr}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("mapping_string", kw);
+      auto expr = make_state("mapping_string", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -184,8 +205,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto cstr = reelay::any_cast<std::string>(sv[1]);
 
       reelay::kwargs kw = {{"key", keys[0]}, {"constant", cstr}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("mapping_eq", kw);
+      auto expr = make_state("mapping_eq", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -196,8 +216,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto cstr = reelay::any_cast<std::string>(sv[1]);
 
       reelay::kwargs kw = {{"key", keys[0]}, {"constant", cstr}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("mapping_ne", kw);
+      auto expr = make_state("mapping_ne", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -208,8 +227,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto cstr = reelay::any_cast<std::string>(sv[1]);
 
       reelay::kwargs kw = {{"key", keys[0]}, {"constant", cstr}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("mapping_ge", kw);
+      auto expr = make_state("mapping_ge", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -220,8 +238,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto cstr = reelay::any_cast<std::string>(sv[1]);
 
       reelay::kwargs kw = {{"key", keys[0]}, {"constant", cstr}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("mapping_gt", kw);
+      auto expr = make_state("mapping_gt", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -232,8 +249,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto cstr = reelay::any_cast<std::string>(sv[1]);
 
       reelay::kwargs kw = {{"key", keys[0]}, {"constant", cstr}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("mapping_le", kw);
+      auto expr = make_state("mapping_le", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -244,8 +260,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto cstr = reelay::any_cast<std::string>(sv[1]);
 
       reelay::kwargs kw = {{"key", keys[0]}, {"constant", cstr}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("mapping_lt", kw);
+      auto expr = make_state("mapping_lt", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -255,8 +270,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto keys = reelay::any_cast<std::vector<std::string>>(sv[0]);
 
       reelay::kwargs kw = {{"key", keys[0]}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("mapping_any", kw);
+      auto expr = make_state("mapping_any", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -267,8 +281,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto cstr = reelay::any_cast<std::string>(sv[1]);
 
       reelay::kwargs kw = {{"key", keys[0]}, {"constant", cstr}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("mapping_ref", kw);
+      auto expr = make_state("mapping_ref", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -291,9 +304,8 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto index = reelay::any_cast<int>(sv[0]);
 
       reelay::kwargs kw = {{"key", index}};
-      kw.insert(meta.begin(), meta.end());
 
-      auto expr = Setting::make_state("listing_true", kw);
+      auto expr = make_state("listing_true", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -303,9 +315,8 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto index = reelay::any_cast<int>(sv[0]);
 
       reelay::kwargs kw = {{"key", index}};
-      kw.insert(meta.begin(), meta.end());
 
-      auto expr = Setting::make_state("listing_false", kw);
+      auto expr = make_state("listing_false", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -315,9 +326,8 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto index = reelay::any_cast<int>(sv[0]);
       auto cstr = reelay::any_cast<std::string>(sv[1]);
       reelay::kwargs kw = {{"key", index}, {"constant", cstr}};
-      kw.insert(meta.begin(), meta.end());
 
-      auto expr = Setting::make_state("listing_number", kw);
+      auto expr = make_state("listing_number", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -327,9 +337,8 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto index = reelay::any_cast<int>(sv[0]);
       auto cstr = reelay::any_cast<std::string>(sv[1]);
       reelay::kwargs kw = {{"key", index}, {"constant", cstr}};
-      kw.insert(meta.begin(), meta.end());
 
-      auto expr = Setting::make_state("listing_ge", kw);
+      auto expr = make_state("listing_ge", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -339,9 +348,8 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto index = reelay::any_cast<int>(sv[0]);
       auto cstr = reelay::any_cast<std::string>(sv[1]);
       reelay::kwargs kw = {{"key", index}, {"constant", cstr}};
-      kw.insert(meta.begin(), meta.end());
 
-      auto expr = Setting::make_state("listing_gt", kw);
+      auto expr = make_state("listing_gt", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -351,9 +359,8 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto index = reelay::any_cast<int>(sv[0]);
       auto cstr = reelay::any_cast<std::string>(sv[1]);
       reelay::kwargs kw = {{"key", index}, {"constant", cstr}};
-      kw.insert(meta.begin(), meta.end());
 
-      auto expr = Setting::make_state("listing_le", kw);
+      auto expr = make_state("listing_le", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -363,9 +370,8 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto index = reelay::any_cast<int>(sv[0]);
       auto cstr = reelay::any_cast<std::string>(sv[1]);
       reelay::kwargs kw = {{"key", index}, {"constant", cstr}};
-      kw.insert(meta.begin(), meta.end());
 
-      auto expr = Setting::make_state("listing_lt", kw);
+      auto expr = make_state("listing_lt", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -375,9 +381,8 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto index = reelay::any_cast<int>(sv[0]);
       auto cstr = reelay::any_cast<std::string>(sv[1]);
       reelay::kwargs kw = {{"key", index}, {"constant", cstr}};
-      kw.insert(meta.begin(), meta.end());
 
-      auto expr = Setting::make_state("listing_string", kw);
+      auto expr = make_state("listing_string", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -387,9 +392,8 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto index = reelay::any_cast<int>(sv[0]);
 
       reelay::kwargs kw = {{"key", index}};
-      kw.insert(meta.begin(), meta.end());
 
-      auto expr = Setting::make_state("listing_any", kw);
+      auto expr = make_state("listing_any", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -399,9 +403,8 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto index = reelay::any_cast<int>(sv[0]);
       auto cstr = reelay::any_cast<std::string>(sv[1]);
       reelay::kwargs kw = {{"key", index}, {"constant", cstr}};
-      kw.insert(meta.begin(), meta.end());
 
-      auto expr = Setting::make_state("listing_ref", kw);
+      auto expr = make_state("listing_ref", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -426,8 +429,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto args = std::vector<node_ptr_t>({child});
 
       reelay::kwargs kw = {{"args", args}, {"vars", vars}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_node("exists", kw);
+      auto expr = make_node("exists", kw);
 
       return std::static_pointer_cast<node_t>(expr);
     };
@@ -439,8 +441,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto args = std::vector<node_ptr_t>({child});
 
       reelay::kwargs kw = {{"args", args}, {"vars", vars}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_node("forall", kw);
+      auto expr = make_node("forall", kw);
 
       return std::static_pointer_cast<node_t>(expr);
     };
@@ -451,8 +452,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto args = std::vector<node_ptr_t>({child});
 
       reelay::kwargs kw = {{"args", args}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_node("negation", kw);
+      auto expr = make_node("negation", kw);
 
       return std::static_pointer_cast<node_t>(expr);
     };
@@ -467,8 +467,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
         }
 
         reelay::kwargs kw = {{"args", args}};
-        kw.insert(meta.begin(), meta.end());
-        auto expr = Setting::make_node("implication", kw);
+        auto expr = make_node("implication", kw);
 
         return std::static_pointer_cast<node_t>(expr);
       } else {
@@ -487,8 +486,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
         }
 
         reelay::kwargs kw = {{"args", args}};
-        kw.insert(meta.begin(), meta.end());
-        auto expr = Setting::make_node("disjunction", kw);
+        auto expr = make_node("disjunction", kw);
 
         return std::static_pointer_cast<node_t>(expr);
       } else {
@@ -507,8 +505,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
         }
 
         reelay::kwargs kw = {{"args", args}};
-        kw.insert(meta.begin(), meta.end());
-        auto expr = Setting::make_node("conjunction", kw);
+        auto expr = make_node("conjunction", kw);
 
         return std::static_pointer_cast<node_t>(expr);
       } else {
@@ -523,8 +520,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto args = std::vector<node_ptr_t>({child});
 
       reelay::kwargs kw = {{"args", args}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("previous", kw);
+      auto expr = make_state("previous", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -536,8 +532,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto args = std::vector<node_ptr_t>({child});
 
       reelay::kwargs kw = {{"args", args}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("past_sometime", kw);
+      auto expr = make_state("past_sometime", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -554,12 +549,11 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       reelay::kwargs kw = {{"args", args},
                            {"lbound", lbound},
                            {"ubound", ubound}};
-      kw.insert(meta.begin(), meta.end());
       state_ptr_t expr;
       if (ubound > 0) {
-        expr = Setting::make_state("past_sometime_bounded", kw);
+        expr = make_state("past_sometime_bounded", kw);
       } else {
-        expr = Setting::make_state("past_sometime_bounded_half", kw);
+        expr = make_state("past_sometime_bounded_half", kw);
       }
 
       this->states.push_back(expr);
@@ -571,8 +565,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       auto args = std::vector<node_ptr_t>({child});
 
       reelay::kwargs kw = {{"args", args}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("past_always", kw);
+      auto expr = make_state("past_always", kw);
 
       this->states.push_back(expr);
       return std::static_pointer_cast<node_t>(expr);
@@ -589,12 +582,11 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
       reelay::kwargs kw = {{"args", args},
                            {"lbound", lbound},
                            {"ubound", ubound}};
-      kw.insert(meta.begin(), meta.end());
       state_ptr_t expr;
       if (ubound > 0) {
-        expr = Setting::make_state("past_always_bounded", kw);
+        expr = make_state("past_always_bounded", kw);
       } else {
-        expr = Setting::make_state("past_always_bounded_half", kw);
+        expr = make_state("past_always_bounded_half", kw);
       }
 
       this->states.push_back(expr);
@@ -616,13 +608,12 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
         reelay::kwargs kw = {{"args", args},
                              {"lbound", lbound},
                              {"ubound", ubound}};
-        kw.insert(meta.begin(), meta.end());
 
         state_ptr_t expr;
         if (ubound > 0){
-          expr = Setting::make_state("since_bounded", kw);
+          expr = make_state("since_bounded", kw);
         } else {
-          expr = Setting::make_state("since_bounded_half", kw);
+          expr = make_state("since_bounded_half", kw);
         }
 
         this->states.push_back(expr);
@@ -634,8 +625,7 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
         auto args = std::vector<node_ptr_t>({left, right});
 
         reelay::kwargs kw = {{"args", args}};
-        kw.insert(meta.begin(), meta.end());
-        auto expr = Setting::make_state("since", kw);
+        auto expr = make_state("since", kw);
 
         this->states.push_back(expr);
         return std::static_pointer_cast<node_t>(expr);
@@ -689,22 +679,235 @@ template <class NetworkT> struct ptl_parser : ptl_grammar{
     parser["DQString"] = [](const peg::SemanticValues &sv) {
       return sv.token();
     };
-
-    parser.enable_packrat_parsing(); // Enable packrat parsing.
   }
 
   network_t parse(const std::string &pattern, const options_t& options = options_t()) {
-    node_ptr_t root;
-    parser.parse(pattern.c_str(), root);
+    node_ptr_t root = build(pattern);
     return network_t(root, states, options);
   }
   
   std::shared_ptr<network_t> make_shared(const std::string &pattern, const options_t& options = options_t()) {
-    node_ptr_t root;
-    parser.parse(pattern.c_str(), root);
+    node_ptr_t root = build(pattern);
     return std::make_shared<network_t>(root, states, options);
   }
 
+  // Builds the network from a plan recorded for the same network type
+  network_t load(const ptl_plan &recipe, const options_t& options = options_t()) {
+    if (recipe.setting != NetworkT::setting_name) {
+      throw std::invalid_argument("Plan recorded for another setting: " +
+                                  recipe.setting);
+    }
+    node_ptr_t root = instantiate(recipe);
+    return network_t(root, states, options);
+  }
+
+  // Returns the plan of the pattern, parsing it unless cached
+  std::shared_ptr<const ptl_plan> compile(const std::string &pattern) {
+    auto cached = cache().find(pattern);
+    if (cached != nullptr) {
+      return cached;
+    }
+    auto recorded = record_plan(pattern).second;
+    if (recorded == nullptr) {
+      throw std::invalid_argument("Invalid specification: " + pattern);
+    }
+    return recorded;
+  }
+
+  // Builds the network from the cached plan, parsing the pattern on a miss
+  node_ptr_t build(const std::string &pattern) {
+    auto cached = cache().find(pattern);
+    if (cached != nullptr) {
+      return instantiate(*cached);
+    }
+    return record_plan(pattern).first;
+  }
+
+  // Parses the pattern into a network and records its plan into the cache.
+  // The plan is returned as well, since the cache may not keep it, and is
+  // null for syntax errors.
+  std::pair<node_ptr_t, std::shared_ptr<const ptl_plan>>
+  record_plan(const std::string &pattern) {
+    auto simplified = ptl_simplifier().simplify(pattern);
+    plan = ptl_plan();
+    plan.setting = NetworkT::setting_name;
+    plan.source = pattern;
+    steps.clear();
+
+    node_ptr_t root;
+    bool parsed = false;
+    {
+      auto &compiled = compiled_grammar<ptl_parser>::instance();
+      std::lock_guard<std::mutex> lock(compiled.mutex);
+      install(compiled.parser);
+      parsed = compiled.parser.parse(simplified.c_str(), root);
+    }
+
+    std::shared_ptr<const ptl_plan> recorded;
+    if (parsed and root != nullptr) { // Syntax errors are not cached
+      plan.root = steps.at(root.get());
+      for (const auto &state : states) {
+        plan.states.push_back(steps.at(state.get()));
+      }
+      recorded = std::make_shared<const ptl_plan>(plan);
+      cache().insert(pattern, recorded);
+    }
+    return {root, recorded};
+  }
+
+  node_ptr_t instantiate(const ptl_plan &recipe) {
+    auto nodes = replay(recipe.steps);
+    states.clear();
+    for (auto i : recipe.states) {
+      states.push_back(std::static_pointer_cast<state_t>(nodes.at(i)));
+    }
+    return nodes.at(recipe.root);
+  }
+
+  // Makes the nodes of the steps in order, one per step, except the steps
+  // whose nodes are given (non-null) in `nodes`
+  std::vector<node_ptr_t> replay(const std::vector<ptl_plan::step> &recipe,
+                                 std::vector<node_ptr_t> nodes = {}) {
+    nodes.resize(recipe.size());
+    for (std::size_t n = 0; n < recipe.size(); n++) {
+      if (nodes[n] != nullptr) {
+        continue;
+      }
+      const auto &step = recipe[n];
+      reelay::kwargs kw = arguments(step);
+      if (step.nested) {
+        std::vector<state_ptr_t> args;
+        for (auto i : step.args) {
+          args.push_back(std::static_pointer_cast<state_t>(nodes.at(i)));
+        }
+        kw["args"] = args;
+      } else if (step.has_args) {
+        std::vector<node_ptr_t> args;
+        for (auto i : step.args) {
+          args.push_back(nodes.at(i));
+        }
+        kw["args"] = args;
+      }
+      kw.insert(meta.begin(), meta.end());
+
+      if (step.is_state) {
+        kw = with_key_type(step.name, std::move(kw));
+        nodes[n] = Setting::make_state(step.name, kw);
+      } else {
+        nodes[n] = Setting::make_node(step.name, kw);
+      }
+    }
+    return nodes;
+  }
+
+ private:
+  using argument_t = ptl_plan::argument;
+  using kind = ptl_plan::argument::kind;
+
+  ptl_plan plan;
+  std::unordered_map<const node_t *, std::size_t> steps;
+
+  // Factory calls made by parser actions, recorded into the plan
+  template <typename ArgT = node_ptr_t>
+  state_ptr_t make_state(const std::string &name, const reelay::kwargs &kw) {
+    auto merged = with_key_type(name, with_meta(kw));
+    auto expr = Setting::make_state(name, merged);
+    record<ArgT>(name, true, kw, expr.get());
+    return expr;
+  }
+
+  node_ptr_t make_node(const std::string &name, const reelay::kwargs &kw) {
+    auto merged = with_meta(kw);
+    auto expr = Setting::make_node(name, merged);
+    record<node_ptr_t>(name, false, kw, expr.get());
+    return expr;
+  }
+
+  reelay::kwargs with_meta(reelay::kwargs kw) const {
+    kw.insert(meta.begin(), meta.end());
+    return kw;
+  }
+
+  // Field keys are given to atoms in the key type of the input datafield
+  static reelay::kwargs with_key_type(const std::string &name,
+                                      reelay::kwargs kw) {
+    using key_t = datafield_key_t<input_t>;
+    if constexpr (not std::is_same_v<key_t, std::string>) {
+      auto it = kw.find("key");
+      if (it != kw.end() and name.rfind("listing_", 0) != 0) {
+        it->second = key_t(any_cast<std::string>(it->second));
+      }
+    }
+    return kw;
+  }
+
+  template <typename ArgT>
+  void record(const std::string &name, bool is_state,
+              const reelay::kwargs &kw, const node_t *expr) {
+    auto step = ptl_plan::step();
+    step.name = name;
+    step.is_state = is_state;
+    step.nested = std::is_same_v<ArgT, state_ptr_t>;
+    for (const auto &[key, value] : kw) {
+      if (key == "args") {
+        step.has_args = true;
+        for (const auto &arg : any_cast<std::vector<ArgT>>(value)) {
+          step.args.push_back(steps.at(arg.get()));
+        }
+      } else {
+        step.kw.push_back(argument(name, key, value));
+      }
+    }
+    // Keyword order of an unordered map is not stable across processes
+    std::sort(step.kw.begin(), step.kw.end(),
+              [](const auto &a, const auto &b) { return a.name < b.name; });
+    steps[expr] = plan.steps.size();
+    plan.steps.push_back(std::move(step));
+  }
+
+  // Keyword arguments of parser actions have fixed types per name
+  static argument_t argument(const std::string &step, const std::string &name,
+                             const reelay::any &value) {
+    auto result = argument_t();
+    result.name = name;
+    if (name == "key" and step.rfind("listing_", 0) == 0) {
+      result.type = kind::index;
+      result.index = any_cast<int>(value);
+    } else if (name == "key" or name == "constant") {
+      result.type = kind::text;
+      result.text = any_cast<std::string>(value);
+    } else if (name == "lbound" or name == "ubound") {
+      result.type = kind::bound;
+      result.bound = double(any_cast<time_t>(value));
+    } else if (name == "path" or name == "vars") {
+      result.type = kind::names;
+      result.names = any_cast<std::vector<std::string>>(value);
+    } else {
+      throw std::logic_error("Unknown keyword argument: " + name);
+    }
+    return result;
+  }
+
+  static reelay::kwargs arguments(const ptl_plan::step &step) {
+    reelay::kwargs kw;
+    for (const auto &arg : step.kw) {
+      switch (arg.type) {
+      case kind::text:
+        kw[arg.name] = arg.text;
+        break;
+      case kind::index:
+        kw[arg.name] = int(arg.index);
+        break;
+      case kind::bound:
+        kw[arg.name] = time_t(arg.bound);
+        break;
+      case kind::names:
+        kw[arg.name] = arg.names;
+        break;
+      }
+    }
+    return kw;
+  }
 };
 
 } // namespace reelay
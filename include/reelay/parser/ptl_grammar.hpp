@@ -8,6 +8,11 @@
  
 #pragma once
 
+#include <mutex>
+
+#define PEGLIB_USE_STD_ANY 0
+#include "reelay/third_party/cpp-peglib/peglib.h"
+
 namespace reelay {
 
 struct ptl_grammar {
@@ -27,7 +32,9 @@ struct ptl_grammar {
     HistExpr <- HIST Atom / HIST '(' Expression ')'
     TimedOnceExpr <- ONCE Bound Atom / ONCE Bound '(' Expression ')'
     TimedHistExpr <- HIST Bound Atom / HIST Bound '(' Expression ')'
-    Atom <- CustomPredicate / RecordProposition 
+    Atom <- CustomPredicate / RecordProposition / Constant
+
+    Constant <- TRUE / FALSE
             
     CustomPredicate <- '$' LCURLY Name RCURLY
     
@@ -127,4 +134,33 @@ struct ptl_grammar {
     )";
 };
 
+/*
+ * The PTL grammar compiled once per process for each kind of parser.
+ *
+ * peglib keeps semantic actions inside the compiled grammar, so parsers of
+ * one kind share a single instance: a parser installs its actions and parses
+ * while holding the lock. Every kind installs the same set of actions each
+ * time, hence no stale action survives from a previous parse.
+ */
+template<typename ParserT>
+struct compiled_grammar {
+  std::mutex mutex;
+  peg::parser parser;
+
+  static compiled_grammar& instance()
+  {
+    static compiled_grammar singleton;  // Initialization is thread-safe
+    return singleton;
+  }
+
+  compiled_grammar(const compiled_grammar&) = delete;
+  compiled_grammar& operator=(const compiled_grammar&) = delete;
+
+ private:
+  compiled_grammar() : parser(ptl_grammar::grammar)
+  {
+    parser.enable_packrat_parsing();
+  }
+};
+
 } // namespace reelay
\ No newline at end of file
@@ -8,8 +8,16 @@
  
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <iostream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 #define PEGLIB_USE_STD_ANY 0
 #include "reelay/third_party/cpp-peglib/peglib.h"
@@ -19,15 +27,70 @@
 
 namespace reelay {
 
+/*
+ * Static worst-case bounds on what a monitor of a specification keeps and
+ * does per event, computed from the syntax alone.
+ *
+ * Every operator is a node evaluated per event; atoms and temporal operators
+ * are also states updated per event. Untimed past operators keep constant
+ * state however far they look back. Timed operators keep sets of intervals:
+ * in discrete time, a window [a:b] holds at most b/(b-a+2)+1 disjoint
+ * intervals and a window [a:] only one, whereas in dense time the intervals
+ * of a bounded window fragment with every change of its operand and are
+ * bounded only by the rate of input changes. Data references make the state
+ * depend on the values seen, which no static bound covers.
+ */
+struct ptl_bounds {
+  static constexpr double unbounded = std::numeric_limits<double>::infinity();
+
+  // Conservative sizes of a node (with its shared pointer) and an interval
+  static constexpr double node_bytes = 128;
+  static constexpr double interval_bytes = 64;
+
+  std::size_t operators = 0;
+  std::size_t states = 0;
+  std::size_t windows = 0;            // timed operators
+  std::size_t unbounded_windows = 0;  // windows of the form [a:]
+  double horizon = 0;    // how far back verdicts may look, in time units
+  double intervals = 0;  // intervals kept in discrete time, at most
+  double span = 0;       // total length of the bounded windows
+  bool references = false;
+
+  // Estimated bytes in the worst case, where `rate` bounds the number of
+  // input changes per time unit in dense time
+  double memory(bool dense = false, double rate = unbounded) const {
+    if (references) {
+      return unbounded;
+    }
+    double kept = intervals;
+    if (dense and span > 0) {
+      kept = double(windows) + span * rate;
+    }
+    return double(operators) * node_bytes + kept * interval_bytes;
+  }
+
+  ptl_bounds &operator+=(const ptl_bounds &other) {
+    operators += other.operators;
+    states += other.states;
+    windows += other.windows;
+    unbounded_windows += other.unbounded_windows;
+    horizon = std::max(horizon, other.horizon);
+    intervals += other.intervals;
+    span += other.span;
+    references = references or other.references;
+    return *this;
+  }
+};
+
 struct ptl_inspector : ptl_grammar {
+  using bounds_t = ptl_bounds;
+  using window_t = std::pair<double, double>;
 
-  peg::parser parser;
-  reelay::kwargs meta =
-      reelay::kwargs({{"timed", false}, {"has_references", false}});
+  reelay::kwargs meta = defaults();
 
-  explicit ptl_inspector() {
+  std::vector<std::string> keys;
 
-    parser = peg::parser(grammar);
+  void install(peg::parser &parser) {
     parser.log = [](size_t line, size_t col, const std::string &msg) {
       std::cerr << line << ":" << col << ": " << msg << std::endl;
     };
@@ -36,35 +99,225 @@ struct ptl_inspector : ptl_grammar {
       this->meta["has_references"] = true;
     };
 
+    // Top-level field keys referenced by the pattern, in order of appearance
+    parser["FieldKey"] = [&](const peg::SemanticValues &sv) {
+      auto key = reelay::any_cast<std::string>(sv[0]);
+      if (std::find(keys.begin(), keys.end(), key) == keys.end()) {
+        keys.push_back(key);
+      }
+    };
+
+    parser["PathKey"] = [&](const peg::SemanticValues &sv) {
+      this->meta["has_nested_keys"] = true;
+    };
+
+    parser["ArrayKey"] = [&](const peg::SemanticValues &sv) {
+      this->meta["has_nested_keys"] = true;
+    };
+
+    // Bounds are computed bottom-up over the expression
     parser["ExistsExpr"] = [&](const peg::SemanticValues &sv) {
       this->meta["has_references"] = true;
+      return quantified(sv);
     };
 
     parser["ForallExpr"] = [&](const peg::SemanticValues &sv) {
       this->meta["has_references"] = true;
+      return quantified(sv);
     };
 
     parser["TimedOnceExpr"] = [&](const peg::SemanticValues &sv) {
       this->meta["timed"] = true;
+      return windowed(sv);
     };
 
     parser["TimedHistExpr"] = [&](const peg::SemanticValues &sv) {
       this->meta["timed"] = true;
+      return windowed(sv);
     };
 
     parser["SinceExpr"] = [&](const peg::SemanticValues &sv) {
       if (sv.size() == 3) {
         this->meta["timed"] = true;
+        return windowed(sv);
+      }
+      if (sv.size() == 2) {
+        auto result = combined(sv);
+        result.states++;
+        result.horizon = bounds_t::unbounded;
+        return result;
       }
+      return reelay::any_cast<bounds_t>(sv[0]);
+    };
+
+    parser["Implicative"] = [](const peg::SemanticValues &sv) {
+      return combined(sv);
+    };
+
+    parser["Disjunctive"] = [](const peg::SemanticValues &sv) {
+      return combined(sv);
+    };
+
+    parser["Conjunctive"] = [](const peg::SemanticValues &sv) {
+      return combined(sv);
+    };
+
+    parser["NotExpr"] = [](const peg::SemanticValues &sv) {
+      return combined(sv, true);
+    };
+
+    parser["PrevExpr"] = [](const peg::SemanticValues &sv) {
+      auto result = combined(sv, true);
+      result.states++;
+      result.horizon = result.horizon + 1;
+      return result;
+    };
+
+    parser["OnceExpr"] = [](const peg::SemanticValues &sv) {
+      auto result = combined(sv, true);
+      result.states++;
+      result.horizon = bounds_t::unbounded;
+      return result;
+    };
+
+    parser["HistExpr"] = [](const peg::SemanticValues &sv) {
+      auto result = combined(sv, true);
+      result.states++;
+      result.horizon = bounds_t::unbounded;
+      return result;
+    };
+
+    parser["Atom"] = [](const peg::SemanticValues &sv) {
+      auto result = bounds_t();
+      result.operators = 1;
+      result.states = sv.choice() == 2 ? 0 : 1;  // Constants have no state
+      return result;
+    };
+
+    parser["FullBound"] = [](const peg::SemanticValues &sv) {
+      return window_t(number(sv[0]), number(sv[1]));
     };
 
-    parser.enable_packrat_parsing(); // Enable packrat parsing.
+    parser["LowerBound"] = [](const peg::SemanticValues &sv) {
+      return window_t(number(sv[0]), bounds_t::unbounded);
+    };
+
+    parser["UpperBound"] = [](const peg::SemanticValues &sv) {
+      return window_t(0, number(sv[0]));
+    };
+
+    parser["Number"] = [](const peg::SemanticValues &sv) {
+      return sv.token();
+    };
+
+    parser["Name"] = [](const peg::SemanticValues &sv) { return sv.token(); };
+    parser["SQString"] = [](const peg::SemanticValues &sv) {
+      return sv.token();
+    };
+    parser["DQString"] = [](const peg::SemanticValues &sv) {
+      return sv.token();
+    };
   }
 
+  // Throws std::invalid_argument for syntax errors
   reelay::kwargs inspect(const std::string &pattern) {
-    parser.parse(pattern.c_str());
+    meta = defaults();
+    keys.clear();
+    auto bounds = bounds_t();
+    bool parsed = false;
+    {
+      auto &compiled = compiled_grammar<ptl_inspector>::instance();
+      std::lock_guard<std::mutex> lock(compiled.mutex);
+      install(compiled.parser);
+      parsed = compiled.parser.parse(pattern.c_str(), bounds);
+    }
+    if (not parsed) {
+      throw std::invalid_argument("Invalid specification: " + pattern);
+    }
+    bounds.references = reelay::any_cast<bool>(this->meta["has_references"]);
+    this->meta["keys"] = keys;
+    this->meta["bounds"] = bounds;
     return this->meta;
   }
+
+  // Same as `inspect` but rejects the pattern with std::invalid_argument if
+  // its monitor may need more than `budget` bytes (see ptl_bounds::memory)
+  reelay::kwargs admit(const std::string &pattern, double budget,
+                       bool dense = false,
+                       double rate = bounds_t::unbounded) {
+    auto result = inspect(pattern);
+    auto memory = reelay::any_cast<bounds_t>(result["bounds"]).memory(dense,
+                                                                      rate);
+    if (memory > budget) {
+      throw std::invalid_argument(
+          "Specification may need " + bytes(memory) +
+          " bytes, over the budget of " + bytes(budget) +
+          " bytes: " + pattern);
+    }
+    return result;
+  }
+
+ private:
+  static reelay::kwargs defaults() {
+    return reelay::kwargs({{"timed", false},
+                           {"has_references", false},
+                           {"has_nested_keys", false},
+                           {"keys", std::vector<std::string>()},
+                           {"bounds", ptl_bounds()}});
+  }
+
+  static double number(const reelay::any &value) {
+    return std::stod(reelay::any_cast<std::string>(value));
+  }
+
+  static std::string bytes(double value) {
+    if (std::isinf(value)) {
+      return "unbounded";
+    }
+    return std::to_string(static_cast<unsigned long long>(value));
+  }
+
+  // Operands and, with `node`, one more operator over them
+  static bounds_t combined(const peg::SemanticValues &sv, bool node = false) {
+    auto result = bounds_t();
+    for (const auto &value : sv) {
+      result += reelay::any_cast<bounds_t>(value);
+    }
+    if (node or sv.size() > 1) {
+      result.operators++;
+    }
+    return result;
+  }
+
+  static bounds_t quantified(const peg::SemanticValues &sv) {
+    auto result = reelay::any_cast<bounds_t>(sv.back());
+    result.operators++;
+    result.references = true;
+    return result;
+  }
+
+  // Timed operators: the window is the value before the last operand
+  static bounds_t windowed(const peg::SemanticValues &sv) {
+    auto [lbound, ubound] = reelay::any_cast<window_t>(sv[sv.size() - 2]);
+    auto result = bounds_t();
+    for (std::size_t i = 0; i < sv.size(); i++) {
+      if (i != sv.size() - 2) {
+        result += reelay::any_cast<bounds_t>(sv[i]);
+      }
+    }
+    result.operators++;
+    result.states++;
+    result.windows++;
+    result.horizon = result.horizon + ubound;
+    if (std::isinf(ubound)) {
+      result.unbounded_windows++;
+      result.intervals += 1;
+    } else {
+      result.intervals += std::floor(ubound / (ubound - lbound + 2)) + 1;
+      result.span += ubound;
+    }
+    return result;
+  }
 };
 
 } // namespace reelay
\ No newline at end of file
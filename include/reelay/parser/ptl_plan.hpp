@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "reelay/common.hpp"
+
+namespace reelay {
+
+/*
+ * Construction steps of a network as recorded by ptl_parser.
+ *
+ * Every step is a call to the factory of the setting with the keyword
+ * arguments of the parser action, except the network-wide `meta` arguments
+ * (options, data managers), which are supplied again at each instantiation.
+ * Arguments refer to earlier steps by index, so a plan replays without
+ * parsing and is immutable once recorded. Keyword arguments are kept typed
+ * so that plans can also be written to files (see reelay/io/plan_file.hpp).
+ */
+struct ptl_plan {
+  struct argument {
+    enum class kind : uint8_t { text = 0, index = 1, bound = 2, names = 3 };
+
+    std::string name;
+    kind type = kind::text;
+    std::string text;                // keys and constants
+    int64_t index = 0;               // keys of listings
+    double bound = 0;                // timing bounds
+    std::vector<std::string> names;  // paths and variables
+
+    bool operator==(const argument& other) const
+    {
+      return name == other.name and type == other.type and
+             text == other.text and index == other.index and
+             bound == other.bound and names == other.names;
+    }
+  };
+
+  struct step {
+    std::string name;
+    bool is_state = false;  // made by make_state, else by make_node
+    bool nested = false;    // arguments are passed as states
+    bool has_args = false;
+    std::vector<std::size_t> args;
+    std::vector<argument> kw;
+
+    bool operator==(const step& other) const
+    {
+      return name == other.name and is_state == other.is_state and
+             nested == other.nested and has_args == other.has_args and
+             args == other.args and kw == other.kw;
+    }
+  };
+
+  std::string setting;  // network type the plan was recorded for
+  std::string source;   // specification text, for reference only
+  std::vector<step> steps;
+  std::vector<std::size_t> states;  // updated by the network, in order
+  std::size_t root = 0;
+
+  bool operator==(const ptl_plan& other) const
+  {
+    return setting == other.setting and source == other.source and
+           steps == other.steps and states == other.states and
+           root == other.root;
+  }
+};
+
+/*
+ * Plans of several specifications merged into one graph. Steps are
+ * hash-consed as they are added: a step with the same factory, keyword
+ * arguments and (merged) operands as an existing one is the same node, so
+ * atoms and identical subformulas are shared across specifications. Every
+ * plan is in topological order and new steps are appended, hence the merged
+ * steps are too. States are appended in the order of their plans, so a state
+ * always follows the states it reads.
+ */
+struct ptl_plan_set {
+  std::string setting;
+  std::vector<ptl_plan::step> steps;
+  std::vector<std::size_t> states;
+  std::vector<std::size_t> roots;  // per specification, in order
+
+  void add(const ptl_plan& plan)
+  {
+    if(roots.empty()) {
+      setting = plan.setting;
+    }
+    else if(plan.setting != setting) {
+      throw std::invalid_argument(
+        "Plans recorded for different settings: " + setting + " and " +
+        plan.setting);
+    }
+
+    // Children of nested propositions read the nested record, so they are
+    // shared only with children under the same path
+    auto scopes = std::vector<std::string>(plan.steps.size());
+    for(auto i = plan.steps.size(); i-- > 0;) {
+      const auto& step = plan.steps[i];
+      auto scope = scopes[i];
+      if(step.nested) {
+        for(const auto& arg : step.kw) {
+          if(arg.name == "path") {
+            for(const auto& name : arg.names) {
+              scope += std::to_string(name.size()) + ':' + name + "::";
+            }
+          }
+        }
+      }
+      for(auto arg : step.args) {
+        scopes[arg] = scope;
+      }
+    }
+
+    auto mapping = std::vector<std::size_t>();
+    for(std::size_t i = 0; i < plan.steps.size(); i++) {
+      auto merged = plan.steps[i];
+      for(auto& arg : merged.args) {
+        arg = mapping[arg];
+      }
+
+      auto key = scopes[i] + signature(merged);
+      auto [it, inserted] = index.emplace(std::move(key), steps.size());
+      if(inserted) {
+        steps.push_back(std::move(merged));
+      }
+      mapping.push_back(it->second);
+    }
+
+    // Only the states the plan updates itself, not the children of record
+    // propositions, are updated by the merged network. A child shared with a
+    // state of another plan is updated by both, which is harmless for atoms.
+    updated.resize(steps.size(), false);
+    for(auto i : plan.states) {
+      if(not updated[mapping[i]]) {
+        updated[mapping[i]] = true;
+        states.push_back(mapping[i]);
+      }
+    }
+    roots.push_back(mapping.at(plan.root));
+  }
+
+ private:
+  std::unordered_map<std::string, std::size_t> index;
+  std::vector<bool> updated;  // per merged step, whether in `states`
+
+  static std::string signature(const ptl_plan::step& step)
+  {
+    auto result = step.name;
+    result += char('0' + int(step.is_state) + 2 * int(step.nested) +
+                   4 * int(step.has_args));
+    for(auto arg : step.args) {
+      result += ',' + std::to_string(arg);
+    }
+    for(const auto& arg : step.kw) {
+      result += ';' + arg.name + '=' + std::to_string(int(arg.type)) + ':';
+      switch(arg.type) {
+        case ptl_plan::argument::kind::text:
+          result += std::to_string(arg.text.size()) + ':' + arg.text;
+          break;
+        case ptl_plan::argument::kind::index:
+          result += std::to_string(arg.index);
+          break;
+        case ptl_plan::argument::kind::bound: {
+          uint64_t bits = 0;
+          std::memcpy(&bits, &arg.bound, sizeof(bits));
+          result += std::to_string(bits);
+          break;
+        }
+        case ptl_plan::argument::kind::names:
+          for(const auto& name : arg.names) {
+            result += std::to_string(name.size()) + ':' + name;
+          }
+          break;
+      }
+    }
+    return result;
+  }
+};
+
+/*
+ * Least recently used cache of plans keyed by the specification text. One
+ * instance per network type is shared process-wide; all members are
+ * thread-safe. Plans are shared immutable objects and outlive eviction for as
+ * long as a caller holds them.
+ */
+struct plan_cache {
+  using plan_ptr_t = std::shared_ptr<const ptl_plan>;
+
+  static constexpr std::size_t default_capacity = 1024;
+
+  explicit plan_cache(std::size_t n = default_capacity) : capacity(n) {}
+
+  plan_ptr_t find(const std::string& pattern)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(pattern);
+    if(it == index.end()) {
+      misses++;
+      return nullptr;
+    }
+    hits++;
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->second;
+  }
+
+  void insert(const std::string& pattern, plan_ptr_t plan)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(pattern);
+    if(it != index.end()) {
+      entries.erase(it->second);  // Compiled concurrently by another thread
+      index.erase(it);
+    }
+    entries.emplace_front(pattern, std::move(plan));
+    index[pattern] = entries.begin();
+    evict();
+  }
+
+  // Sets the number of plans kept; zero disables caching
+  void resize(std::size_t n)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = n;
+    evict();
+  }
+
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+  }
+
+  std::size_t size()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+  }
+
+  // Number of lookups that found (did not find) a plan
+  std::pair<std::size_t, std::size_t> statistics()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return {hits, misses};
+  }
+
+ private:
+  using entry_t = std::pair<std::string, plan_ptr_t>;
+
+  std::mutex mutex;
+  std::size_t capacity;
+  std::list<entry_t> entries;
+  std::unordered_map<std::string, std::list<entry_t>::iterator> index;
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+
+  void evict()
+  {
+    while(entries.size() > capacity) {
+      index.erase(entries.back().first);
+      entries.pop_back();
+    }
+  }
+};
+
+}  // namespace reelay
@@ -0,0 +1,594 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define PEGLIB_USE_STD_ANY 0
+#include "reelay/third_party/cpp-peglib/peglib.h"
+
+#include "reelay/common.hpp"
+#include "reelay/parser/ptl_grammar.hpp"
+
+namespace reelay {
+
+/*
+ * Formula tree used by the simplifier. Atoms keep their source text, and
+ * temporal operators keep their bounds with an infinite upper bound for
+ * unbounded operators.
+ */
+struct ptl_expression {
+  enum class op {
+    constant,
+    atom,
+    negation,
+    conjunction,
+    disjunction,
+    implication,
+    previous,
+    once,
+    historically,
+    since,
+    exists,
+    forall
+  };
+
+  using ptr_t = std::shared_ptr<ptl_expression>;
+
+  op kind = op::atom;
+  bool value = false;     // constant
+  std::string text;       // atom
+  std::vector<std::string> vars;  // quantifiers
+  double lbound = 0;
+  double ubound = std::numeric_limits<double>::infinity();
+  std::vector<ptr_t> args;
+
+  bool is_unbounded() const
+  {
+    return lbound == 0 and std::isinf(ubound);
+  }
+};
+
+/*
+ * Rewrites past temporal logic patterns into an equivalent normal form
+ * before networks are built, so that fewer operators are instantiated.
+ *
+ * - Constants `true` and `false` are folded away.
+ * - Double negations are eliminated.
+ * - Nested conjunctions and disjunctions are flattened and duplicate
+ *   operands removed.
+ * - Negations are pushed through `once` and `historically` and through
+ *   connectives whenever that does not add negations.
+ * - Nested `once` (`historically`) operators are merged by adding bounds.
+ *
+ * Constants that cannot be folded away, such as `once[1:2] true`, have no
+ * network counterpart and are rejected with std::invalid_argument.
+ */
+struct ptl_simplifier : ptl_grammar {
+  using expr_t = ptl_expression;
+  using op = ptl_expression::op;
+  using expr_ptr_t = ptl_expression::ptr_t;
+
+  static void install(peg::parser& parser)
+  {
+    // Syntax errors are reported by ptl_parser, which sees the same pattern
+    parser.log = [](size_t, size_t, const std::string&) {};
+
+    parser["Atom"] = [](const peg::SemanticValues& sv) {
+      if(sv.choice() == 2) {
+        return any_cast<expr_ptr_t>(sv[0]);  // Constant
+      }
+      auto expr = std::make_shared<expr_t>();
+      expr->kind = op::atom;
+      expr->text = trim(sv.str());
+      return expr;
+    };
+
+    parser["Constant"] = [](const peg::SemanticValues& sv) {
+      return constant(sv.choice() == 0);
+    };
+
+    parser["ExistsExpr"] = [](const peg::SemanticValues& sv) {
+      return quantifier(op::exists, sv);
+    };
+
+    parser["ForallExpr"] = [](const peg::SemanticValues& sv) {
+      return quantifier(op::forall, sv);
+    };
+
+    parser["Implicative"] = [](const peg::SemanticValues& sv) {
+      return nary(op::implication, sv);
+    };
+
+    parser["Disjunctive"] = [](const peg::SemanticValues& sv) {
+      return nary(op::disjunction, sv);
+    };
+
+    parser["Conjunctive"] = [](const peg::SemanticValues& sv) {
+      return nary(op::conjunction, sv);
+    };
+
+    parser["NotExpr"] = [](const peg::SemanticValues& sv) {
+      return unary(op::negation, any_cast<expr_ptr_t>(sv[0]));
+    };
+
+    parser["PrevExpr"] = [](const peg::SemanticValues& sv) {
+      return unary(op::previous, any_cast<expr_ptr_t>(sv[0]));
+    };
+
+    parser["OnceExpr"] = [](const peg::SemanticValues& sv) {
+      return unary(op::once, any_cast<expr_ptr_t>(sv[0]));
+    };
+
+    parser["HistExpr"] = [](const peg::SemanticValues& sv) {
+      return unary(op::historically, any_cast<expr_ptr_t>(sv[0]));
+    };
+
+    parser["TimedOnceExpr"] = [](const peg::SemanticValues& sv) {
+      auto expr = unary(op::once, any_cast<expr_ptr_t>(sv[1]));
+      set_bound(*expr, any_cast<std::pair<double, double>>(sv[0]));
+      return expr;
+    };
+
+    parser["TimedHistExpr"] = [](const peg::SemanticValues& sv) {
+      auto expr = unary(op::historically, any_cast<expr_ptr_t>(sv[1]));
+      set_bound(*expr, any_cast<std::pair<double, double>>(sv[0]));
+      return expr;
+    };
+
+    parser["SinceExpr"] = [](const peg::SemanticValues& sv) {
+      if(sv.size() == 1) {
+        return any_cast<expr_ptr_t>(sv[0]);
+      }
+      auto expr = std::make_shared<expr_t>();
+      expr->kind = op::since;
+      expr->args.push_back(any_cast<expr_ptr_t>(sv[0]));
+      expr->args.push_back(any_cast<expr_ptr_t>(sv[sv.size() - 1]));
+      if(sv.size() == 3) {
+        set_bound(*expr, any_cast<std::pair<double, double>>(sv[1]));
+      }
+      return expr;
+    };
+
+    // Bounds follow ptl_parser: a non-positive upper bound means unbounded
+    parser["FullBound"] = [](const peg::SemanticValues& sv) {
+      return std::make_pair(
+        std::stod(any_cast<std::string>(sv[0])),
+        std::stod(any_cast<std::string>(sv[1])));
+    };
+
+    parser["LowerBound"] = [](const peg::SemanticValues& sv) {
+      return std::make_pair(std::stod(any_cast<std::string>(sv[0])), 0.0);
+    };
+
+    parser["UpperBound"] = [](const peg::SemanticValues& sv) {
+      return std::make_pair(0.0, std::stod(any_cast<std::string>(sv[0])));
+    };
+
+    parser["NonEmptyVarList"] = [](const peg::SemanticValues& sv) {
+      auto vars = std::vector<std::string>();
+      for(std::size_t i = 0; i < sv.size(); i++) {
+        vars.push_back(any_cast<std::string>(sv[i]));
+      }
+      return vars;
+    };
+
+    parser["Name"] = [](const peg::SemanticValues& sv) { return sv.token(); };
+    parser["Number"] = [](const peg::SemanticValues& sv) {
+      return sv.token();
+    };
+  }
+
+  /*
+   * Returns the simplified pattern, or the pattern itself if it does not
+   * parse so that ptl_parser reports the error as usual.
+   */
+  std::string simplify(const std::string& pattern)
+  {
+    auto root = normalize(pattern);
+    if(root == nullptr) {
+      return pattern;
+    }
+    return print(*root);
+  }
+
+  // Returns the rewritten formula tree, or nullptr if the pattern does not parse
+  expr_ptr_t normalize(const std::string& pattern)
+  {
+    auto root = parse(pattern);
+    if(root == nullptr) {
+      return nullptr;
+    }
+    root = rewrite(root);
+    check(*root);
+    return root;
+  }
+
+  // Returns the value of a pattern that folds to a constant, if so
+  std::optional<bool> evaluate(const std::string& pattern)
+  {
+    auto root = parse(pattern);
+    if(root == nullptr) {
+      return std::nullopt;
+    }
+    root = rewrite(root);
+    if(root->kind == op::constant) {
+      return root->value;
+    }
+    return std::nullopt;
+  }
+
+  static expr_ptr_t rewrite(const expr_ptr_t& expr)
+  {
+    auto result = std::make_shared<expr_t>(*expr);
+    for(auto& arg : result->args) {
+      arg = rewrite(arg);
+    }
+
+    switch(result->kind) {
+      case op::negation:
+        return negate(result->args[0]);
+      case op::conjunction:
+      case op::disjunction:
+        return fold(result);
+      case op::implication:
+        return implication(result->args[0], result->args[1]);
+      case op::previous:
+        return previous(result);
+      case op::once:
+      case op::historically:
+        return temporal(result);
+      case op::since:
+        return since(result);
+      case op::exists:
+      case op::forall:
+        if(result->args[0]->kind == op::constant) {
+          return result->args[0];
+        }
+        return result;
+      default:
+        return result;
+    }
+  }
+
+  static std::string print(const expr_t& expr)
+  {
+    switch(expr.kind) {
+      case op::constant:
+        return expr.value ? "true" : "false";
+      case op::atom:
+        return expr.text;
+      case op::negation:
+        return "not " + operand(*expr.args[0]);
+      case op::conjunction:
+      case op::disjunction: {
+        auto sep = expr.kind == op::conjunction ? " and " : " or ";
+        std::string result = operand(*expr.args[0]);
+        for(std::size_t i = 1; i < expr.args.size(); i++) {
+          result += sep + operand(*expr.args[i]);
+        }
+        return result;
+      }
+      case op::implication:
+        return operand(*expr.args[0]) + " -> " + operand(*expr.args[1]);
+      case op::previous:
+        return "pre " + operand(*expr.args[0]);
+      case op::once:
+        return "once" + bound(expr) + " " + operand(*expr.args[0]);
+      case op::historically:
+        return "historically" + bound(expr) + " " + operand(*expr.args[0]);
+      case op::since:
+        return operand(*expr.args[0]) + " since" + bound(expr) + " " +
+               operand(*expr.args[1]);
+      case op::exists:
+      case op::forall: {
+        std::string result = expr.kind == op::exists ? "exists[" : "forall[";
+        for(std::size_t i = 0; i < expr.vars.size(); i++) {
+          result += (i > 0 ? ", " : "") + expr.vars[i];
+        }
+        return result + "]. (" + print(*expr.args[0]) + ")";
+      }
+    }
+    return "";
+  }
+
+ private:
+  static expr_ptr_t parse(const std::string& pattern)
+  {
+    expr_ptr_t root;
+    bool parsed = false;
+    {
+      auto& compiled = compiled_grammar<ptl_simplifier>::instance();
+      std::lock_guard<std::mutex> lock(compiled.mutex);
+      install(compiled.parser);
+      parsed = compiled.parser.parse(pattern.c_str(), root);
+    }
+    if(not parsed or root == nullptr) {
+      return nullptr;
+    }
+    return root;
+  }
+
+  static std::string trim(const std::string& str)
+  {
+    auto first = str.find_first_not_of(" \t\r\n");
+    auto last = str.find_last_not_of(" \t\r\n");
+    if(first == std::string::npos) {
+      return std::string();
+    }
+    return str.substr(first, last - first + 1);
+  }
+
+  static expr_ptr_t constant(bool value)
+  {
+    auto expr = std::make_shared<expr_t>();
+    expr->kind = op::constant;
+    expr->value = value;
+    return expr;
+  }
+
+  static expr_ptr_t unary(op kind, const expr_ptr_t& arg)
+  {
+    auto expr = std::make_shared<expr_t>();
+    expr->kind = kind;
+    expr->args.push_back(arg);
+    return expr;
+  }
+
+  static expr_ptr_t nary(op kind, const peg::SemanticValues& sv)
+  {
+    if(sv.size() == 1) {
+      return any_cast<expr_ptr_t>(sv[0]);
+    }
+    auto expr = std::make_shared<expr_t>();
+    expr->kind = kind;
+    for(std::size_t i = 0; i < sv.size(); i++) {
+      expr->args.push_back(any_cast<expr_ptr_t>(sv[i]));
+    }
+    return expr;
+  }
+
+  static expr_ptr_t quantifier(op kind, const peg::SemanticValues& sv)
+  {
+    auto expr = unary(kind, any_cast<expr_ptr_t>(sv[1]));
+    expr->vars = any_cast<std::vector<std::string>>(sv[0]);
+    return expr;
+  }
+
+  static void set_bound(expr_t& expr, const std::pair<double, double>& bound)
+  {
+    expr.lbound = bound.first;
+    if(bound.second > 0) {
+      expr.ubound = bound.second;
+    }
+  }
+
+  static bool is_constant(const expr_ptr_t& expr, bool value)
+  {
+    return expr->kind == op::constant and expr->value == value;
+  }
+
+  // Negation of an already simplified expression
+  static expr_ptr_t negate(const expr_ptr_t& expr)
+  {
+    switch(expr->kind) {
+      case op::constant:
+        return constant(not expr->value);
+      case op::negation:
+        return expr->args[0];
+      case op::once:
+      case op::historically: {
+        // Dual operators over the same window
+        auto result = std::make_shared<expr_t>(*expr);
+        result->kind = expr->kind == op::once ? op::historically : op::once;
+        result->args[0] = negate(expr->args[0]);
+        return temporal(result);
+      }
+      case op::implication:
+        return fold_args(
+          op::conjunction, {expr->args[0], negate(expr->args[1])});
+      case op::conjunction:
+      case op::disjunction: {
+        // De Morgan only if that does not add negations
+        std::size_t negations = 0;
+        for(const auto& arg : expr->args) {
+          negations += arg->kind == op::negation ? 1 : 0;
+        }
+        if(expr->args.size() - negations > negations) {
+          break;
+        }
+        auto args = std::vector<expr_ptr_t>();
+        for(const auto& arg : expr->args) {
+          args.push_back(negate(arg));
+        }
+        return fold_args(
+          expr->kind == op::conjunction ? op::disjunction : op::conjunction,
+          args);
+      }
+      default:
+        break;
+    }
+    return unary(op::negation, expr);
+  }
+
+  static expr_ptr_t fold(const expr_ptr_t& expr)
+  {
+    return fold_args(expr->kind, expr->args);
+  }
+
+  static expr_ptr_t fold_args(op kind, const std::vector<expr_ptr_t>& args)
+  {
+    bool absorbing = kind == op::disjunction;
+
+    auto result = std::make_shared<expr_t>();
+    result->kind = kind;
+
+    auto texts = std::vector<std::string>();
+    auto add = [&](const expr_ptr_t& arg) {
+      auto text = print(*arg);
+      if(std::find(texts.begin(), texts.end(), text) == texts.end()) {
+        texts.push_back(text);
+        result->args.push_back(arg);
+      }
+    };
+
+    for(const auto& arg : args) {
+      if(is_constant(arg, absorbing)) {
+        return arg;
+      }
+      if(is_constant(arg, not absorbing)) {
+        continue;
+      }
+      if(arg->kind == kind) {
+        for(const auto& item : arg->args) {
+          add(item);
+        }
+      }
+      else {
+        add(arg);
+      }
+    }
+
+    if(result->args.empty()) {
+      return constant(not absorbing);
+    }
+    if(result->args.size() == 1) {
+      return result->args[0];
+    }
+    return result;
+  }
+
+  static expr_ptr_t implication(const expr_ptr_t& lhs, const expr_ptr_t& rhs)
+  {
+    if(is_constant(lhs, false) or is_constant(rhs, true)) {
+      return constant(true);
+    }
+    if(is_constant(lhs, true)) {
+      return rhs;
+    }
+    if(is_constant(rhs, false)) {
+      return negate(lhs);
+    }
+    auto expr = std::make_shared<expr_t>();
+    expr->kind = op::implication;
+    expr->args = {lhs, rhs};
+    return expr;
+  }
+
+  static expr_ptr_t previous(const expr_ptr_t& expr)
+  {
+    if(is_constant(expr->args[0], false)) {
+      return expr->args[0];
+    }
+    return expr;
+  }
+
+  static expr_ptr_t temporal(const expr_ptr_t& expr)
+  {
+    const auto& arg = expr->args[0];
+    bool is_once = expr->kind == op::once;
+
+    // Operators hold or fail vacuously before their window starts
+    if(arg->kind == op::constant) {
+      if(arg->value == not is_once or expr->lbound == 0) {
+        return arg;
+      }
+      return expr;
+    }
+
+    // Windows add up under nested operators of the same kind
+    if(arg->kind == expr->kind) {
+      auto result = std::make_shared<expr_t>(*expr);
+      result->lbound = expr->lbound + arg->lbound;
+      result->ubound = expr->ubound + arg->ubound;
+      result->args = arg->args;
+      return result;
+    }
+    return expr;
+  }
+
+  static expr_ptr_t since(const expr_ptr_t& expr)
+  {
+    const auto& lhs = expr->args[0];
+    const auto& rhs = expr->args[1];
+
+    if(is_constant(rhs, false)) {
+      return rhs;
+    }
+    if(expr->lbound == 0 and rhs->kind == op::constant) {
+      return rhs;
+    }
+    if(is_constant(lhs, false)) {
+      // Only the current point may satisfy the right operand
+      return expr->lbound == 0 ? rhs : constant(false);
+    }
+    if(is_constant(lhs, true)) {
+      auto result = std::make_shared<expr_t>(*expr);
+      result->kind = op::once;
+      result->args = {rhs};
+      return temporal(result);
+    }
+    return expr;
+  }
+
+  // Rejects constants that have no counterpart in networks
+  static void check(const expr_t& expr)
+  {
+    if(expr.kind == op::constant) {
+      throw std::invalid_argument(
+        "Constant subformulas are not supported unless they simplify away");
+    }
+    for(const auto& arg : expr.args) {
+      check(*arg);
+    }
+  }
+
+  // Shortest text that reads back as the same value, without an exponent
+  // as the grammar has none
+  static std::string number(double value)
+  {
+    std::array<char, 512> buffer{};
+    auto result = std::to_chars(
+      buffer.data(), buffer.data() + buffer.size(), value,
+      std::chars_format::fixed);
+    return std::string(buffer.data(), result.ptr);
+  }
+
+  static std::string bound(const expr_t& expr)
+  {
+    if(expr.is_unbounded()) {
+      return "";
+    }
+    if(std::isinf(expr.ubound)) {
+      return "[" + number(expr.lbound) + ":]";
+    }
+    return "[" + number(expr.lbound) + ":" + number(expr.ubound) + "]";
+  }
+
+  static std::string operand(const expr_t& expr)
+  {
+    if(expr.kind == op::atom or expr.kind == op::constant) {
+      return expr.text.empty() ? print(expr) : expr.text;
+    }
+    return "(" + print(expr) + ")";
+  }
+};
+
+}  // namespace reelay
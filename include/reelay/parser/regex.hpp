@@ -5,269 +5,307 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
- 
+
 #pragma once
 
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 #define PEGLIB_USE_STD_ANY 0
-#include "reelay/third_party/peglib.h"
+#include "reelay/third_party/cpp-peglib/peglib.h"
 
-#include "reelay/networks.hpp"
-#include "reelay/settings.hpp"
+#include "reelay/common.hpp"
 
 namespace reelay {
 
-template <class Setting> struct regex_parser {
-
-  using time_t = typename Setting::time_t;
-  using input_t = typename Setting::input_t;
-  using output_t = typename Setting::output_t;
-  using function_t = typename Setting::function_t;
-
-  using node_t = typename Setting::node_t;
-  using state_t = typename Setting::state_t;
-  using network_t = typename Setting::network_t;
+/*
+ * Regular expression tree. Letters keep the text of a PTL boolean formula
+ * over record propositions (`true` for `{*}`), which decides whether an event
+ * is an occurrence of the letter. Repetitions keep their bounds with the
+ * largest value of uint64_t for unbounded repetitions.
+ */
+struct regex_expression {
+  enum class op {
+    letter,
+    concatenation,
+    alternation,
+    intersection,
+    star,
+    plus,
+    option,
+    repetition
+  };
+
+  using ptr_t = std::shared_ptr<regex_expression>;
+
+  static constexpr uint64_t unbounded = std::numeric_limits<uint64_t>::max();
+
+  op kind = op::letter;
+  std::string text;  // letter
+  uint64_t lbound = 0;
+  uint64_t ubound = unbounded;
+  std::vector<ptr_t> args;
+};
 
-  using node_ptr_t = typename Setting::node_ptr_t;
-  using state_ptr_t = typename Setting::state_ptr_t;
+/*
+ * Parser of regular expressions over record propositions.
+ *
+ * Record propositions are written as in PTL and combined into letters with
+ * `!`, `&&` and `||`. Letters are followed one after another by juxtaposition
+ * (or `;`) and combined with `|` (alternation), `&` (intersection), `*`, `+`,
+ * `?` and bounded repetitions `[m:n]`, `[m:]` and `[:n]`, which match between
+ * m and n consecutive matches of the group. For example,
+ *
+ *   {door_open} {*}[:3] {alarm}
+ *
+ * matches a door opening followed by an alarm at most four events later.
+ */
+struct regex_parser {
+  using expr_t = regex_expression;
+  using op = regex_expression::op;
+  using expr_ptr_t = regex_expression::ptr_t;
+  using bound_t = std::pair<uint64_t, uint64_t>;
 
   static constexpr auto grammar = R"(
     Expression  <- Disjunctive
     Disjunctive <- Conjunctive (REG_OR Conjunctive)*
     Conjunctive <- SequenceExpr (REG_AND SequenceExpr)*
     SequenceExpr <- RegularUnary (REG_CAT? RegularUnary)*
-    
-    RegularUnary <- RegularStar / RegularPlus / RegularOption / RegularBounded /BooleanExpression / RegularGrouping
+
+    RegularUnary <- RegularStar / RegularPlus / RegularOption / RegularBounded / BooleanExpression / RegularGrouping
     RegularStar <- BooleanExpression STAR / LPARAM Expression RPARAM STAR
     RegularPlus <- BooleanExpression PLUS / LPARAM Expression RPARAM PLUS
     RegularOption <- BooleanExpression QMARK / LPARAM Expression RPARAM QMARK
     RegularBounded <- BooleanExpression TimeBound / LPARAM Expression RPARAM TimeBound
     RegularGrouping <- LPARAM Expression RPARAM
-    
+
     BooleanExpression  <- BoolDisjunctive
     BoolDisjunctive <- BoolConjunctive (LOR BoolConjunctive)*
     BoolConjunctive <- BooleanUnary (LAND BooleanUnary)*
-    
+
     BooleanUnary <- BoolNegative / BooleanAtom / LPARAM BooleanExpression RPARAM
     BoolNegative <- LNOT BooleanAtom / LNOT LPARAM BooleanExpression RPARAM
-    BooleanAtom <- RecordProposition / AnyRecord
+    BooleanAtom <- AnyRecord / RecordProposition
 
     AnyRecord <- LCURLY STAR RCURLY
-    RecordProposition <- LCURLY NonEmptyKeyValuePairs RCURLY
-
-    NonEmptyKeyValuePairs <- KeyValuePair (COMMA KeyValuePair)*
-
-    FieldKey <- Name (DOT Name)*
-    FieldValue <- Bool / SQString / DQString / Name / Number / VariableRef / AnyValue 
-    KeyValuePair <- KeyValuePairST / KeyValuePairEQ / KeyValuePairNE / KeyValuePairLT / KeyValuePairLE / KeyValuePairGT / KeyValuePairGE
-    
-    KeyValuePairST <- FieldKey ':' FieldValue
-    KeyValuePairEQ <- FieldKey '==' Number
-    KeyValuePairNE <- FieldKey '!=' Number
-    KeyValuePairLT <- FieldKey '<' Number
-    KeyValuePairLE <- FieldKey '<=' Number
-    KeyValuePairGT <- FieldKey '>' Number
-    KeyValuePairGE <- FieldKey '>=' Number
-    
-    AnyValue <- STAR
-    VariableRef <- STAR Name
+    RecordProposition <- < (Name '::')* Braces >
+    Braces <- '{' (Braces / [^{}])* '}'
 
     TimeBound <- FullBound / LowerBound / UpperBound
     FullBound <-  "[" Number ":" Number "]"
     LowerBound <- "[" Number ":" 'inf'? "]"
     UpperBound <- "["        ":" Number "]"
-    
-    ~REG_OR   <- < "|" / 'or'>
-    ~REG_AND  <- < "&" / 'and'>
+
+    ~REG_OR   <- < !LOR "|" / 'or' >
+    ~REG_AND  <- < !LAND "&" / 'and' >
     ~REG_CAT  <- < ';' >
-    
+
     ~LOR      <- < "||" >
     ~LAND     <- < "&&" >
     ~LNOT     <- < "!" >
-    ~LIMPLIES <- < "->" / 'implies' >
 
-    ~COMMA <- < ',' >
     ~LPARAM <- < '(' >
     ~RPARAM <- < ')' >
-    ~LBRACE <- < '[' >
-    ~RBRACE <- < ']' >
     ~LCURLY <- < '{' >
     ~RCURLY <- < '}' >
-    
-    ~DOT <- < '.' >
-    ~THREEDOT <- < '...' >
+
     ~STAR <- < '*' >
     ~PLUS <- < '+' >
     ~QMARK <- < '?' >
-    ~AMSAND <- < '&' >
-    ~DOLLAR <- < '$' >
-    ~SQUARE <- < '#' >
-    
+
     Name   <- <[_a-zA-Z][_a-zA-Z0-9]*>
-    SQString <- "'" < [^']* > "'"
-    DQString <- '"' < [^"]* > '"'
-    Number <- <'-'? [0-9]+ ('.' [0-9]+)?>
-    Bool <- TRUE / FALSE
-    ~TRUE  <- < 'true'>
-    ~FALSE <- < 'false'>      
+    Number <- <[0-9]+>
 
     %whitespace <- [  \t\r\n]*
     )";
 
-  peg::parser parser;
-  reelay::kwargs meta;
-
-  std::vector<state_ptr_t> states = std::vector<state_ptr_t>();
-
-  explicit regex_parser(const reelay::kwargs &kw = reelay::kwargs())
-      : meta(kw) {
+  // Returns the expression tree, or throws std::invalid_argument
+  expr_ptr_t parse(const std::string& pattern) const
+  {
+    static std::mutex mutex;
+    static peg::parser parser = make_parser();
+
+    expr_ptr_t root;
+    bool parsed = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      parsed = parser.parse(pattern.c_str(), root);
+    }
+    if(not parsed or root == nullptr) {
+      throw std::invalid_argument("Invalid regular expression: " + pattern);
+    }
+    return root;
+  }
 
-    parser = peg::parser(grammar);
-    parser.log = [](size_t line, size_t col, const std::string &msg) {
+ private:
+  static peg::parser make_parser()
+  {
+    auto parser = peg::parser(grammar);
+    parser.log = [](size_t line, size_t col, const std::string& msg) {
       std::cerr << line << ":" << col << ": " << msg << std::endl;
     };
 
-    parser["RecordProposition"] = [&](const peg::SemanticValues &sv) {
-      auto fields = any_cast<std::vector<
-          std::pair<std::string, std::pair<std::string, std::string>>>>(sv[0]);
-
-      reelay::kwargs kw = {{"fields", fields}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_state("record", kw);
+    parser["Disjunctive"] = [](const peg::SemanticValues& sv) {
+      return nary(op::alternation, sv);
+    };
 
-      this->states.push_back(expr);
-      return std::static_pointer_cast<node_t>(expr);
+    parser["Conjunctive"] = [](const peg::SemanticValues& sv) {
+      return nary(op::intersection, sv);
     };
 
-    parser["NonEmptyKeyValuePairs"] = [&](const peg::SemanticValues &sv) {
-      auto keyvals = std::vector<
-          std::pair<std::string, std::pair<std::string, std::string>>>();
+    parser["SequenceExpr"] = [](const peg::SemanticValues& sv) {
+      return nary(op::concatenation, sv);
+    };
 
-      for (std::size_t i = 0; i < sv.size(); i++) {
-        auto child = any_cast<
-            std::pair<std::string, std::pair<std::string, std::string>>>(sv[i]);
-        keyvals.push_back(child);
+    parser["RegularUnary"] = [](const peg::SemanticValues& sv) {
+      if(sv.choice() == 4) {
+        return letter(any_cast<std::string>(sv[0]));
       }
+      return any_cast<expr_ptr_t>(sv[0]);
+    };
 
-      return keyvals;
+    parser["RegularStar"] = [](const peg::SemanticValues& sv) {
+      return unary(op::star, operand(sv));
     };
 
-    parser["VariableRef"] = [&](const peg::SemanticValues &sv) {
-      return std::pair<std::string, std::string>("variable_ref",
-                                                 any_cast<std::string>(sv[0]));
+    parser["RegularPlus"] = [](const peg::SemanticValues& sv) {
+      return unary(op::plus, operand(sv));
     };
 
-    parser["UnnamedRef"] = [&](const peg::SemanticValues &) {
-      return std::pair<std::string, std::string>("ignore_field","");
+    parser["RegularOption"] = [](const peg::SemanticValues& sv) {
+      return unary(op::option, operand(sv));
     };
 
-    parser["FieldKey"] = [&](const peg::SemanticValues &sv) {
-      auto keys = std::vector<std::string>();
-      for (std::size_t i = 0; i < sv.size(); i++) {
-        keys.push_back(any_cast<std::string>(sv[i]));
+    parser["RegularBounded"] = [](const peg::SemanticValues& sv) {
+      auto expr = unary(op::repetition, operand(sv));
+      auto [lbound, ubound] = any_cast<bound_t>(sv[1]);
+      if(lbound > ubound) {
+        throw peg::parse_error("Empty repetition bounds");
       }
-      return keys;
+      expr->lbound = lbound;
+      expr->ubound = ubound;
+      return expr;
     };
 
-    parser["KeyValuePair"] = [&](const peg::SemanticValues &sv) {
-      auto key_path = any_cast<std::vector<std::string>>(sv[0]);
-      auto value = any_cast<std::pair<std::string, std::string>>(sv[1]);
-      auto key = key_path[0];
-      for (std::size_t i = 1; i < key_path.size(); i++) {
-        key += '/'+ key_path[i];
-      }
-      return std::pair<std::string, std::pair<std::string, std::string>>(key, value);
+    parser["RegularGrouping"] = [](const peg::SemanticValues& sv) {
+      return any_cast<expr_ptr_t>(sv[0]);
     };
 
-    parser["BoolNegative"] = [&](const peg::SemanticValues &sv) {
-      node_ptr_t child = any_cast<node_ptr_t>(sv[0]);
-      auto args = std::vector<node_ptr_t>({child});
+    // Letters are PTL formulas without temporal operators
+    parser["BoolDisjunctive"] = [](const peg::SemanticValues& sv) {
+      return join(sv, " or ");
+    };
 
-      reelay::kwargs kw = {{"args", args}};
-      kw.insert(meta.begin(), meta.end());
-      auto expr = Setting::make_node("negation", kw);
+    parser["BoolConjunctive"] = [](const peg::SemanticValues& sv) {
+      return join(sv, " and ");
+    };
 
-      return std::static_pointer_cast<node_t>(expr);
+    parser["BooleanUnary"] = [](const peg::SemanticValues& sv) {
+      return any_cast<std::string>(sv[0]);
     };
 
-    parser["BoolDisjunctive"] = [&](const peg::SemanticValues &sv) {
-      // Rule:
-      if (sv.size() > 1) {
-        std::vector<node_ptr_t> args;
-        for (size_t i = 0; i < sv.size(); i++) {
-          node_ptr_t child = any_cast<node_ptr_t>(sv[i]);
-          args.push_back(child);
-        }
-
-        reelay::kwargs kw = {{"args", args}};
-        kw.insert(meta.begin(), meta.end());
-        auto expr = Setting::make_node("disjunction", kw);
-
-        return std::static_pointer_cast<node_t>(expr);
-      } else {
-        node_ptr_t child = any_cast<node_ptr_t>(sv[0]);
-        return child;
-      }
+    parser["BoolNegative"] = [](const peg::SemanticValues& sv) {
+      return "not (" + any_cast<std::string>(sv[0]) + ")";
     };
 
-    parser["BoolConjunctive"] = [&](const peg::SemanticValues &sv) {
-      // Rule:
-      if (sv.size() > 1) {
-        std::vector<node_ptr_t> args;
-        for (size_t i = 0; i < sv.size(); i++) {
-          node_ptr_t child = any_cast<node_ptr_t>(sv[i]);
-          args.push_back(child);
-        }
-
-        reelay::kwargs kw = {{"args", args}};
-        kw.insert(meta.begin(), meta.end());
-        auto expr = Setting::make_node("conjunction", kw);
-
-        return std::static_pointer_cast<node_t>(expr);
-      } else {
-        node_ptr_t child = any_cast<node_ptr_t>(sv[0]);
-        return child;
-      }
+    parser["BooleanAtom"] = [](const peg::SemanticValues& sv) {
+      return any_cast<std::string>(sv[0]);
     };
 
-    parser["FullBound"] = [](const peg::SemanticValues &sv) {
-      float l = std::stof(any_cast<std::string>(sv[0]));
-      float u = std::stof(any_cast<std::string>(sv[1]));
-      return std::make_pair(l, u);
+    parser["AnyRecord"] = [](const peg::SemanticValues&) {
+      return std::string("true");
     };
 
-    parser["LowerBound"] = [](const peg::SemanticValues &sv) {
-      float l = std::stof(any_cast<std::string>(sv[0]));
-      return std::make_pair(l, 0.0f);
+    parser["RecordProposition"] = [](const peg::SemanticValues& sv) {
+      return sv.token();
     };
 
-    parser["UpperBound"] = [](const peg::SemanticValues &sv) {
-      float u = std::stof(any_cast<std::string>(sv[0]));
-      return std::make_pair(0.0f, u);
+    parser["TimeBound"] = [](const peg::SemanticValues& sv) {
+      return any_cast<bound_t>(sv[0]);
     };
 
-    parser["Name"] = [](const peg::SemanticValues &sv) { return sv.token(); };
-    parser["SQString"] = [](const peg::SemanticValues &sv) {
-      return sv.token();
+    parser["FullBound"] = [](const peg::SemanticValues& sv) {
+      return bound_t(number(sv[0]), number(sv[1]));
     };
-    parser["DQString"] = [](const peg::SemanticValues &sv) {
+
+    parser["LowerBound"] = [](const peg::SemanticValues& sv) {
+      return bound_t(number(sv[0]), expr_t::unbounded);
+    };
+
+    parser["UpperBound"] = [](const peg::SemanticValues& sv) {
+      return bound_t(0, number(sv[0]));
+    };
+
+    parser["Number"] = [](const peg::SemanticValues& sv) {
       return sv.token();
     };
-    parser["Number"] = [](const peg::SemanticValues &sv) { return sv.token(); };
-    parser["Bool"] = [](const peg::SemanticValues &sv) { return sv.token(); };
 
-    parser.enable_packrat_parsing(); // Enable packrat parsing.
+    parser.enable_packrat_parsing();
+    return parser;
+  }
+
+  static uint64_t number(const reelay::any& value)
+  {
+    return std::stoull(any_cast<std::string>(value));
+  }
+
+  static expr_ptr_t letter(const std::string& text)
+  {
+    auto expr = std::make_shared<expr_t>();
+    expr->kind = op::letter;
+    expr->text = text;
+    return expr;
   }
 
-  std::shared_ptr<network_t> parse(const std::string &pattern) {
-    node_ptr_t output_func;
-    parser.parse(pattern.c_str(), output_func);
+  static expr_ptr_t unary(op kind, const expr_ptr_t& arg)
+  {
+    auto expr = std::make_shared<expr_t>();
+    expr->kind = kind;
+    expr->args.push_back(arg);
+    return expr;
+  }
+
+  // Grouped operands are trees, the others are letters
+  static expr_ptr_t operand(const peg::SemanticValues& sv)
+  {
+    if(sv.choice() == 0) {
+      return letter(any_cast<std::string>(sv[0]));
+    }
+    return any_cast<expr_ptr_t>(sv[0]);
+  }
+
+  static expr_ptr_t nary(op kind, const peg::SemanticValues& sv)
+  {
+    if(sv.size() == 1) {
+      return any_cast<expr_ptr_t>(sv[0]);
+    }
+    auto expr = std::make_shared<expr_t>();
+    expr->kind = kind;
+    for(const auto& value : sv) {
+      expr->args.push_back(any_cast<expr_ptr_t>(value));
+    }
+    return expr;
+  }
 
-    auto network = std::make_shared<network_t>(output_func, states);
-    return network;
+  static std::string join(const peg::SemanticValues& sv, const char* sep)
+  {
+    if(sv.size() == 1) {
+      return any_cast<std::string>(sv[0]);
+    }
+    std::string result;
+    for(std::size_t i = 0; i < sv.size(); i++) {
+      result += (i > 0 ? sep : "") + ("(" + any_cast<std::string>(sv[i]) + ")");
+    }
+    return result;
   }
 };
 
-} // namespace reelay
\ No newline at end of file
+}  // namespace reelay
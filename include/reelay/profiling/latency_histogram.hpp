@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2019-2025 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace reelay {
+
+/*
+ * Log-linear histogram of non-negative integer values such as latencies in
+ * nanoseconds, in the manner of HDR histograms.
+ *
+ * Values below 2^(precision + 1) are counted exactly. Larger values share a
+ * bucket with others of the same magnitude, 2^precision buckets per power of
+ * two, so a reported value is within 2^-precision of the recorded one (less
+ * than 1% with the default precision). Recording is a few integer operations
+ * and the memory is fixed, about 60 KiB by default, whatever the range.
+ */
+struct latency_histogram {
+  explicit latency_histogram(unsigned precision = 7)
+      : bits(precision),
+        sub_buckets(uint64_t(1) << precision),
+        counts((65 - precision) * sub_buckets, 0)
+  {
+  }
+
+  void record(uint64_t value)
+  {
+    counts[index(value)]++;
+    total++;
+    sum += static_cast<double>(value);
+    smallest = std::min(smallest, value);
+    largest = std::max(largest, value);
+  }
+
+  void merge(const latency_histogram& other)
+  {
+    if(other.bits != bits) {
+      throw std::invalid_argument("Histograms differ in precision");
+    }
+    for(std::size_t i = 0; i < counts.size(); i++) {
+      counts[i] += other.counts[i];
+    }
+    total += other.total;
+    sum += other.sum;
+    smallest = std::min(smallest, other.smallest);
+    largest = std::max(largest, other.largest);
+  }
+
+  uint64_t count() const
+  {
+    return total;
+  }
+
+  uint64_t min() const
+  {
+    return total == 0 ? 0 : smallest;
+  }
+
+  uint64_t max() const
+  {
+    return largest;
+  }
+
+  double mean() const
+  {
+    return total == 0 ? 0.0 : sum / static_cast<double>(total);
+  }
+
+  // Smallest value such that a `quantile` fraction of records are not larger,
+  // up to bucket precision and never above the largest record
+  uint64_t value_at(double quantile) const
+  {
+    if(total == 0) {
+      return 0;
+    }
+    quantile = std::clamp(quantile, 0.0, 1.0);
+    auto rank = static_cast<uint64_t>(
+      std::ceil(quantile * static_cast<double>(total)));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for(std::size_t i = 0; i < counts.size(); i++) {
+      seen += counts[i];
+      if(seen >= rank) {
+        return std::min(highest_equivalent(i), largest);
+      }
+    }
+    return largest;
+  }
+
+  void reset()
+  {
+    std::fill(counts.begin(), counts.end(), 0);
+    total = 0;
+    sum = 0.0;
+    smallest = std::numeric_limits<uint64_t>::max();
+    largest = 0;
+  }
+
+ private:
+  unsigned bits;
+  uint64_t sub_buckets;
+  std::vector<uint64_t> counts;
+  uint64_t total = 0;
+  double sum = 0.0;
+  uint64_t smallest = std::numeric_limits<uint64_t>::max();
+  uint64_t largest = 0;
+
+  std::size_t index(uint64_t value) const
+  {
+    if(value < 2 * sub_buckets) {
+      return static_cast<std::size_t>(value);
+    }
+    unsigned magnitude = 63 - static_cast<unsigned>(__builtin_clzll(value));
+    unsigned shift = magnitude - bits;
+    return static_cast<std::size_t>(
+      (shift + 1) * sub_buckets + (value >> shift) - sub_buckets);
+  }
+
+  uint64_t lowest_equivalent(std::size_t i) const
+  {
+    if(i < 2 * sub_buckets) {
+      return i;
+    }
+    uint64_t shift = i / sub_buckets - 1;
+    return (i % sub_buckets + sub_buckets) << shift;
+  }
+
+  uint64_t highest_equivalent(std::size_t i) const
+  {
+    if(i < 2 * sub_buckets) {
+      return i;
+    }
+    uint64_t shift = i / sub_buckets - 1;
+    return lowest_equivalent(i) + ((uint64_t(1) << shift) - 1);
+  }
+};
+
+}  // namespace reelay
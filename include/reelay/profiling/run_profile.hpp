@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2019-2025 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "reelay/json.hpp"
+#include "reelay/profiling/latency_histogram.hpp"
+
+namespace reelay {
+
+/*
+ * Throughput and latency figures of a monitoring run.
+ *
+ * Apps measure each event with `measure_event`, which records the time spent
+ * in the monitor into the latency histogram, and the surrounding work with
+ * `measure`, which accumulates parse and output time separately. Output that
+ * happens inside a monitor call, such as writing verdicts from a sink, is
+ * moved from the event to the output phase so that latencies cover monitoring
+ * alone. Each measurement reads a steady clock twice, which costs a few tens
+ * of nanoseconds per event, so apps profile only on request.
+ */
+struct run_profile {
+  using clock = std::chrono::steady_clock;
+
+  enum class phase : uint8_t { parse = 0, monitor = 1, output = 2 };
+
+  latency_histogram latency;  // nanoseconds in the monitor per event
+  uint64_t events = 0;
+  uint64_t bytes = 0;
+  uint64_t verdicts = 0;
+
+  run_profile() : started(clock::now()), finished(started) {}
+
+  template<typename FunctionT>
+  void measure_event(FunctionT&& fn)
+  {
+    uint64_t output_before = spent(phase::output);
+    auto start = clock::now();
+    fn();
+    uint64_t ns = since(start);
+    uint64_t output_during = spent(phase::output) - output_before;
+    ns = ns > output_during ? ns - output_during : 0;
+
+    latency.record(ns);
+    phases[index(phase::monitor)] += ns;
+    events++;
+  }
+
+  template<typename FunctionT>
+  void measure(phase kind, FunctionT&& fn)
+  {
+    auto start = clock::now();
+    fn();
+    phases[index(kind)] += since(start);
+  }
+
+  // Adds the time since `start` to a phase, for work that is not a callable
+  // such as advancing a document stream
+  void charge(phase kind, clock::time_point start)
+  {
+    phases[index(kind)] += since(start);
+  }
+
+  // Nanoseconds accumulated in a phase
+  uint64_t spent(phase kind) const
+  {
+    return phases[index(kind)];
+  }
+
+  // Marks the end of the run for throughput figures
+  void stop()
+  {
+    finished = clock::now();
+  }
+
+  double seconds() const
+  {
+    return std::chrono::duration<double>(finished - started).count();
+  }
+
+  reelay::json report() const
+  {
+    auto rate = [](double amount, double seconds) {
+      return seconds > 0 ? amount / seconds : 0.0;
+    };
+    auto in_seconds = [](uint64_t ns) { return static_cast<double>(ns) * 1e-9; };
+
+    double total = seconds();
+    double monitoring = in_seconds(spent(phase::monitor));
+    return reelay::json({
+      {"events", events},
+      {"bytes", bytes},
+      {"verdicts", verdicts},
+      {"seconds",
+       {{"total", total},
+        {"parse", in_seconds(spent(phase::parse))},
+        {"monitor", monitoring},
+        {"output", in_seconds(spent(phase::output))}}},
+      {"events_per_second", rate(double(events), total)},
+      {"bytes_per_second", rate(double(bytes), total)},
+      {"monitor_events_per_second", rate(double(events), monitoring)},
+      {"latency_ns",
+       {{"min", latency.min()},
+        {"mean", latency.mean()},
+        {"p50", latency.value_at(0.5)},
+        {"p90", latency.value_at(0.9)},
+        {"p99", latency.value_at(0.99)},
+        {"p999", latency.value_at(0.999)},
+        {"max", latency.max()}}},
+    });
+  }
+
+  void write(std::ostream& os) const
+  {
+    os << report().dump() << std::endl;
+  }
+
+ private:
+  clock::time_point started;
+  clock::time_point finished;
+  std::array<uint64_t, 3> phases = {0, 0, 0};
+
+  static std::size_t index(phase kind)
+  {
+    return static_cast<std::size_t>(kind);
+  }
+
+  static uint64_t since(clock::time_point start)
+  {
+    return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        clock::now() - start)
+        .count());
+  }
+};
+
+}  // namespace reelay
@@ -20,7 +20,7 @@
 namespace reelay {
 namespace dense_timed_setting {
 
-template <typename X, typename T, typename K = std::string>
+template <typename X, typename T, typename K = datafield_key_t<X>>
 struct atomic_any final : public dense_timed_state<X, interval_set<T>, T> {
   using key_t = K;
   using input_t = X;
@@ -58,7 +58,14 @@ struct atomic_any final : public dense_timed_state<X, interval_set<T>, T> {
   }
 
   output_t output(time_t previous, time_t now) override {
-    return value & interval::left_open(previous, now);
+    return output_ref(previous, now);
+  }
+
+  const output_t &output_ref(time_t previous, time_t now) override {
+    this->segment.clear();
+    boost::icl::add_intersection(this->segment, value,
+                                 interval::left_open(previous, now));
+    return this->segment;
   }
 };
 
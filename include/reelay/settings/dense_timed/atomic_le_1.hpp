@@ -20,7 +20,7 @@
 namespace reelay {
 namespace dense_timed_setting {
 
-template <typename X, typename T, typename K = std::string>
+template <typename X, typename T, typename K = datafield_key_t<X>>
 struct atomic_le_1 final : public dense_timed_state<X, interval_set<T>, T> {
   using key_t = K;
   using input_t = X;
@@ -76,6 +76,8 @@ struct atomic_le_1 final : public dense_timed_state<X, interval_set<T>, T> {
   output_t output(time_t previous, time_t now) override {
     return value;
   }
+
+  const output_t &output_ref(time_t, time_t) override { return value; }
 };
 
 } // namespace dense_timed_setting
@@ -24,31 +24,44 @@ struct atomic_map final : public dense_timed_state<X, interval_set<T>, T> {
   using output_t = reelay::interval_set<time_t>;
 
   using node_t = dense_timed_node<output_t, time_t>;
+  using state_t = dense_timed_state<input_t, output_t, time_t>;
+
   using node_ptr_t = std::shared_ptr<node_t>;
+  using state_ptr_t = std::shared_ptr<state_t>;
 
   using interval = reelay::interval<time_t>;
   using interval_set = reelay::interval_set<time_t>;
 
   output_t value = interval_set();
 
-  std::vector<node_ptr_t> mappings;
+  std::vector<state_ptr_t> mappings;
 
-  explicit atomic_map(const std::vector<node_ptr_t> &nodeptrs)
-      : mappings(nodeptrs) {}
+  explicit atomic_map(const std::vector<state_ptr_t> &stateptrs)
+      : mappings(stateptrs) {}
 
   explicit atomic_map(const kwargs &kw)
-      : atomic_map(reelay::any_cast<std::vector<node_ptr_t>>(kw.at("args"))) {}
+      : atomic_map(reelay::any_cast<std::vector<state_ptr_t>>(kw.at("args"))) {}
 
-  void update(const input_t &, const input_t &, time_t previous,
+  void update(const input_t &pargs, const input_t &args, time_t previous,
               time_t now) override {
-    value = mappings[0]->output(previous, now);
+    for (const auto &mapping : mappings) {
+      mapping->update(pargs, args, previous, now);
+    }
+    value = mappings[0]->output_ref(previous, now);
     for (size_t i = 1; i < mappings.size(); i++) {
-      value = value & mappings[i]->output(previous, now);
+      value &= mappings[i]->output_ref(previous, now);
     }
   }
 
   output_t output(time_t previous, time_t now) override {
-    return value & interval::left_open(previous, now);
+    return output_ref(previous, now);
+  }
+
+  const output_t &output_ref(time_t previous, time_t now) override {
+    this->segment.clear();
+    boost::icl::add_intersection(this->segment, value,
+                                 interval::left_open(previous, now));
+    return this->segment;
   }
 };
 
@@ -20,7 +20,7 @@
 namespace reelay {
 namespace dense_timed_setting {
 
-template <typename X, typename T, typename K = std::string>
+template <typename X, typename T, typename K = datafield_key_t<X>>
 struct atomic_string final : public dense_timed_state<X, interval_set<T>, T> {
   using key_t = K;
   using input_t = X;
@@ -53,7 +53,7 @@ struct atomic_string final : public dense_timed_state<X, interval_set<T>, T> {
       return; // Do nothing if the key does not exist - existing value persists
     }
 
-    std::string new_data = datafield<input_t>::as_string(args, key);
+    auto new_data = string_field(args, key);
 
     value = value & interval::left_open(previous, now);
     if (new_data == constant) {
@@ -62,7 +62,14 @@ struct atomic_string final : public dense_timed_state<X, interval_set<T>, T> {
   }
 
   output_t output(time_t previous, time_t now) override {
-    return value & interval::left_open(previous, now);
+    return output_ref(previous, now);
+  }
+
+  const output_t &output_ref(time_t previous, time_t now) override {
+    this->segment.clear();
+    boost::icl::add_intersection(this->segment, value,
+                                 interval::left_open(previous, now));
+    return this->segment;
   }
 };
 
@@ -12,6 +12,7 @@
 
 #include "reelay/intervals.hpp"
 #include "reelay/networks/basic_structure.hpp"
+#include "reelay/networks/segment_sweep.hpp"
 
 namespace reelay {
 namespace dense_timed_setting {
@@ -30,17 +31,35 @@ struct conjunction final : public dense_timed_node<interval_set<T>, T> {
 
   std::vector<node_ptr_t> args;
 
+  segment_sweep<output_t> sweep;
+
   explicit conjunction(const std::vector<node_ptr_t> &args) : args(args) {}
 
   explicit conjunction(const kwargs &kw)
       : conjunction(reelay::any_cast<std::vector<node_ptr_t>>(kw.at("args"))) {}
 
   output_t output(time_t previous, time_t now) {
-    interval_set result = args[0]->output(previous, now);
-    for (size_t i = 1; i < args.size(); i++) {
-      result = result & args[i]->output(previous, now);
+    return output_ref(previous, now);
+  }
+
+  const output_t &output_ref(time_t previous, time_t now) override {
+    // Sweep all operands at once instead of combining them pairwise
+    sweep.clear();
+    for (const auto &arg : args) {
+      sweep.add(arg->output_ref(previous, now));
     }
-    return result;
+
+    this->segment.clear();
+    sweep.run(previous, now, [this](time_t begin, time_t end) {
+      if (sweep.all()) {
+        this->segment.add(interval::left_open(begin, end));
+      }
+    });
+    return this->segment;
+  }
+
+  std::optional<bool> decided() const override {
+    return decided_fold(args, false);
   }
 };
 
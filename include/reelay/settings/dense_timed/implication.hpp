@@ -38,9 +38,27 @@ struct implication final : public dense_timed_node<interval_set<T>, T> {
       : implication(reelay::any_cast<std::vector<node_ptr_t>>(kw.at("args"))) {}
 
   output_t output(time_t previous, time_t now) {
-    return (interval_set(interval::left_open(previous, now)) -
-            arg1->output(previous, now)) |
-           arg2->output(previous, now);
+    return output_ref(previous, now);
+  }
+
+  const output_t &output_ref(time_t previous, time_t now) override {
+    this->segment.clear();
+    this->segment.add(interval::left_open(previous, now));
+    this->segment -= arg1->output_ref(previous, now);
+    this->segment += arg2->output_ref(previous, now);
+    return this->segment;
+  }
+
+  std::optional<bool> decided() const override {
+    auto value1 = arg1->decided();
+    auto value2 = arg2->decided();
+    if (value1 == false or value2 == true) {
+      return true;
+    }
+    if (value1 and value2) {
+      return false;  // Both decided and the antecedent holds
+    }
+    return std::nullopt;
   }
 };
 
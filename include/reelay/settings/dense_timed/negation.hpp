@@ -36,8 +36,22 @@ struct negation final : public dense_timed_node<interval_set<T>, T> {
       : negation(reelay::any_cast<std::vector<node_ptr_t>>(kw.at("args"))) {}
 
   output_t output(time_t previous, time_t now) {
-    return interval_set(interval::left_open(previous, now)) -
-           arg1->output(previous, now);
+    return output_ref(previous, now);
+  }
+
+  const output_t &output_ref(time_t previous, time_t now) override {
+    this->segment.clear();
+    this->segment.add(interval::left_open(previous, now));
+    this->segment -= arg1->output_ref(previous, now);
+    return this->segment;
+  }
+
+  std::optional<bool> decided() const override {
+    auto value = arg1->decided();
+    if (value) {
+      return not *value;
+    }
+    return std::nullopt;
   }
 };
 
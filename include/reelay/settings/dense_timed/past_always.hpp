@@ -47,7 +47,7 @@ struct past_always final : public dense_timed_state<X, interval_set<T>, T> {
     }
 
     auto complement = interval_set(interval::left_open(previous, now)) -
-                      first->output(previous, now);
+                      first->output_ref(previous, now);
 
     if (complement.size() == 0) {
       return;
@@ -56,10 +56,25 @@ struct past_always final : public dense_timed_state<X, interval_set<T>, T> {
     value = interval_set(
         interval::left_open(earliest_time, infinity<time_t>::value()));
     done = true;
+    first.reset();  // Decided, the subformula is no longer needed
   }
 
   output_t output(time_t previous, time_t now) override {
-    return interval_set(interval::left_open(previous, now)) - value;
+    return output_ref(previous, now);
+  }
+
+  const output_t &output_ref(time_t previous, time_t now) override {
+    this->segment.clear();
+    this->segment.add(interval::left_open(previous, now));
+    this->segment -= value;
+    return this->segment;
+  }
+
+  std::optional<bool> decided() const override {
+    if (done) {
+      return false;
+    }
+    return std::nullopt;
   }
 };
 
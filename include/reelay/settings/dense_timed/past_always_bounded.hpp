@@ -52,7 +52,7 @@ struct past_always_bounded final
               time_t previous,
               time_t now) override {
     auto complement = interval_set(interval::left_open(previous, now)) -
-                      first->output(previous, now);
+                      first->output_ref(previous, now);
 
     for (const auto& intv : complement) {
       value.add(
@@ -62,7 +62,14 @@ struct past_always_bounded final
   }
 
   output_t output(time_t previous, time_t now) override {
-    return interval_set(interval::left_open(previous, now)) - value;
+    return output_ref(previous, now);
+  }
+
+  const output_t &output_ref(time_t previous, time_t now) override {
+    this->segment.clear();
+    this->segment.add(interval::left_open(previous, now));
+    this->segment -= value;
+    return this->segment;
   }
 };
 
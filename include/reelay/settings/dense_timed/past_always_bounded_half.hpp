@@ -49,7 +49,7 @@ struct past_always_bounded_half final
               time_t previous,
               time_t now) override {
     auto complement = interval_set(interval::left_open(previous, now)) -
-                      first->output(previous, now);
+                      first->output_ref(previous, now);
 
     for (const auto& intv : complement) {
       value.add(interval::left_open(intv.lower() + lbound,
@@ -59,7 +59,14 @@ struct past_always_bounded_half final
   }
 
   output_t output(time_t previous, time_t now) override {
-    return interval_set(interval::left_open(previous, now)) - value;
+    return output_ref(previous, now);
+  }
+
+  const output_t &output_ref(time_t previous, time_t now) override {
+    this->segment.clear();
+    this->segment.add(interval::left_open(previous, now));
+    this->segment -= value;
+    return this->segment;
   }
 };
 
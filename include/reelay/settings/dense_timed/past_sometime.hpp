@@ -46,17 +46,33 @@ struct past_sometime final : public dense_timed_state<X, interval_set<T>, T> {
     if(done) {
       return;
     }
-    if (first->output(previous, now).size() == 0){
+    const interval_set &input = first->output_ref(previous, now);
+    if (input.size() == 0){
       return;
     }
-    time_t earliest_time = first->output(previous, now).begin()->lower();
+    time_t earliest_time = input.begin()->lower();
     value = interval_set(
         interval::left_open(earliest_time, infinity<time_t>::value()));
     done = true;
+    first.reset();  // Decided, the subformula is no longer needed
   }
 
   output_t output(time_t previous, time_t now) override {
-    return value & interval::left_open(previous, now);
+    return output_ref(previous, now);
+  }
+
+  const output_t &output_ref(time_t previous, time_t now) override {
+    this->segment.clear();
+    boost::icl::add_intersection(this->segment, value,
+                                 interval::left_open(previous, now));
+    return this->segment;
+  }
+
+  std::optional<bool> decided() const override {
+    if (done) {
+      return true;
+    }
+    return std::nullopt;
   }
 };
 
@@ -46,7 +46,7 @@ struct past_sometime_bounded_half final
               const input_t&,
               time_t previous,
               time_t now) override {
-    for (const auto& intv : first->output(previous, now)) {
+    for (const auto& intv : first->output_ref(previous, now)) {
       value.add(interval::left_open(intv.lower() + lbound,
                                     std::numeric_limits<time_t>::max()));
     }
@@ -54,7 +54,14 @@ struct past_sometime_bounded_half final
   }
 
   output_t output(time_t previous, time_t now) override {
-    return value & interval::left_open(previous, now);
+    return output_ref(previous, now);
+  }
+
+  const output_t &output_ref(time_t previous, time_t now) override {
+    this->segment.clear();
+    boost::icl::add_intersection(this->segment, value,
+                                 interval::left_open(previous, now));
+    return this->segment;
   }
 };
 
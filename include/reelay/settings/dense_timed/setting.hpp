@@ -32,6 +32,7 @@
 #include "reelay/settings/dense_timed/atomic_string.hpp"
 #include "reelay/settings/dense_timed/atomic_true.hpp"
 #include "reelay/settings/dense_timed/atomic_map.hpp"
+#include "reelay/settings/dense_timed/atomic_nested.hpp"
 
 #include "reelay/settings/dense_timed/conjunction.hpp"
 #include "reelay/settings/dense_timed/disjunction.hpp"
@@ -100,6 +101,8 @@ struct factory {
 
     if (name == "atomic_map") {
       result = std::make_shared<atomic_map<input_t, time_t>>(kw);
+    } else if (name == "atomic_nested") {
+      result = std::make_shared<atomic_nested<input_t, time_t>>(kw);
     } else if (name == "mapping_prop") {
       result = std::make_shared<atomic_prop<input_t, time_t>>(kw);
     } else if (name == "mapping_false") {
@@ -12,6 +12,7 @@
 
 #include "reelay/intervals.hpp"
 #include "reelay/networks/basic_structure.hpp"
+#include "reelay/networks/segment_sweep.hpp"
 
 namespace reelay {
 namespace dense_timed_setting {
@@ -33,6 +34,8 @@ struct since_bounded final : public dense_timed_state<X, interval_set<T>, T> {
   node_ptr_t first;
   node_ptr_t second;
 
+  segment_sweep<output_t> sweep;
+
   time_t lbound = 0;
   time_t ubound = 0;
 
@@ -64,67 +67,26 @@ struct since_bounded final : public dense_timed_state<X, interval_set<T>, T> {
               const input_t&,
               time_t previous,
               time_t now) override {
-    /*
-     *  The following code block performs the sychronization between two
-     * arbitrary chunks and calls the _update function for each constant period
-     * sequentially. The synchronization algorithm is a variant of the plane
-     * sweep algorithm from computational geometry.
-     */
-
-    // Sweep line starts from the earliest timepoint in the segment
-    time_t time = previous;
-
-    // Local variables
-    bool p1 = false;
-    bool p2 = false;
-
-    std::vector<T> bounds1;  // bounds1.reserve(p1set.size()*2+1);
-    std::vector<T> bounds2;  // bounds2.reserve(p2set.size()*2+1);
-
-    for (const auto& intv : first->output(previous, now)) {
-      bounds1.push_back(intv.lower());
-      bounds1.push_back(intv.upper());
-    }
-
-    for (const auto& intv : second->output(previous, now)) {
-      bounds2.push_back(intv.lower());
-      bounds2.push_back(intv.upper());
-    }
-
-    // Add the latest timepoint in the segment as the final bound
-    bounds1.push_back(now);
-    bounds2.push_back(now);
-
-    auto it1 = bounds1.begin();
-    auto it2 = bounds2.begin();
-
-    while (it1 != bounds1.end() and it2 != bounds2.end()) {
-      if (*it1 < *it2) {
-        update(p1, p2, time, *it1);
-        p1 = not p1;
-        time = *it1;
-        it1++;
-
-      } else if (*it1 > *it2) {
-        update(p1, p2, time, *it2);
-        p2 = not p2;
-        time = *it2;
-        it2++;
-
-      } else {  // *it1 == *it2
-        update(p1, p2, time, *it1);
-        p1 = not p1;
-        p2 = not p2;
-        time = *it1;
-        it1++;
-        it2++;
-      }
-    }
+    // Synchronize both operands and visit each constant period in order
+    sweep.clear();
+    sweep.add(first->output_ref(previous, now));
+    sweep.add(second->output_ref(previous, now));
+
+    sweep.run(previous, now, [this](time_t begin, time_t end) {
+      update(sweep.active(0), sweep.active(1), begin, end);
+    });
     value = value - interval::closed(-infinity<time_t>::value(), previous);
   }
 
   output_t output(time_t previous, time_t now) override {
-    return value & interval::left_open(previous, now);
+    return output_ref(previous, now);
+  }
+
+  const output_t &output_ref(time_t previous, time_t now) override {
+    this->segment.clear();
+    boost::icl::add_intersection(this->segment, value,
+                                 interval::left_open(previous, now));
+    return this->segment;
   }
 };
 
@@ -21,7 +21,7 @@
 namespace reelay {
 namespace dense_timed_data_setting {
 
-template <typename X, typename T, typename K = std::string>
+template <typename X, typename T, typename K = datafield_key_t<X>>
 struct atomic_any final : public dense_timed_state<X, data_interval_map<T>, T> {
   using key_t = K;
   using time_t = T;
@@ -21,7 +21,7 @@
 namespace reelay {
 namespace dense_timed_data_setting {
 
-template <typename X, typename T, typename K = std::string>
+template <typename X, typename T, typename K = datafield_key_t<X>>
 struct atomic_gt_0 final
     : public dense_timed_state<X, data_interval_map<T>, T> {
   using key_t = K;
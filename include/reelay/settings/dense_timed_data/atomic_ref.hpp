@@ -21,7 +21,7 @@
 namespace reelay {
 namespace dense_timed_data_setting {
 
-template <typename X, typename T, typename K = std::string>
+template <typename X, typename T, typename K = datafield_key_t<X>>
 struct atomic_ref final : public dense_timed_state<X, data_interval_map<T>, T> {
   using key_t = K;
   using time_t = T;
@@ -59,7 +59,7 @@ struct atomic_ref final : public dense_timed_state<X, data_interval_map<T>, T> {
       return; // Do nothing if the key does not exist - existing value persists
     }
 
-    std::string new_data = datafield<input_t>::as_string(args, key);
+    auto new_data = string_field(args, key);
 
     value = value - interval::left_open(0, previous);
     value = value - interval::left_open(now, infinity<time_t>::value());
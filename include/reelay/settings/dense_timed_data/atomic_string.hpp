@@ -21,7 +21,7 @@
 namespace reelay {
 namespace dense_timed_data_setting {
 
-template <typename X, typename T, typename K = std::string>
+template <typename X, typename T, typename K = datafield_key_t<X>>
 struct atomic_string final
     : public dense_timed_state<X, data_interval_map<T>, T> {
   using key_t = K;
@@ -58,7 +58,7 @@ struct atomic_string final
       return; // Do nothing if the key does not exist - existing value persists
     }
 
-    std::string new_data = datafield<input_t>::as_string(args, key);
+    auto new_data = string_field(args, key);
 
     value = value - interval::left_open(0, previous);
     value = value - interval::left_open(now, infinity<time_t>::value());
@@ -28,6 +28,7 @@
 #include "reelay/settings/dense_timed_data/atomic_string.hpp"
 #include "reelay/settings/dense_timed_data/atomic_true.hpp"
 #include "reelay/settings/dense_timed_data/atomic_map.hpp"
+#include "reelay/settings/dense_timed_data/atomic_nested.hpp"
 
 #include "reelay/settings/dense_timed_data/exists.hpp"
 #include "reelay/settings/dense_timed_data/forall.hpp"
@@ -100,6 +101,8 @@ template <typename X, typename T, int order=0> struct factory {
 
     if (name == "atomic_map") {
       res = std::make_shared<atomic_map<input_t, time_t>>(kw);
+    } else if (name == "atomic_nested") {
+      res = std::make_shared<atomic_nested<input_t, time_t>>(kw);
     } else if (name == "mapping_prop") {
       res = std::make_shared<atomic_prop<input_t, time_t, std::string>>(kw);
     } else if (name == "mapping_false") {
@@ -14,6 +14,7 @@
 #include "reelay/common.hpp"
 #include "reelay/intervals.hpp"
 #include "reelay/networks/basic_structure.hpp"
+#include "reelay/networks/segment_sweep.hpp"
 #include "reelay/unordered_data.hpp"
 
 namespace reelay {
@@ -42,6 +43,8 @@ struct since_bounded final
   node_ptr_t first;
   node_ptr_t second;
 
+  segment_sweep<output_t> sweep;
+
   time_t lbound;
   time_t ubound;
 
@@ -76,40 +79,14 @@ struct since_bounded final
 
   void update(const input_t &, const input_t &, time_t previous,
               time_t now) override {
-    /*
-     * The following code performs the sychronization between two arbitrary
-     * chunks and calls the update function for each constant period
-     * from past to future. The synchronization algorithm is a variant of
-     * plane sweep algorithms from computational geometry.
-     */
-
-    // Sweep line starts from the earliest timepoint in the segment
-    time_t time = previous;
-
-    auto active1 = first->output(previous, now);
-    auto active2 = second->output(previous, now);
-
-    auto it1 = active1.begin();
-    auto it2 = active2.begin();
-
-    while (it1 != active1.end() and it2 != active2.end()) {
-      if (it1->first.upper() < it2->first.upper()) {
-        update(it1->second, it2->second, time, it1->first.upper());
-        time = it1->first.upper();
-        it1++;
-
-      } else if (it2->first.upper() < it1->first.upper()) {
-        update(it1->second, it2->second, time, it2->first.upper());
-        time = it2->first.upper();
-        it2++;
-
-      } else { // it1->first.upper() == it2->first.upper()
-        update(it1->second, it2->second, time, it1->first.upper());
-        time = it1->first.upper();
-        it1++;
-        it2++;
-      }
-    }
+    // Synchronize both operands and visit each constant period in order
+    sweep.clear();
+    sweep.add(first->output_ref(previous, now));
+    sweep.add(second->output_ref(previous, now));
+
+    sweep.run(previous, now, [this](time_t begin, time_t end) {
+      update(sweep.value(0), sweep.value(1), begin, end);
+    });
 
     value = value - interval::closed(-infinity<time_t>::value(), previous);
   }
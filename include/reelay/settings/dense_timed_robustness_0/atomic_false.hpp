@@ -20,7 +20,7 @@
 namespace reelay {
 namespace dense_timed_robustness_0_setting {
 
-template <typename X, typename V, typename T, typename K = std::string>
+template <typename X, typename V, typename T, typename K = datafield_key_t<X>>
 struct atomic_false final
     : public dense_timed_state<X, robustness_interval_map<T, V>, T> {
   using key_t = K;
@@ -36,16 +36,19 @@ struct atomic_map final
 
   interval_map value = interval_map();
 
-  std::vector<node_ptr_t> mappings;
+  std::vector<state_ptr_t> mappings;
 
-  explicit atomic_map(const std::vector<node_ptr_t> &nodeptrs)
-      : mappings(nodeptrs) {}
+  explicit atomic_map(const std::vector<state_ptr_t> &stateptrs)
+      : mappings(stateptrs) {}
 
   explicit atomic_map(const kwargs &kw)
-      : atomic_map(reelay::any_cast<std::vector<node_ptr_t>>(kw.at("args"))) {}
+      : atomic_map(reelay::any_cast<std::vector<state_ptr_t>>(kw.at("args"))) {}
 
-  void update(const input_t &, const input_t &, time_t previous,
+  void update(const input_t &pargs, const input_t &args, time_t previous,
               time_t now) override {
+    for (const auto &mapping : mappings) {
+      mapping->update(pargs, args, previous, now);
+    }
     value = mappings[0]->output(previous, now);
     for (size_t i = 1; i < mappings.size(); i++) {
       value = value - mappings[i]->output(previous, now);
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "stdexcept"
+#include "string"
+#include "vector"
+
+#include "reelay/common.hpp"
+#include "reelay/datafield.hpp"
+#include "reelay/intervals.hpp"
+#include "reelay/networks/basic_structure.hpp"
+
+namespace reelay {
+namespace dense_timed_robustness_0_setting {
+
+/*
+ * Record proposition under a path such as `a::b::{...}`. The path is walked
+ * once per event and the children are evaluated on the nested record itself.
+ * Children keep their values if the path does not exist, and the output
+ * over the new segment is still read from them.
+ */
+
+template <typename X, typename V, typename T>
+struct atomic_nested final
+    : public dense_timed_state<X, robustness_interval_map<T, V>, T> {
+  using time_t = T;
+  using input_t = X;
+  using value_t = V;
+  using output_t = reelay::robustness_interval_map<time_t, value_t>;
+
+  using interval = reelay::interval<time_t>;
+  using interval_map = reelay::robustness_interval_map<time_t, value_t>;
+
+  using node_t = dense_timed_node<output_t, time_t>;
+  using state_t = dense_timed_state<input_t, output_t, time_t>;
+
+  using node_ptr_t = std::shared_ptr<node_t>;
+  using state_ptr_t = std::shared_ptr<state_t>;
+
+  interval_map value = interval_map();
+
+  std::vector<std::string> path;
+  std::vector<state_ptr_t> mappings;
+
+  explicit atomic_nested(const std::vector<std::string> &p,
+                         const std::vector<state_ptr_t> &stateptrs)
+      : path(p), mappings(stateptrs) {
+    if (not has_pointer_field<input_t>::value) {
+      throw std::invalid_argument("Nested fields are not supported");
+    }
+  }
+
+  explicit atomic_nested(const kwargs &kw)
+      : atomic_nested(
+            reelay::any_cast<std::vector<std::string>>(kw.at("path")),
+            reelay::any_cast<std::vector<state_ptr_t>>(kw.at("args"))) {}
+
+  void update(const input_t &pargs, const input_t &args, time_t previous,
+              time_t now) override {
+    const input_t *record = find_path(args, path);
+    if (record != nullptr) {
+      for (const auto &mapping : mappings) {
+        mapping->update(*record, *record, previous, now);
+      }
+    }
+    value = mappings[0]->output(previous, now);
+    for (size_t i = 1; i < mappings.size(); i++) {
+      value = value - mappings[i]->output(previous, now);
+    }
+  }
+
+  output_t output(time_t previous, time_t now) override {
+    return value & interval::left_open(previous, now);
+  }
+};
+
+} // namespace dense_timed_robustness_0_setting
+} // namespace reelay
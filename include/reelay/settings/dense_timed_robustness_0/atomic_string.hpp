@@ -20,7 +20,7 @@
 namespace reelay {
 namespace dense_timed_robustness_0_setting {
 
-template <typename X, typename V, typename T, typename K = std::string>
+template <typename X, typename V, typename T, typename K = datafield_key_t<X>>
 struct atomic_string final
     : public dense_timed_state<X, robustness_interval_map<T, V>, T> {
   using key_t = K;
@@ -52,7 +52,7 @@ struct atomic_string final
       return; // Do nothing if the key does not exist - existing value persists
     }
 
-    std::string new_data = datafield<input_t>::as_string(args, key);
+    auto new_data = string_field(args, key);
 
     value = value & interval::left_open(previous, now);
     if (new_data == constant) {
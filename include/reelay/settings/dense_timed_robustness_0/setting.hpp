@@ -27,6 +27,7 @@
 #include "reelay/settings/dense_timed_robustness_0/atomic_string.hpp"
 #include "reelay/settings/dense_timed_robustness_0/atomic_true.hpp"
 #include "reelay/settings/dense_timed_robustness_0/atomic_map.hpp"
+#include "reelay/settings/dense_timed_robustness_0/atomic_nested.hpp"
 
 #include "reelay/settings/dense_timed_robustness_0/conjunction.hpp"
 #include "reelay/settings/dense_timed_robustness_0/disjunction.hpp"
@@ -92,6 +93,8 @@ template <typename X, typename V, typename T> struct factory {
 
     if (name == "atomic_map") {
       result = std::make_shared<atomic_map<input_t, value_t, time_t>>(kw);
+    } else if (name == "atomic_nested") {
+      result = std::make_shared<atomic_nested<input_t, value_t, time_t>>(kw);
     } else if (name == "mapping_prop") {
       result = std::make_shared<atomic_prop<input_t, value_t, time_t>>(kw);
     } else if (name == "mapping_false") {
@@ -20,23 +20,23 @@
 namespace reelay {
 namespace discrete_timed_setting {
 
-template <typename X, typename T, typename K = std::string>
+template <typename X, typename T, typename K = datafield_key_t<X>>
 struct atomic_le final : public discrete_timed_state<X, bool, T> {
   using key_t = K;
   using time_t = T;
   using input_t = X;
   using output_t = bool;
 
-  std::string key;
+  key_t key;
   double constant;
 
   bool value = false;
 
-  explicit atomic_le(const std::string &k, const std::string &c)
+  explicit atomic_le(const key_t &k, const std::string &c)
       : key(k), constant(std::stod(c)) {}
 
   explicit atomic_le(const kwargs &kw)
-      : atomic_le(reelay::any_cast<std::string>(kw.at("key")),
+      : atomic_le(reelay::any_cast<key_t>(kw.at("key")),
                    reelay::any_cast<std::string>(kw.at("constant"))) {}
 
   void update(const input_t &args, time_t) override {
@@ -8,7 +8,10 @@
 
 #pragma once
 
+#include "algorithm"
+#include "memory"
 #include "string"
+#include "vector"
 
 #include "reelay/common.hpp"
 #include "reelay/networks/basic_structure.hpp"
@@ -16,6 +19,12 @@
 namespace reelay {
 namespace discrete_timed_setting {
 
+/*
+ * Record proposition such as `{p, x > 3}`. Mappings are updated by the
+ * record proposition rather than by the network. They keep their last value
+ * when their key is missing, so every mapping is updated on every event and
+ * there is nothing to gain from adaptive ordering here.
+ */
 template <typename X, typename T>
 struct atomic_map final : public discrete_timed_state<X, bool, T> {
   using time_t = T;
@@ -30,20 +39,25 @@ struct atomic_map final : public discrete_timed_state<X, bool, T> {
 
   output_t value = false;
 
-  std::vector<node_ptr_t> mappings;
+  std::vector<state_ptr_t> mappings;
 
-  explicit atomic_map(const std::vector<node_ptr_t> &nodeptrs)
-      : mappings(nodeptrs) {}
+  explicit atomic_map(const std::vector<state_ptr_t> &stateptrs)
+      : mappings(stateptrs) {}
 
   explicit atomic_map(const kwargs &kw)
-      : atomic_map(reelay::any_cast<std::vector<node_ptr_t>>(kw.at("args"))) {}
+      : atomic_map(reelay::any_cast<std::vector<state_ptr_t>>(kw.at("args"))) {}
 
   void update(const input_t &args, time_t now) override {
+    for (const auto &mapping : mappings) {
+      mapping->update(args, now);
+    }
     value = std::all_of(mappings.cbegin(), mappings.cend(),
-                        [now](node_ptr_t arg) { return arg->output(now); });
+                        [now](const state_ptr_t &m) { return m->output(now); });
   }
 
   output_t output(time_t) override { return value; }
+
+  double cost() const override { return 1.0 + double(mappings.size()); }
 };
 
 } // namespace discrete_timed_setting
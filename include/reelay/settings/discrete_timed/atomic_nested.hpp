@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#pragma once
+
+#include "stdexcept"
+#include "string"
+#include "vector"
+
+#include "reelay/common.hpp"
+#include "reelay/datafield.hpp"
+#include "reelay/networks/basic_structure.hpp"
+
+namespace reelay {
+namespace discrete_timed_setting {
+
+/*
+ * Record proposition under a path such as `a::b::{...}`. The path is walked
+ * once per event and the children are evaluated on the nested record itself.
+ * Children keep their values if the path does not exist.
+ */
+
+template <typename X, typename T>
+struct atomic_nested final : public discrete_timed_state<X, bool, T> {
+  using time_t = T;
+  using input_t = X;
+  using output_t = bool;
+
+  using node_t = discrete_timed_node<output_t, time_t>;
+  using state_t = discrete_timed_state<input_t, output_t, time_t>;
+
+  using node_ptr_t = std::shared_ptr<node_t>;
+  using state_ptr_t = std::shared_ptr<state_t>;
+
+  output_t value = false;
+
+  std::vector<std::string> path;
+  std::vector<state_ptr_t> mappings;
+
+  explicit atomic_nested(const std::vector<std::string> &p,
+                         const std::vector<state_ptr_t> &stateptrs)
+      : path(p), mappings(stateptrs) {
+    if (not has_pointer_field<input_t>::value) {
+      throw std::invalid_argument("Nested fields are not supported");
+    }
+  }
+
+  explicit atomic_nested(const kwargs &kw)
+      : atomic_nested(
+            reelay::any_cast<std::vector<std::string>>(kw.at("path")),
+            reelay::any_cast<std::vector<state_ptr_t>>(kw.at("args"))) {}
+
+  void update(const input_t &args, time_t now) override {
+    const input_t *record = find_path(args, path);
+    if (record == nullptr) {
+      return;
+    }
+    value = true;
+    for (const auto &mapping : mappings) {
+      mapping->update(*record, now);
+      value = value and mapping->output(now);
+    }
+  }
+
+  output_t output(time_t) override { return value; }
+};
+
+} // namespace discrete_timed_setting
+} // namespace reelay
@@ -9,9 +9,11 @@
 #pragma once
 
 #include "memory"
+#include "optional"
 #include "vector"
 
 #include "reelay/common.hpp"
+#include "reelay/networks/adaptive_operands.hpp"
 #include "reelay/networks/basic_structure.hpp"
 
 namespace reelay {
@@ -31,16 +33,36 @@ struct conjunction final : public discrete_timed_node<bool, T> {
 
   std::vector<node_ptr_t> args;
 
-  explicit conjunction(const std::vector<node_ptr_t> &nodeptrs)
-      : args(nodeptrs) {}
+  std::optional<adaptive_operands<node_ptr_t>> operands;  // if adaptive
+
+  explicit conjunction(const std::vector<node_ptr_t> &nodeptrs,
+                       bool adaptive = false)
+      : args(nodeptrs) {
+    if (adaptive) {
+      operands.emplace(nodeptrs);
+    }
+  }
 
   explicit conjunction(const kwargs &kw)
-      : conjunction(reelay::any_cast<std::vector<node_ptr_t>>(kw.at("args"))) {}
+      : conjunction(reelay::any_cast<std::vector<node_ptr_t>>(kw.at("args")),
+                    is_adaptive(kw)) {}
 
   output_t output(time_t now) {
+    if (operands) {
+      return operands->fold(
+          false, [now](const node_ptr_t &arg) { return arg->output(now); });
+    }
     return std::all_of(args.cbegin(), args.cend(),
                        [now](node_ptr_t arg) { return arg->output(now); });
   }
+
+  double cost() const override {
+    return operands ? operands->cost() : 1.0 + double(args.size());
+  }
+
+  std::optional<bool> decided() const override {
+    return decided_fold(args, false);
+  }
 };
 
 }  // namespace discrete_timed_setting
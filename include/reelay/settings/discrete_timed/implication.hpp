@@ -41,6 +41,18 @@ struct implication final : public discrete_timed_node<bool, T> {
   output_t output(time_t now) {
     return not arg1->output(now) or arg2->output(now);
   }
+
+  std::optional<bool> decided() const override {
+    auto value1 = arg1->decided();
+    auto value2 = arg2->decided();
+    if (value1 == false or value2 == true) {
+      return true;
+    }
+    if (value1 and value2) {
+      return false;  // Both decided and the antecedent holds
+    }
+    return std::nullopt;
+  }
 };
 
 }  // namespace discrete_timed_setting
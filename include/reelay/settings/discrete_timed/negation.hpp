@@ -37,6 +37,14 @@ struct negation final : public discrete_timed_node<bool, T> {
       : negation(reelay::any_cast<std::vector<node_ptr_t>>(kw.at("args"))) {}
 
   output_t output(time_t now) { return not arg1->output(now); }
+
+  std::optional<bool> decided() const override {
+    auto value = arg1->decided();
+    if (value) {
+      return not *value;
+    }
+    return std::nullopt;
+  }
 };
 
 }  // namespace discrete_timed_setting
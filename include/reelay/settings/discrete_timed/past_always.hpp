@@ -36,10 +36,23 @@ struct past_always final : public discrete_timed_state<X, bool, T> {
       : past_always(reelay::any_cast<std::vector<node_ptr_t>>(kw.at("args"))) {}
 
   void update(const input_t&, time_t now) override {
-    value = first->output(now) && value;
+    if (not value) {
+      return;
+    }
+    value = first->output(now);
+    if (not value) {
+      first.reset();  // Decided, the subformula is no longer needed
+    }
   }
 
   output_t output(time_t) override { return value; }
+
+  std::optional<bool> decided() const override {
+    if (not value) {
+      return false;
+    }
+    return std::nullopt;
+  }
 };
 
 }  // namespace discrete_timed_setting
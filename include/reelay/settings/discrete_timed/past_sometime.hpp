@@ -37,10 +37,23 @@ struct past_sometime final : public discrete_timed_state<X, bool, T> {
       : past_sometime(reelay::any_cast<std::vector<node_ptr_t>>(kw.at("args"))) {}
 
   void update(const input_t&, time_t now) override {
-    value = first->output(now) || value;
+    if (value) {
+      return;
+    }
+    value = first->output(now);
+    if (value) {
+      first.reset();  // Decided, the subformula is no longer needed
+    }
   }
 
   output_t output(time_t) override { return value; }
+
+  std::optional<bool> decided() const override {
+    if (value) {
+      return true;
+    }
+    return std::nullopt;
+  }
 };
 
 }  // namespace discrete_timed_setting
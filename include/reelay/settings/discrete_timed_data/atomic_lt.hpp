@@ -20,7 +20,7 @@
 namespace reelay {
 namespace discrete_timed_data_setting {
 
-template <typename X, typename T, typename K = std::string>
+template <typename X, typename T, typename K = datafield_key_t<X>>
 struct atomic_lt final : public discrete_timed_state<X, data_set_t, T> {
   using key_t = K;
   using time_t = T;
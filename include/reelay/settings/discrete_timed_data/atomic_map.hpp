@@ -38,17 +38,20 @@ struct atomic_map final : public discrete_timed_state<X, data_set_t, T> {
   data_mgr_t manager;
   data_set_t value;
 
-  std::vector<node_ptr_t> mappings;
+  std::vector<state_ptr_t> mappings;
 
   explicit atomic_map(const data_mgr_t &mgr,
-                      const std::vector<node_ptr_t> &nodeptrs)
-      : manager(mgr), value(mgr->zero()), mappings(nodeptrs) {}
+                      const std::vector<state_ptr_t> &stateptrs)
+      : manager(mgr), value(mgr->zero()), mappings(stateptrs) {}
 
   explicit atomic_map(const kwargs &kw)
       : atomic_map(reelay::any_cast<data_mgr_t>(kw.at("manager")),
-                   reelay::any_cast<std::vector<node_ptr_t>>(kw.at("args"))) {}
+                   reelay::any_cast<std::vector<state_ptr_t>>(kw.at("args"))) {}
 
   void update(const input_t &args, time_t now) override {
+    for (const auto &mapping : mappings) {
+      mapping->update(args, now);
+    }
     value = mappings[0]->output(now);
     for (std::size_t i = 1; i < mappings.size(); i++) {
       value *= mappings[i]->output(now);
@@ -19,7 +19,7 @@
 namespace reelay {
 namespace discrete_timed_data_setting {
 
-template <typename X, typename T, typename K = std::string>
+template <typename X, typename T, typename K = datafield_key_t<X>>
 struct atomic_ref final : public discrete_timed_state<X, data_set_t, T> {
   using key_t = K;
   using time_t = T;
@@ -50,7 +50,7 @@ struct atomic_ref final : public discrete_timed_state<X, data_set_t, T> {
       return; // Do nothing if the key does not exist - existing value persists
     }
 
-    std::string new_data = datafield<input_t>::as_string(args, key);
+    auto new_data = string_field(args, key);
 
     value = manager->assign(variable, new_data);
   }
@@ -29,6 +29,7 @@
 #include "reelay/settings/discrete_timed_data/atomic_string.hpp"
 #include "reelay/settings/discrete_timed_data/atomic_true.hpp"
 #include "reelay/settings/discrete_timed_data/atomic_map.hpp"
+#include "reelay/settings/discrete_timed_data/atomic_nested.hpp"
 
 #include "reelay/settings/discrete_timed_data/exists.hpp"
 #include "reelay/settings/discrete_timed_data/forall.hpp"
@@ -105,6 +106,8 @@ struct factory {
 
     if (name == "atomic_map") {
       result = std::make_shared<atomic_map<input_t, time_t>>(kw);
+    } else if (name == "atomic_nested") {
+      result = std::make_shared<atomic_nested<input_t, time_t>>(kw);
     } else if (name == "mapping_prop") {
       result = std::make_shared<atomic_prop<input_t, time_t, std::string>>(kw);
     } else if (name == "mapping_false") {
@@ -20,7 +20,7 @@
 namespace reelay {
 namespace discrete_timed_robustness_setting {
 
-template <typename X, typename V, typename T, typename K = std::string>
+template <typename X, typename V, typename T, typename K = datafield_key_t<X>>
 struct atomic_eq final : public discrete_timed_state<X, V, T> {
   using key_t = K;
   using time_t = T;
@@ -30,15 +30,18 @@ struct atomic_map final : public discrete_timed_state<X, V, T> {
 
   output_t value = -reelay::infinity<output_t>::value();
 
-  std::vector<node_ptr_t> mappings;
+  std::vector<state_ptr_t> mappings;
 
-  explicit atomic_map(const std::vector<node_ptr_t> &nodeptrs)
-      : mappings(nodeptrs) {}
+  explicit atomic_map(const std::vector<state_ptr_t> &stateptrs)
+      : mappings(stateptrs) {}
 
   explicit atomic_map(const kwargs &kw)
-      : atomic_map(reelay::any_cast<std::vector<node_ptr_t>>(kw.at("args"))) {}
+      : atomic_map(reelay::any_cast<std::vector<state_ptr_t>>(kw.at("args"))) {}
 
   void update(const input_t &args, time_t now) override {
+    for (const auto &mapping : mappings) {
+      mapping->update(args, now);
+    }
     value = mappings[0]->output(now);
     for (std::size_t i = 1; i < mappings.size(); i++) {
       value = std::min(value, mappings[i]->output(now));
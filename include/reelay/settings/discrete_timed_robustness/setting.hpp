@@ -28,6 +28,7 @@
 #include "reelay/settings/discrete_timed_robustness/atomic_string.hpp"
 #include "reelay/settings/discrete_timed_robustness/atomic_true.hpp"
 #include "reelay/settings/discrete_timed_robustness/atomic_map.hpp"
+#include "reelay/settings/discrete_timed_robustness/atomic_nested.hpp"
 
 #include "reelay/settings/discrete_timed_robustness/conjunction.hpp"
 #include "reelay/settings/discrete_timed_robustness/disjunction.hpp"
@@ -97,6 +98,8 @@ struct factory {
 
     if (name == "atomic_map") {
       result = std::make_shared<atomic_map<input_t, output_t, time_t>>(kw);
+    } else if (name == "atomic_nested") {
+      result = std::make_shared<atomic_nested<input_t, output_t, time_t>>(kw);
     } else if(name == "mapping_prop") {
       result = std::make_shared<atomic_prop<input_t, output_t, time_t>>(kw);
     } else if (name == "mapping_false") {
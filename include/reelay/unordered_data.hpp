@@ -10,6 +10,7 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 #include "cudd/cudd.hpp"
@@ -26,6 +27,19 @@ namespace reelay {
 
 struct binding_manager;
 
+// Values are looked up by a non-owning view so that assigning a value read
+// from the input does not allocate. Views point to the strings owned by the
+// manager, whose elements keep their address until erased.
+template<typename V>
+struct binding_key {
+  using type = V;
+};
+
+template<>
+struct binding_key<std::string> {
+  using type = std::string_view;
+};
+
 using data_mgr_t = std::shared_ptr<binding_manager>;
 using data_set_t = BDD;
 
@@ -35,6 +49,8 @@ struct binding_manager {
 
   template<typename V = std::string>
   struct variable_t {
+    using key_t = typename binding_key<V>::type;
+
     set_t one;
     set_t cube;
     set_t other_cubes;
@@ -44,10 +60,16 @@ struct binding_manager {
 
     std::vector<set_t> bddvars;
     std::unordered_map<set_t, V> values = {};
-    std::unordered_map<V, set_t> slots = {};
+    std::unordered_map<key_t, set_t> slots = {};
 
     variable_t() = default;
 
+    // Copies would leave `slots` viewing the strings of the original
+    variable_t(const variable_t&) = delete;
+    variable_t& operator=(const variable_t&) = delete;
+    variable_t(variable_t&&) = default;
+    variable_t& operator=(variable_t&&) = default;
+
     variable_t(const mgr_t& mgr, const std::vector<set_t>& vars)
         : one(mgr.bddOne()),
           cube(mgr.computeCube(vars)),
@@ -72,15 +94,16 @@ struct binding_manager {
     //   return slot;
     // }
 
-    set_t assign(const V& value)
+    set_t assign(const key_t& value)
     {
-      if(slots.find(value) != slots.end()) {
-        return slots[value];
+      auto it = slots.find(value);
+      if(it != slots.end()) {
+        return it->second;
       }
       auto slot = make_minterm_of(n);
       n++;
-      values[slot] = value;
-      slots[value] = slot;
+      const V& stored = values.emplace(slot, V(value)).first->second;
+      slots.emplace(key_t(stored), slot);
       return slot;
     }
 
@@ -101,18 +124,23 @@ struct binding_manager {
       return c;
     }
 
-    set_t erase(const V& value)
+    // Returns the freed slot, or the empty set if the value was not assigned
+    set_t erase(const key_t& value)
     {
-      auto slot = slots[value];
+      auto it = slots.find(value);
+      if(it == slots.end()) {
+        return ~one;
+      }
+      auto slot = it->second;
+      slots.erase(it);  // Before the owning string goes away
       values.erase(slot);
-      slots.erase(value);
       return slot;
     }
 
     V erase(const set_t& slot)
     {
       auto value = values[slot];
-      slots.erase(value);
+      slots.erase(key_t(value));
       values.erase(slot);
       return value;
     }
@@ -155,7 +183,7 @@ struct binding_manager {
     }
   }
 
-  set_t assign(std::string name, std::string value)
+  set_t assign(const std::string& name, std::string_view value)
   {
     return variables[name].assign(value);
   }
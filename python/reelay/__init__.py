@@ -11,4 +11,9 @@ Python bindings for Reelay C++ library
 """
 
 from .dense_timed_monitor import dense_timed_monitor
+from .dense_interval_monitor import dense_interval_monitor
 from .discrete_timed_monitor import discrete_timed_monitor
+from .regex_monitor import regex_monitor
+from .verdict_file import load_verdicts, read_verdict_header
+from .binary_rows import load_rows, save_rows
+from ._pybind11_module import inspect, admit
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2019-2025 Dogan Ulus
+#
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at https://mozilla.org/MPL/2.0/.
+#
+"""
+Reader and writer for self-describing binary row files (.rybr)
+
+A row file has a header listing field names, types and byte offsets, followed
+by fixed-width rows. Any NumPy structured array with boolean, int32, int64
+and float64 fields can be saved as a row file and monitored by `rybinx`.
+"""
+
+import os
+import struct
+
+_MAGIC = b"RYBR"
+_VERSION = 1
+_HEADER = struct.Struct("=4sHHII")
+_FIELD = struct.Struct("=BBHI")
+
+_KINDS = {("b", 1): 1, ("i", 4): 2, ("i", 8): 3, ("f", 8): 4}
+_SCALARS = {1: "?", 2: "i4", 3: "i8", 4: "f8"}
+
+
+def save_rows(filename, array):
+    """Save a NumPy structured array as a binary row file."""
+    import numpy as np
+
+    dtype = array.dtype
+    if dtype.names is None:
+        raise ValueError("Expected a structured array")
+
+    table = b""
+    for name in dtype.names:
+        ftype, offset = dtype.fields[name][:2]
+        kind = _KINDS.get((ftype.kind, ftype.itemsize))
+        if kind is None:
+            raise ValueError(f"Unsupported field type for {name}: {ftype}")
+        encoded = name.encode()
+        table += _FIELD.pack(kind, len(encoded), 0, offset) + encoded
+
+    data_offset = _HEADER.size + len(table)
+    padding = (-data_offset) % 8
+    data_offset += padding
+
+    header = _HEADER.pack(
+        _MAGIC, _VERSION, len(dtype.names), dtype.itemsize, data_offset)
+
+    native = np.ascontiguousarray(array, dtype=dtype.newbyteorder("="))
+    with open(filename, "wb") as f:
+        f.write(header + table + b"\0" * padding)
+        f.write(native.tobytes())
+
+
+def load_rows(filename, mmap=True):
+    """Load a binary row file as a NumPy structured array."""
+    import numpy as np
+
+    with open(filename, "rb") as f:
+        raw = f.read(_HEADER.size)
+        if len(raw) < _HEADER.size:
+            raise ValueError(f"Not a binary row file: {filename}")
+        magic, version, count, row_size, data_offset = _HEADER.unpack(raw)
+        if magic != _MAGIC:
+            raise ValueError(f"Not a binary row file: {filename}")
+        if version != _VERSION:
+            raise ValueError(f"Unsupported binary row version: {version}")
+
+        names, formats, offsets = [], [], []
+        for _ in range(count):
+            kind, length, _, offset = _FIELD.unpack(f.read(_FIELD.size))
+            names.append(f.read(length).decode())
+            formats.append(_SCALARS[kind])
+            offsets.append(offset)
+
+    dtype = np.dtype({
+        "names": names,
+        "formats": formats,
+        "offsets": offsets,
+        "itemsize": row_size,
+    })
+
+    if os.path.getsize(filename) == data_offset:
+        return np.empty(0, dtype=dtype)
+    if mmap:
+        return np.memmap(filename, dtype=dtype, mode="r", offset=data_offset)
+    return np.fromfile(filename, dtype=dtype, offset=data_offset)
@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2019-2025 Dogan Ulus
+#
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at https://mozilla.org/MPL/2.0/.
+#
+"""
+Dense timed monitors reporting final verdict intervals as NumPy arrays
+
+Each interval (begin, end, value) is reported once it can no longer change.
+Records have the same layout as interval verdict files (see load_verdicts),
+so results are viewed in place rather than built element by element.
+"""
+
+from reelay import _pybind11_module as rym
+
+
+class dense_interval_monitor(object):
+    def __init__(self,
+                 pattern: str,
+                 t_name="time",         # any unique identifier
+                 y_name="value",        # any unique identifier
+                 memory_budget=None,    # bytes, rejects larger monitors
+                 change_rate=None,      # input changes per time unit, at most
+                 ):
+        import numpy as np
+
+        if memory_budget is None:
+            inspection = rym.inspect(pattern)
+        elif change_rate is None:
+            inspection = rym.admit(pattern, memory_budget, dense=True)
+        else:
+            inspection = rym.admit(
+                pattern, memory_budget, dense=True, rate=change_rate)
+
+        options = rym.monitor_options(t_name, y_name, "constant", True)
+
+        if inspection['has_references']:
+            self._monitor = rym.dense_data_monitor.make(pattern, options)
+        else:
+            self._monitor = rym.dense_monitor.make(pattern, options)
+
+        self.dtype = np.dtype(
+            [("begin", "f8"), ("end", "f8"), (y_name, "?")])
+
+    def update(self, inputs):
+        """Push a sequence of inputs and return the intervals made final."""
+        return self._view(self._monitor.push_intervals(inputs))
+
+    def close(self):
+        """Return the last interval, which ends at the current time."""
+        return self._view(self._monitor.close_intervals())
+
+    def now(self):
+        return self._monitor.now()
+
+    def _view(self, records):
+        import numpy as np
+        return np.frombuffer(records, dtype=self.dtype)
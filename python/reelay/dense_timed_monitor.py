@@ -16,9 +16,17 @@ class dense_timed_monitor(object):
                 piecewise="constant",  # constant, linear
                 t_name="time",         # any unique identifier
                 y_name="value",        # any unique identifier
+                memory_budget=None,    # bytes, rejects larger monitors
+                change_rate=None,      # input changes per time unit, at most
                 ):
 
-        inspection = rym.inspect(pattern)
+        if memory_budget is None:
+            inspection = rym.inspect(pattern)
+        elif change_rate is None:
+            inspection = rym.admit(pattern, memory_budget, dense=True)
+        else:
+            inspection = rym.admit(
+                pattern, memory_budget, dense=True, rate=change_rate)
         has_references = inspection['has_references']
 
         options = rym.monitor_options(
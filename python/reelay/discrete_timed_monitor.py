@@ -16,9 +16,13 @@ class discrete_timed_monitor(object):
                 t_name="time",        # any unique identifier
                 y_name="value",       # any unique identifier
                 condense=True,
+                memory_budget=None,   # bytes, rejects larger monitors
                 ):
 
-        inspection = rym.inspect(pattern)
+        if memory_budget is None:
+            inspection = rym.inspect(pattern)
+        else:
+            inspection = rym.admit(pattern, memory_budget)
         has_references = inspection['has_references']
 
         options = rym.monitor_options(
@@ -0,0 +1,28 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2019-2023 Dogan Ulus
+#
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at https://mozilla.org/MPL/2.0/.
+#
+from reelay import _pybind11_module as rym
+
+
+class regex_monitor(object):
+    def __new__(cls,
+                pattern: str,
+                t_name="time",        # any unique identifier
+                y_name="value",       # any unique identifier
+                condense=True,
+                ):
+
+        options = rym.monitor_options(
+            t_name, y_name, condense, True)
+
+        if condense:
+            return rym.condensing_regex_monitor.make(
+                pattern, options)
+        else:
+            return rym.regex_monitor.make(
+                pattern, options)
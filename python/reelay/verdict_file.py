@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2019-2025 Dogan Ulus
+#
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at https://mozilla.org/MPL/2.0/.
+#
+"""
+Loader for binary Reelay verdict files (.rylb)
+
+The file layout is a 16-byte header followed by packed fixed-width records,
+which maps directly onto a NumPy structured dtype without any parsing.
+"""
+
+import os
+import struct
+
+_MAGIC = b"RYLB"
+_VERSION = 1
+_HEADER = struct.Struct("=4sHBBBBHI")
+
+_MODELS = {0: "discrete", 1: "dense"}
+_LAYOUTS = {0: "point", 1: "interval"}
+_SCALARS = {1: "?", 2: "i4", 3: "i8", 4: "f8"}
+
+
+def read_verdict_header(filename):
+    """Return the header of a verdict file as a dict."""
+    with open(filename, "rb") as f:
+        raw = f.read(_HEADER.size)
+
+    if len(raw) < _HEADER.size:
+        raise ValueError(f"Not a verdict file: {filename}")
+
+    magic, version, model, layout, tkind, vkind, rsize, _ = _HEADER.unpack(raw)
+    if magic != _MAGIC:
+        raise ValueError(f"Not a verdict file: {filename}")
+    if version != _VERSION:
+        raise ValueError(f"Unsupported verdict file version: {version}")
+
+    return {
+        "model": _MODELS[model],
+        "layout": _LAYOUTS[layout],
+        "time_type": _SCALARS[tkind],
+        "value_type": _SCALARS[vkind],
+        "record_size": rsize,
+    }
+
+
+def load_verdicts(filename, t_name="time", y_name="value", mmap=True):
+    """
+    Load a verdict file as a NumPy structured array.
+
+    Point records have fields (t_name, y_name) and interval records have
+    fields ("begin", "end", y_name). With mmap=True the array is a read-only
+    view of the file.
+    """
+    import numpy as np
+
+    header = read_verdict_header(filename)
+    tt, vt = header["time_type"], header["value_type"]
+
+    if header["layout"] == "point":
+        dtype = np.dtype([(t_name, tt), (y_name, vt)])
+    else:
+        dtype = np.dtype([("begin", tt), ("end", tt), (y_name, vt)])
+
+    if dtype.itemsize != header["record_size"]:
+        raise ValueError(f"Corrupted verdict file: {filename}")
+
+    if os.path.getsize(filename) == _HEADER.size:
+        return np.empty(0, dtype=dtype)
+    if mmap:
+        return np.memmap(filename, dtype=dtype, mode="r", offset=_HEADER.size)
+    return np.fromfile(filename, dtype=dtype, offset=_HEADER.size)
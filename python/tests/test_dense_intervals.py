@@ -0,0 +1,44 @@
+#
+# Copyright (c) 2019-2025 Dogan Ulus
+#
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at https://mozilla.org/MPL/2.0/.
+#
+import pytest
+
+np = pytest.importorskip("numpy")
+
+from reelay import dense_interval_monitor
+
+
+def test_dense_intervals():
+
+    my_monitor = dense_interval_monitor(pattern="{speed > 12.0}")
+
+    input_sequence = [
+        dict(time=0.0, speed=3.0),
+        dict(time=10.0, speed=9.0),
+        dict(time=12.0, speed=13.0),
+        dict(time=14.0, speed=11.0),
+        dict(time=15.0, speed=9.0),
+        dict(time=18.0, speed=6.0),
+        dict(time=19.0),
+        ]
+
+    result = np.concatenate(
+        [my_monitor.update(input_sequence), my_monitor.close()])
+
+    assert result.dtype.names == ("begin", "end", "value")
+    assert result["begin"].tolist() == [0.0, 12.0, 14.0]
+    assert result["end"].tolist() == [12.0, 14.0, 19.0]
+    assert result["value"].tolist() == [False, True, False]
+
+
+def test_dense_intervals_close_twice():
+
+    my_monitor = dense_interval_monitor(pattern="{speed > 12.0}")
+    my_monitor.update([dict(time=0.0, speed=13.0), dict(time=5.0)])
+
+    assert my_monitor.close().tolist() == [(0.0, 5.0, True)]
+    assert len(my_monitor.close()) == 0
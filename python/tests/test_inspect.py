@@ -0,0 +1,47 @@
+#
+# Copyright (c) 2019-2023 Dogan Ulus
+#
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at https://mozilla.org/MPL/2.0/.
+#
+import math
+
+import pytest
+
+from reelay import admit, discrete_timed_monitor, inspect
+
+
+def test_inspect_bounds():
+
+    inspection = inspect(r"{speed > 13.0} since[:3] {lights_on}")
+
+    assert inspection['timed']
+    assert not inspection['has_references']
+    assert inspection['operators'] == 3
+    assert inspection['states'] == 3
+    assert inspection['windows'] == 1
+    assert inspection['unbounded_windows'] == 0
+    assert inspection['horizon'] == 3
+    assert inspection['memory'] == 3 * 128 + 64
+
+    inspection = inspect(r"{lights_on} since[2:] {speed > 13.0}")
+    assert inspection['unbounded_windows'] == 1
+    assert math.isinf(inspection['horizon'])
+
+
+def test_memory_budget():
+
+    pattern = r"historically[:10]({speed > 13.0} since {lights_on})"
+
+    assert admit(pattern, 1000)['memory'] <= 1000
+    with pytest.raises(ValueError):
+        admit(pattern, 100)
+
+    # Dense windows fragment without a bound on input changes
+    with pytest.raises(ValueError):
+        admit(pattern, 1000, dense=True)
+    assert admit(pattern, 10000, dense=True, rate=10)
+
+    with pytest.raises(ValueError):
+        discrete_timed_monitor(pattern=pattern, memory_budget=100)
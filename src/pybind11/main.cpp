@@ -6,31 +6,92 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "reelay/formatters/python_formatter.hpp"
+#include "reelay/io/verdict_file.hpp"
 #include "reelay/monitors/dense_timed_data_monitor.hpp"
 #include "reelay/monitors/dense_timed_monitor.hpp"
 #include "reelay/monitors/dense_timed_robustness_0_monitor.hpp"
 #include "reelay/monitors/discrete_timed_data_monitor.hpp"
 #include "reelay/monitors/discrete_timed_monitor.hpp"
+#include "reelay/monitors/discrete_timed_regex_monitor.hpp"
 #include "reelay/monitors/discrete_timed_robustness_monitor.hpp"
 #include "reelay/monitors/monitor.hpp"
 #include "reelay/options.hpp"
 #include "reelay/parser/ptl_inspector.hpp"
 
+#include <string>
+#include <vector>
+
 #include "pybind11/pybind11.h"
 
 namespace py = pybind11;
 namespace ry = reelay;
 
+py::dict inspection(reelay::kwargs& result)
+{
+  bool timed = reelay::any_cast<bool>(result["timed"]);
+  bool has_references = reelay::any_cast<bool>(result["has_references"]);
+  auto bounds = reelay::any_cast<reelay::ptl_bounds>(result["bounds"]);
+
+  return py::dict(
+    py::arg("timed") = timed,
+    py::arg("has_references") = has_references,
+    py::arg("operators") = bounds.operators,
+    py::arg("states") = bounds.states,
+    py::arg("windows") = bounds.windows,
+    py::arg("unbounded_windows") = bounds.unbounded_windows,
+    py::arg("horizon") = bounds.horizon,
+    py::arg("intervals") = bounds.intervals,
+    py::arg("span") = bounds.span,
+    py::arg("memory") = bounds.memory());
+}
+
 py::dict inspect(const std::string& pattern)
 {
   auto gadget = reelay::ptl_inspector();
   auto result = gadget.inspect(pattern);
+  return inspection(result);
+}
 
-  bool timed = reelay::any_cast<bool>(result["timed"]);
-  bool has_references = reelay::any_cast<bool>(result["has_references"]);
+py::dict admit(
+  const std::string& pattern, double budget, bool dense, double rate)
+{
+  auto gadget = reelay::ptl_inspector();
+  auto result = gadget.admit(pattern, budget, dense, rate);
+  return inspection(result);
+}
 
-  return py::dict(
-    py::arg("timed") = timed, py::arg("has_references") = has_references);
+// Final verdict intervals packed as in the records of interval verdict files,
+// which NumPy views as a structured array without copying element-wise
+using verdict_interval_t = reelay::verdict_interval<double, bool>;
+
+py::bytes pack_intervals(const std::vector<verdict_interval_t>& intervals)
+{
+  return py::bytes(
+    reinterpret_cast<const char*>(intervals.data()),
+    intervals.size() * sizeof(verdict_interval_t));
+}
+
+template<typename MonitorT>
+py::bytes push_intervals(MonitorT& monitor, const py::iterable& inputs)
+{
+  auto intervals = std::vector<verdict_interval_t>();
+  auto sink = [&intervals](double begin, double end, bool value) {
+    intervals.push_back({begin, end, value});
+  };
+  for(const auto& args : inputs) {
+    monitor.push_intervals(py::reinterpret_borrow<py::object>(args), sink);
+  }
+  return pack_intervals(intervals);
+}
+
+template<typename MonitorT>
+py::bytes close_intervals(MonitorT& monitor)
+{
+  auto intervals = std::vector<verdict_interval_t>();
+  monitor.close_intervals([&intervals](double begin, double end, bool value) {
+    intervals.push_back({begin, end, value});
+  });
+  return pack_intervals(intervals);
 }
 
 PYBIND11_MODULE(MODULE_NAME, m)
@@ -40,6 +101,15 @@ PYBIND11_MODULE(MODULE_NAME, m)
     "from formal specifications using Reelay C++ library.";
 
   m.def("inspect", &inspect, "A function to inspect specifications");
+  m.def(
+    "admit",
+    &admit,
+    "A function to reject specifications whose monitors may exceed a memory "
+    "budget in bytes",
+    py::arg("pattern"),
+    py::arg("budget"),
+    py::arg("dense") = false,
+    py::arg("rate") = reelay::ptl_bounds::unbounded);
 
   py::class_<ry::basic_options>(m, "monitor_options")
     .def(py::init<const std::string&, const std::string&, bool, bool>())
@@ -101,19 +171,37 @@ PYBIND11_MODULE(MODULE_NAME, m)
     .def("now", &condensing_robustness_monitor_t::now)
     .def("update", &condensing_robustness_monitor_t::update);
 
+  using regex_monitor_t =
+    ry::discrete_timed_regex_monitor<intmax_t, py::object, py::object, false>;
+  py::class_<regex_monitor_t>(m, "regex_monitor")
+    .def("make", &regex_monitor_t::make)
+    .def("now", &regex_monitor_t::now)
+    .def("update", &regex_monitor_t::update);
+
+  using condensing_regex_monitor_t =
+    ry::discrete_timed_regex_monitor<intmax_t, py::object, py::object, true>;
+  py::class_<condensing_regex_monitor_t>(m, "condensing_regex_monitor")
+    .def("make", &condensing_regex_monitor_t::make)
+    .def("now", &condensing_regex_monitor_t::now)
+    .def("update", &condensing_regex_monitor_t::update);
+
   using dense_monitor_t =
     ry::dense_timed_monitor<double, py::object, py::object>;
   py::class_<dense_monitor_t>(m, "dense_monitor")
     .def("make", &dense_monitor_t::make)
     .def("now", &dense_monitor_t::now)
-    .def("update", &dense_monitor_t::update);
+    .def("update", &dense_monitor_t::update)
+    .def("push_intervals", &push_intervals<dense_monitor_t>)
+    .def("close_intervals", &close_intervals<dense_monitor_t>);
 
   using dense_data_monitor_t =
     ry::dense_timed_data_monitor<double, py::object, py::object>;
   py::class_<dense_data_monitor_t>(m, "dense_data_monitor")
     .def("make", &dense_data_monitor_t::make)
     .def("now", &dense_data_monitor_t::now)
-    .def("update", &dense_data_monitor_t::update);
+    .def("update", &dense_data_monitor_t::update)
+    .def("push_intervals", &push_intervals<dense_data_monitor_t>)
+    .def("close_intervals", &close_intervals<dense_data_monitor_t>);
 
   using dense_robustness_monitor_t = ry::
     dense_timed_robustness_0_monitor<double, double, py::object, py::object>;
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "reelay/formatters/json_formatter.hpp"
+#include "reelay/io/binary_row.hpp"
+#include "reelay/json.hpp"
+#include "reelay/monitors/discrete_timed_monitor.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using time_type = int64_t;
+using input_type = reelay::binary_row;
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Binary Rows",
+  "[binary_row]")
+{
+  auto schema = reelay::binary_schema::packed(
+    {{"time", reelay::scalar_kind::int64},
+     {"p1", reelay::scalar_kind::boolean},
+     {"x1", reelay::scalar_kind::float64}});
+
+  std::ostringstream stream;
+  {
+    auto writer = reelay::binary_row_writer(stream, schema);
+    std::vector<double> xs = {1.0, 3.0, 4.0, 2.0, 5.0};
+    for(std::size_t i = 0; i < xs.size(); i++) {
+      writer.set("time", i);
+      writer.set("p1", i % 2 == 0);
+      writer.set("x1", xs[i]);
+      writer.commit();
+    }
+  }
+  const std::string bytes = stream.str();
+
+  SECTION("SchemaRoundTrip")
+  {
+    auto [loaded, offset] =
+      reelay::binary_schema::read(bytes.data(), bytes.size());
+
+    CHECK(offset % 8 == 0);
+    CHECK(loaded.row_size == 17);
+    CHECK(loaded.fields.size() == 3);
+    CHECK(loaded.find("x1")->offset == 9);
+    CHECK(loaded.find("x1")->kind == reelay::scalar_kind::float64);
+    CHECK(loaded.time_field == loaded.find("time"));
+    CHECK((bytes.size() - offset) / loaded.row_size == 5);
+
+    auto row = reelay::binary_row{&loaded, bytes.data() + offset};
+    const std::string key = "x1";
+    CHECK(reelay::datafield<input_type>::contains(row, key));
+    CHECK(reelay::datafield<input_type>::as_floating(row, key) == 1.0);
+    CHECK(reelay::datafield<input_type>::as_bool(row, "p1"));
+    CHECK_FALSE(reelay::datafield<input_type>::contains(row, "y1"));
+    CHECK_THROWS(reelay::datafield<input_type>::as_string(row, key));
+  }
+
+  SECTION("MonitorRows")
+  {
+    auto [loaded, offset] =
+      reelay::binary_schema::read(bytes.data(), bytes.size());
+    auto first = reelay::binary_row_iterator(&loaded, bytes.data() + offset);
+    auto last = first + 5;
+
+    auto options = reelay::basic_options();
+    auto monitor = reelay::discrete_timed_monitor<
+      time_type,
+      input_type,
+      reelay::json,
+      true>::make("{p1} or {x1 > 3.5}", options);
+
+    auto result = std::vector<std::pair<time_type, bool>>();
+    monitor.push(
+      first, last, [&](time_type t, bool v) { result.emplace_back(t, v); });
+
+    auto expected = std::vector<std::pair<time_type, bool>>(
+      {{0, true}, {1, false}, {2, true}, {3, false}, {4, true}});
+
+    CHECK(result == expected);
+  }
+
+  SECTION("LayoutKeys")
+  {
+    auto [loaded, offset] =
+      reelay::binary_schema::read(bytes.data(), bytes.size());
+    auto row = reelay::binary_row{&loaded, bytes.data() + offset + 17};
+
+    // The same key binds again to a schema with another layout
+    auto swapped = reelay::binary_schema::packed(
+      {{"x1", reelay::scalar_kind::float64},
+       {"time", reelay::scalar_kind::int64}});
+    std::ostringstream other;
+    {
+      auto writer = reelay::binary_row_writer(other, swapped);
+      writer.set("time", 7);
+      writer.set("x1", 9.5);
+      writer.commit();
+    }
+    const std::string other_bytes = other.str();
+    auto [reloaded, other_offset] =
+      reelay::binary_schema::read(other_bytes.data(), other_bytes.size());
+    auto other_row =
+      reelay::binary_row{&reloaded, other_bytes.data() + other_offset};
+
+    const auto key = reelay::layout_key("x1");
+    const auto missing = reelay::layout_key("p1");
+    CHECK(reelay::datafield<input_type>::as_floating(row, key) == 3.0);
+    CHECK(reelay::datafield<input_type>::as_floating(other_row, key) == 9.5);
+    CHECK(reelay::datafield<input_type>::as_floating(row, key) == 3.0);
+    CHECK(reelay::datafield<input_type>::contains(row, missing));
+    CHECK_FALSE(reelay::datafield<input_type>::contains(other_row, missing));
+    CHECK_THROWS(reelay::datafield<input_type>::as_bool(other_row, missing));
+  }
+
+  SECTION("TemporarySchema")
+  {
+    std::ostringstream other;
+    {
+      auto writer = reelay::binary_row_writer(
+        other, reelay::binary_schema::packed(
+                 {{"time", reelay::scalar_kind::int64},
+                  {"x1", reelay::scalar_kind::float64}}));
+      writer.set("time", 3);
+      writer.set("x1", 2.5);
+      writer.commit();
+    }
+    const std::string other_bytes = other.str();
+    auto [loaded, offset] =
+      reelay::binary_schema::read(other_bytes.data(), other_bytes.size());
+    auto row = reelay::binary_row{&loaded, other_bytes.data() + offset};
+    CHECK(loaded.row_size == 16);
+    CHECK(reelay::datafield<input_type>::as_floating(row, "x1") == 2.5);
+  }
+
+  SECTION("CorruptedHeader")
+  {
+    CHECK_THROWS(reelay::binary_schema::read(bytes.data(), 12));
+    CHECK_THROWS(reelay::binary_schema::read("RYLB0000000000000000", 20));
+
+    auto patched = [&bytes](std::size_t pos, uint32_t word) {
+      auto copy = bytes;
+      std::memcpy(copy.data() + pos, &word, sizeof(word));
+      return copy;
+    };
+    auto empty_rows = patched(8, 0);
+    CHECK_THROWS(reelay::binary_schema::read(empty_rows.data(), bytes.size()));
+    auto past_end = patched(12, uint32_t(bytes.size() + 8));
+    CHECK_THROWS(reelay::binary_schema::read(past_end.data(), bytes.size()));
+    // The offset of the int64 time field wraps around the row size
+    auto wrapped = patched(20, 0xFFFFFFFC);
+    CHECK_THROWS(reelay::binary_schema::read(wrapped.data(), bytes.size()));
+    auto past_row = patched(20, 10);
+    CHECK_THROWS(reelay::binary_schema::read(past_row.data(), bytes.size()));
+
+    auto offset = reelay::binary_schema::read(bytes.data(), bytes.size()).second;
+    CHECK(reelay::binary_schema::read(bytes.data(), offset).second == offset);
+  }
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2019-2025 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "reelay/formatters/json_formatter.hpp"
+#include "reelay/io/csv_row.hpp"
+#include "reelay/json.hpp"
+#include "reelay/monitors/dense_timed_monitor.hpp"
+#include "reelay/monitors/discrete_timed_monitor.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using input_type = reelay::csv_record;
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Delimited Text Rows",
+  "[csv_row]")
+{
+  SECTION("Scanning")
+  {
+    const std::string text = "0123456789abcdefghij,klmnopqrstuvwxyz0123\n";
+    const char* first = text.data();
+    const char* last = first + text.size();
+
+    CHECK(reelay::csv::scan(first, last, ',') == first + 20);
+    CHECK(reelay::csv::scan(first + 21, last, ',') == last - 1);
+    CHECK(reelay::csv::scan(first + 21, last - 1, ',') == last - 1);
+    CHECK(reelay::csv::scan(first, first + 5, ',') == first + 5);
+    CHECK(reelay::csv::scan(first, last, 'x') == first + 34);
+    CHECK(reelay::csv::line_end(first, last) == last - 1);
+    CHECK(reelay::csv::trim(first + 20, first + 20).empty());
+  }
+
+  SECTION("ColumnBinding")
+  {
+    auto table = reelay::csv_table("\xEF\xBB\xBFid, time ,x,p\r", {"p", "x"});
+
+    CHECK(table.columns == std::vector<std::string>({"id", "time", "x", "p"}));
+    CHECK(table.keys == std::vector<std::string>({"time", "p", "x"}));
+    CHECK(table.slot_of[0] == reelay::csv_table::unbound);
+    CHECK(table.slot_of[1] == 0);
+    CHECK(table.slot_of[3] == 1);
+    CHECK(table.last_bound == 3);
+
+    CHECK_THROWS_AS(reelay::csv_table("time,x", {"y"}), std::out_of_range);
+    CHECK_THROWS_AS(reelay::csv_table("t,x", {"x"}), std::out_of_range);
+
+    // Untimed tables bind referenced columns only, `time` included
+    auto untimed = reelay::csv_table("x,time,p", {"p", "time"}, ',', false);
+    CHECK(untimed.keys == std::vector<std::string>({"p", "time"}));
+    CHECK(untimed.slot_of[1] == 1);
+    CHECK(untimed.slot_of[2] == 0);
+    CHECK_NOTHROW(reelay::csv_table("t,x", {"x"}, ',', false));
+
+    // Repeated keys are bound once
+    auto repeated = reelay::csv_table("time,x,p", {"x", "p", "x", "time"});
+    CHECK(repeated.keys == std::vector<std::string>({"time", "x", "p"}));
+    CHECK(repeated.slot_of == std::vector<std::size_t>({0, 1, 2}));
+    auto untimed_repeated =
+      reelay::csv_table("time,x", {"x", "time", "x"}, ',', false);
+    CHECK(untimed_repeated.keys == std::vector<std::string>({"x", "time"}));
+  }
+
+  SECTION("TypedCells")
+  {
+    auto table =
+      reelay::csv_table("time;n;x;p;s;e;z", {"n", "x", "p", "s", "e"}, ';');
+    auto record = reelay::csv_record(table);
+
+    const std::string row = "3; -12 ;2.5e1;true;on;;99\r";
+    record.parse(row.data(), row.data() + row.size());
+
+    const std::string n = "n";
+    const std::string x = "x";
+    const std::string p = "p";
+    const std::string s = "s";
+    const std::string e = "e";
+    const std::string z = "z";
+    CHECK(reelay::timefield<int64_t, input_type>::get_time(record) == 3);
+    CHECK(reelay::timefield<double, input_type>::get_time(record) == 3.0);
+    CHECK(reelay::datafield<input_type>::as_integer(record, n) == -12);
+    CHECK(reelay::datafield<input_type>::as_floating(record, x) == 25.0);
+    CHECK(reelay::datafield<input_type>::as_bool(record, p));
+    CHECK(reelay::datafield<input_type>::as_string(record, s) == "on");
+    CHECK_FALSE(reelay::datafield<input_type>::contains(record, e));
+    CHECK(reelay::datafield<input_type>::contains(record, n));
+    CHECK_THROWS(reelay::datafield<input_type>::as_bool(record, s));
+    CHECK_THROWS(reelay::datafield<input_type>::contains(record, z));
+
+    const std::string shorter = "4;1";
+    record.parse(shorter.data(), shorter.data() + shorter.size());
+    CHECK(reelay::datafield<input_type>::as_bool(record, n));
+    CHECK_FALSE(reelay::datafield<input_type>::contains(record, x));
+    CHECK_FALSE(reelay::datafield<input_type>::contains(record, s));
+
+    // Numbers out of integer range are only floating
+    const std::string large = "nan;inf;1e300;false;x;;";
+    record.parse(large.data(), large.data() + large.size());
+    CHECK(reelay::datafield<input_type>::as_floating(record, x) == 1e300);
+    CHECK_THROWS_AS(
+      reelay::datafield<input_type>::as_integer(record, x), std::out_of_range);
+    CHECK_THROWS_AS(
+      reelay::datafield<input_type>::as_integer(record, n), std::out_of_range);
+    using timefield_t = reelay::timefield<int64_t, input_type>;
+    CHECK_THROWS_AS(timefield_t::get_time(record), std::out_of_range);
+  }
+
+  SECTION("MonitorRows")
+  {
+    const std::string text =
+      "time,x1,p1,note\n"
+      "0,1.0,1,a\n"
+      "1,3.0,0,b\n"
+      "\n"
+      "2,4.0,1,c\r\n"
+      "3,2.0,0,d\n"
+      "4,5.0,1,e";
+
+    auto inspection = std::vector<std::string>({"p1", "x1"});
+    auto table = reelay::csv_table(
+      std::string_view(text.data(), text.find('\n')), inspection);
+    auto record = reelay::csv_record(table);
+
+    auto options = reelay::basic_options();
+    auto monitor = reelay::discrete_timed_monitor<
+      int64_t,
+      input_type,
+      reelay::json,
+      true>::make("{p1} and not {x1 > 4.5}", options);
+
+    auto result = std::vector<std::pair<int64_t, bool>>();
+    reelay::for_each_row(
+      text.data() + text.find('\n') + 1,
+      text.data() + text.size(),
+      record,
+      [&](const input_type& row) {
+        monitor.push(
+          row, [&](int64_t t, bool v) { result.emplace_back(t, v); });
+      });
+
+    auto expected = std::vector<std::pair<int64_t, bool>>(
+      {{0, true}, {1, false}, {2, true}, {3, false}});
+
+    CHECK(result == expected);
+  }
+
+  SECTION("DiscreteRowsWithoutTime")
+  {
+    const std::string text =
+      "x1,p1\n"
+      "1.0,1\n"
+      "5.0,1\n"
+      "2.0,0\n";
+
+    auto table = reelay::csv_table(
+      std::string_view(text.data(), text.find('\n')), {"p1", "x1"}, ',', false);
+    auto record = reelay::csv_record(table);
+
+    auto options = reelay::basic_options();
+    auto monitor = reelay::discrete_timed_monitor<
+      int64_t,
+      input_type,
+      reelay::json,
+      true>::make("{p1} and not {x1 > 4.5}", options);
+
+    auto result = std::vector<std::pair<int64_t, bool>>();
+    reelay::for_each_row(
+      text.data() + text.find('\n') + 1,
+      text.data() + text.size(),
+      record,
+      [&](const input_type& row) {
+        monitor.push(
+          row, [&](int64_t t, bool v) { result.emplace_back(t, v); });
+      });
+
+    auto expected = std::vector<std::pair<int64_t, bool>>(
+      {{0, true}, {1, false}});
+
+    CHECK(result == expected);
+
+    using timefield_t = reelay::timefield<int64_t, input_type>;
+    CHECK_THROWS_AS(timefield_t::get_time(record), std::out_of_range);
+  }
+
+  SECTION("MappedFile")
+  {
+    const std::string filename = "reelay_csv_row_test.csv";
+    {
+      std::ofstream output(filename, std::ios::binary);
+      output << "time\tspeed\n";
+      output << "0.0\t3.0\n10.0\t9.0\n12.0\t13.0\n14.0\t11.0\n19.0\t\n";
+    }
+
+    auto reader = reelay::csv_reader(filename);
+    auto table = reelay::csv_table(reader.header(), {"speed"}, '\t');
+
+    auto options = reelay::basic_options();
+    auto monitor = reelay::dense_timed_monitor<
+      double,
+      input_type,
+      reelay::json>::make("{speed > 12.0}", options);
+
+    auto result = std::vector<std::pair<double, bool>>();
+    reader.for_each(table, [&](const input_type& row) {
+      monitor.push(row, [&](double t, bool v) { result.emplace_back(t, v); });
+    });
+
+    auto expected = std::vector<std::pair<double, bool>>(
+      {{0.0, false}, {12.0, true}, {14.0, false}});
+
+    CHECK(result == expected);
+
+    std::remove(filename.c_str());
+  }
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "reelay/datafield.hpp"
+#include "reelay/json.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+TEST_CASE("String Views", "[datafield]")
+{
+  SECTION("JSON")
+  {
+    using input_type = reelay::json;
+    static_assert(
+      reelay::has_string_view_field<input_type, std::string>::value);
+    static_assert(
+      reelay::has_string_view_field<input_type, std::size_t>::value);
+
+    input_type obj = {{"time", 1}, {"mode", "idle"}};
+    const std::string key = "mode";
+
+    auto value = reelay::string_field(obj, key);
+    static_assert(std::is_same_v<decltype(value), std::string_view>);
+    CHECK(value == "idle");
+    // Refers to the string stored in the object
+    CHECK(value.data() == obj["mode"].get_ref<const std::string&>().data());
+
+    CHECK(reelay::datafield<input_type>::contains(obj, std::string_view(key)));
+    CHECK_FALSE(reelay::datafield<input_type>::contains(
+      obj, std::string_view("speed")));
+
+    input_type arr = {"start", "stop"};
+    CHECK(reelay::string_field(arr, std::size_t(1)) == "stop");
+  }
+
+  SECTION("String Map")
+  {
+    using input_type = std::unordered_map<std::string, std::string>;
+    input_type obj = {{"time", "1"}, {"mode", "idle"}};
+    const std::string key = "mode";
+
+    auto value = reelay::string_field(obj, key);
+    static_assert(std::is_same_v<decltype(value), std::string_view>);
+    CHECK(value.data() == obj.at("mode").data());
+  }
+}
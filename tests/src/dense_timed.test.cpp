@@ -5,14 +5,18 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
+#include "reelay/formatters/json_formatter.hpp"
 #include "reelay/intervals.hpp"
 #include "reelay/json.hpp"
+#include "reelay/monitors/dense_timed_monitor.hpp"
 #include "reelay/networks/dense_timed_network.hpp"
+#include "reelay/networks/segment_sweep.hpp"
 #include "reelay/options.hpp"
 
 #include <catch2/catch_test_macros.hpp>
 
 #include <iostream>
+#include <tuple>
 #include <vector>
 
 using time_type = double;
@@ -514,6 +518,84 @@ TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
 
     CHECK(result1 == expected1);
   }
+
+  SECTION("Nested GreaterEqual_Linear")
+  {
+    std::vector<input_type> sequence = std::vector<input_type>();
+
+    sequence.push_back(input_type{{"time", 0}, {"a", {{"x1", -2}}}});
+    sequence.push_back(input_type{{"time", 1}, {"a", {{"x1", -2}}}});
+    sequence.push_back(input_type{{"time", 2}, {"a", {{"x1", -1}}}});
+    sequence.push_back(input_type{{"time", 4}, {"a", {{"x1", 1}}}});
+    sequence.push_back(input_type{{"time", 5}, {"a", {{"x1", 2}}}});
+    sequence.push_back(input_type{{"time", 6}, {"a", {{"x1", 2}}}});
+    sequence.push_back(input_type{{"time", 7}, {"a", {{"x1", 1}}}});
+    sequence.push_back(input_type{{"time", 9}, {"a", {{"x1", -1}}}});
+    sequence.push_back(input_type{{"time", 10}, {"a", {{"x1", -2}}}});
+    sequence.push_back(input_type{{"time", 11}, {"a", {{"x1", 0}}}});
+    sequence.push_back(input_type{{"time", 12}, {"a", {{"x1", 0}}}});
+    sequence.push_back(input_type{{"time", 13}, {"a", {{"x1", 2}}}});
+    sequence.push_back(input_type{{"time", 14}, {"a", {{"x1", 0}}}});
+    sequence.push_back(input_type{{"time", 15}, {"a", {{"x1", -2}}}});
+
+    auto opts =
+      reelay::basic_options().with_interpolation(reelay::piecewise::linear);
+
+    auto net1 = reelay::dense_timed_network<time_type, input_type>::make(
+      "a::{x1 >= 0}", opts);
+
+    auto result1 = interval_set();
+
+    for(const auto& s : sequence) {
+      net1.update(s);
+      result1 = result1 | net1.output();
+    }
+
+    auto expected1 = interval_set();
+    expected1.add(interval::left_open(3, 8));
+    expected1.add(interval::left_open(11, 14));
+
+    CHECK(result1 == expected1);
+  }
+
+  SECTION("Nested Missing Path")
+  {
+    std::vector<input_type> nested = std::vector<input_type>();
+
+    nested.push_back(input_type{{"time", 0}, {"a", {{"p1", true}}}});
+    nested.push_back(input_type{{"time", 1}, {"a", {{"p1", true}}}});
+    nested.push_back(input_type{{"time", 2}});
+    nested.push_back(input_type{{"time", 3}});
+    nested.push_back(input_type{{"time", 4}, {"a", {{"p1", false}}}});
+
+    std::vector<input_type> flat = std::vector<input_type>();
+
+    flat.push_back(input_type{{"time", 0}, {"p1", true}});
+    flat.push_back(input_type{{"time", 1}, {"p1", true}});
+    flat.push_back(input_type{{"time", 2}});
+    flat.push_back(input_type{{"time", 3}});
+    flat.push_back(input_type{{"time", 4}, {"p1", false}});
+
+    auto net1 =
+      reelay::dense_timed_network<time_type, input_type>::make("a::{p1}");
+    auto net2 = reelay::dense_timed_network<time_type, input_type>::make("{p1}");
+
+    auto result1 = interval_set();
+    auto result2 = interval_set();
+
+    for(std::size_t i = 0; i < nested.size(); i++) {
+      net1.update(nested[i]);
+      result1 = result1 | net1.output();
+      net2.update(flat[i]);
+      result2 = result2 | net2.output();
+    }
+
+    auto expected = interval_set();
+    expected.add(interval::left_open(0, 4));
+
+    CHECK(result1 == expected);
+    CHECK(result2 == expected);
+  }
 }
 
 TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
@@ -1120,3 +1202,299 @@ TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
     CHECK(result1 == expected1);
   }
 }
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Dense Timed Sinks",
+  "[dense_timed]")
+{
+  using verdict_t = std::pair<time_type, bool>;
+
+  SECTION("PushIntervalBoundaries")
+  {
+    std::vector<input_type> sequence = std::vector<input_type>();
+
+    sequence.push_back(input_type{{"time", 0}, {"x1", true}});
+    sequence.push_back(input_type{{"time", 3.1}});
+    sequence.push_back(input_type{{"time", 3.3}, {"x1", false}});
+    sequence.push_back(input_type{{"time", 3.5}, {"x1", false}});
+    sequence.push_back(input_type{{"time", 4}});
+    sequence.push_back(input_type{{"time", 5.2}, {"x1", true}});
+    sequence.push_back(input_type{{"time", 5.5}});
+
+    auto options = reelay::basic_options();
+    auto monitor1 = reelay::dense_timed_monitor<
+      time_type,
+      input_type,
+      reelay::json>::make("{x1}", options);
+    auto monitor2 = reelay::dense_timed_monitor<
+      time_type,
+      input_type,
+      reelay::json>::make("{x1}", options);
+
+    auto result1 = std::vector<verdict_t>();
+    auto result2 = std::vector<verdict_t>();
+
+    for(const auto& s : sequence) {
+      monitor1.push(
+        s, [&](time_type t, bool v) { result1.emplace_back(t, v); });
+      for(const auto& output : monitor2.update(s)) {
+        result2.emplace_back(output["time"], output["value"]);
+      }
+    }
+
+    auto expected = std::vector<verdict_t>(
+      {{0, true}, {3.3, false}, {5.2, true}});
+
+    CHECK(result1 == expected);
+    CHECK(result1 == result2);
+  }
+
+  SECTION("PushFinalIntervals")
+  {
+    using interval_t = std::tuple<time_type, time_type, bool>;
+
+    std::vector<input_type> sequence = std::vector<input_type>();
+
+    sequence.push_back(input_type{{"time", 0}, {"x1", true}});
+    sequence.push_back(input_type{{"time", 3.1}});
+    sequence.push_back(input_type{{"time", 3.3}, {"x1", false}});
+    sequence.push_back(input_type{{"time", 3.5}, {"x1", false}});
+    sequence.push_back(input_type{{"time", 4}});
+    sequence.push_back(input_type{{"time", 5.2}, {"x1", true}});
+    sequence.push_back(input_type{{"time", 5.5}});
+    sequence.push_back(input_type{{"time", 9.5}, {"x1", false}});
+    sequence.push_back(input_type{{"time", 10}});
+
+    auto options = reelay::basic_options();
+    auto sink = [](std::vector<interval_t>& intervals) {
+      return [&intervals](time_type begin, time_type end, bool value) {
+        intervals.emplace_back(begin, end, value);
+      };
+    };
+
+    auto monitor1 = reelay::dense_timed_monitor<
+      time_type,
+      input_type,
+      reelay::json>::make("{x1}", options);
+
+    auto result1 = std::vector<interval_t>();
+    monitor1.push_intervals(
+      sequence.begin(), sequence.begin() + 7, sink(result1));
+    CHECK(
+      result1 ==
+      std::vector<interval_t>({{0, 3.3, true}, {3.3, 5.2, false}}));
+
+    monitor1.close_intervals(sink(result1));
+    CHECK(result1.back() == interval_t(5.2, 5.5, true));
+
+    // The closed interval continues with the same value
+    monitor1.push_intervals(
+      sequence.begin() + 7, sequence.end(), sink(result1));
+    monitor1.close_intervals(sink(result1));
+    CHECK(
+      result1 == std::vector<interval_t>(
+                   {{0, 3.3, true},
+                    {3.3, 5.2, false},
+                    {5.2, 5.5, true},
+                    {5.5, 9.5, true},
+                    {9.5, 10, false}}));
+
+    // Intervals pair up consecutive change points
+    auto monitor2 = reelay::dense_timed_monitor<
+      time_type,
+      input_type,
+      reelay::json>::make("once[1:2]{x1} and not {x1}", options);
+    auto monitor3 = reelay::dense_timed_monitor<
+      time_type,
+      input_type,
+      reelay::json>::make("once[1:2]{x1} and not {x1}", options);
+
+    auto result2 = std::vector<interval_t>();
+    monitor2.push_intervals(sequence.begin(), sequence.end(), sink(result2));
+    monitor2.close_intervals(sink(result2));
+
+    auto points = std::vector<verdict_t>();
+    monitor3.push(sequence.begin(), sequence.end(), [&](time_type t, bool v) {
+      points.emplace_back(t, v);
+    });
+    auto expected = std::vector<interval_t>();
+    for(std::size_t i = 0; i < points.size(); i++) {
+      auto end = i + 1 < points.size() ? points[i + 1].first : 10.0;
+      expected.emplace_back(points[i].first, end, points[i].second);
+    }
+    CHECK(result2.size() > 2);
+    CHECK(result2 == expected);
+  }
+}
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Dense Timed Sample Arguments",
+  "[dense_timed]")
+{
+  SECTION("CurrentSampleOnly")
+  {
+    struct probe final
+        : reelay::dense_timed_state<input_type, interval_set, time_type> {
+      std::vector<int> seen;
+      bool aliased = true;
+
+      void update(
+        const input_type& pargs,
+        const input_type& args,
+        time_type /*tp*/,
+        time_type /*tn*/) override
+      {
+        aliased = aliased and &pargs == &args;
+        seen.push_back(args["x1"].get<int>());
+      }
+
+      interval_set output(time_type /*tp*/, time_type /*tn*/) override
+      {
+        return interval_set();
+      }
+    };
+
+    auto state = std::make_shared<probe>();
+    auto net1 = reelay::dense_timed_network<time_type, input_type>(
+      state, {state});
+
+    net1.update(input_type{{"time", 0}, {"x1", 1}});
+    net1.update(input_type{{"time", 1}, {"x1", 2}});
+
+    CHECK(state->aliased);
+    CHECK(state->seen == std::vector<int>({1, 2}));
+  }
+
+  SECTION("InterpolationKeepsPreviousValues")
+  {
+    auto opts =
+      reelay::basic_options().with_interpolation(reelay::piecewise::linear);
+    auto net1 = reelay::dense_timed_network<time_type, input_type>::make(
+      "{x1 > 0}", opts);
+
+    net1.update(input_type{{"time", 0}, {"x1", -1}});
+    net1.update(input_type{{"time", 2}, {"x1", 1}});
+
+    CHECK(net1.output() == interval_set(interval::left_open(1, 2)));
+  }
+}
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Dense Timed Segment Sweep",
+  "[dense_timed]")
+{
+  SECTION("ConstantPeriods")
+  {
+    auto a = interval_set();
+    a.add(interval::left_open(1, 4));
+    a.add(interval::left_open(6, 8));
+    auto b = interval_set(interval::left_open(2, 7));
+    auto c = interval_set(interval::left_open(0, 10));
+
+    auto sweep = reelay::segment_sweep<interval_set>();
+    sweep.add(a);
+    sweep.add(b);
+    sweep.add(c);
+
+    auto all = interval_set();
+    auto any = interval_set();
+    auto periods = std::vector<std::pair<time_type, time_type>>();
+
+    sweep.run(0, 10, [&](time_type begin, time_type end) {
+      periods.emplace_back(begin, end);
+      if(sweep.all()) {
+        all.add(interval::left_open(begin, end));
+      }
+      if(sweep.any()) {
+        any.add(interval::left_open(begin, end));
+      }
+    });
+
+    auto expected_periods = std::vector<std::pair<time_type, time_type>>(
+      {{0, 1}, {1, 2}, {2, 4}, {4, 6}, {6, 7}, {7, 8}, {8, 10}});
+
+    CHECK(periods == expected_periods);
+    CHECK(all == (a & b & c));
+    CHECK(any == (a + b + c));
+  }
+
+  SECTION("Conjunction_ThreeWay")
+  {
+    std::vector<input_type> sequence = std::vector<input_type>();
+
+    sequence.push_back(
+      input_type{{"time", 0}, {"p1", true}, {"p2", true}, {"p3", true}});
+    sequence.push_back(
+      input_type{{"time", 2}, {"p1", true}, {"p2", false}, {"p3", true}});
+    sequence.push_back(
+      input_type{{"time", 3}, {"p1", true}, {"p2", true}, {"p3", true}});
+    sequence.push_back(
+      input_type{{"time", 5}, {"p1", false}, {"p2", true}, {"p3", true}});
+    sequence.push_back(input_type{{"time", 6}});
+
+    auto net1 = reelay::dense_timed_network<time_type, input_type>::make(
+      "{p1} and {p2} and {p3}");
+
+    auto result = interval_set();
+
+    for(const auto& s : sequence) {
+      net1.update(s);
+      result = result | net1.output();
+    }
+
+    auto expected = interval_set();
+    expected.add(interval::left_open(0, 2));
+    expected.add(interval::left_open(3, 5));
+
+    CHECK(result == expected);
+  }
+}
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Dense Timed Decided Verdicts",
+  "[dense_timed]")
+{
+  SECTION("Historically")
+  {
+    std::vector<input_type> sequence = std::vector<input_type>();
+
+    sequence.push_back(input_type{{"time", 0}, {"p1", true}});
+    sequence.push_back(input_type{{"time", 10}, {"p1", false}});
+    sequence.push_back(input_type{{"time", 20}, {"p1", true}});
+    sequence.push_back(input_type{{"time", 30}});
+
+    auto net1 = reelay::dense_timed_network<time_type, input_type>::make(
+      "historically({p1})");
+
+    auto result = interval_set();
+    auto decided = std::vector<bool>();
+
+    for(const auto& s : sequence) {
+      net1.update(s);
+      result = result | net1.output();
+      decided.push_back(net1.decided().has_value());
+    }
+
+    auto expected = interval_set();
+    expected.add(interval::left_open(0, 10));
+
+    CHECK(result == expected);
+    CHECK(decided == std::vector<bool>({false, false, true, true}));
+    CHECK(net1.states.empty());
+  }
+
+  SECTION("Once Disjunction")
+  {
+    auto net1 = reelay::dense_timed_network<time_type, input_type>::make(
+      "{p1} or once {p2}");
+
+    net1.update(input_type{{"time", 0}, {"p1", false}, {"p2", true}});
+    CHECK_FALSE(net1.decided().has_value());
+    net1.update(input_type{{"time", 10}, {"p1", false}, {"p2", false}});
+    CHECK(net1.decided() == true);
+    net1.update(input_type{{"time", 20}, {"p1", false}, {"p2", false}});
+
+    auto expected = interval_set(interval::left_open(10, 20));
+    CHECK(net1.output() == expected);
+  }
+}
@@ -5,12 +5,20 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
+#include "reelay/formatters/json_formatter.hpp"
+#include "reelay/io/binary_row.hpp"
 #include "reelay/json.hpp"
+#include "reelay/monitors/discrete_timed_monitor.hpp"
+#include "reelay/monitors/discrete_timed_monitor_set.hpp"
+#include "reelay/monitors/discrete_timed_parallel_monitor.hpp"
+#include "reelay/networks/discrete_timed_automaton.hpp"
 #include "reelay/networks/discrete_timed_network.hpp"
+#include "reelay/networks/discrete_timed_parallel_network.hpp"
 
 #include <catch2/catch_test_macros.hpp>
 
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -307,6 +315,56 @@ TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
 
     CHECK(result == expected);
   }
+
+  SECTION("Nested Record")
+  {
+    std::vector<input_type> sequence = std::vector<input_type>();
+
+    sequence.push_back(input_type{{"a", {{"b", {{"x1", 2}, {"p1", true}}}}}});
+    sequence.push_back(input_type{{"a", {{"b", {{"x1", 4}, {"p1", true}}}}}});
+    sequence.push_back(input_type{{"a", {{"c", 1}}}});
+    sequence.push_back(input_type{{"x1", 4}, {"p1", false}});
+    sequence.push_back(input_type{{"a", {{"b", {{"x1", 4}, {"p1", false}}}}}});
+    sequence.push_back(input_type{{"a", {{"b", {{"x1", 6}, {"p1", true}}}}}});
+
+    auto net1 = reelay::discrete_timed_network<time_type, input_type>::make(
+      "a::b::{x1 > 3, x1 < 5, p1}");
+
+    auto result = std::vector<bool>();
+
+    for(const auto& row : sequence) {
+      net1.update(row);
+      result.push_back(net1.output());
+    }
+
+    // Missing paths keep the previous verdict
+    auto expected = std::vector<bool>({false, true, true, true, false, false});
+
+    CHECK(result == expected);
+  }
+
+  SECTION("Nested Record Inside Record")
+  {
+    std::vector<input_type> sequence = std::vector<input_type>();
+
+    sequence.push_back(input_type{{"p1", true}, {"a", {{"p1", false}}}});
+    sequence.push_back(input_type{{"p1", true}, {"a", {{"p1", true}}}});
+    sequence.push_back(input_type{{"p1", false}, {"a", {{"p1", true}}}});
+
+    auto net1 = reelay::discrete_timed_network<time_type, input_type>::make(
+      "{p1, a::{p1}}");
+
+    auto result = std::vector<bool>();
+
+    for(const auto& row : sequence) {
+      net1.update(row);
+      result.push_back(net1.output());
+    }
+
+    auto expected = std::vector<bool>({false, true, false});
+
+    CHECK(result == expected);
+  }
 }
 
 TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
@@ -856,3 +914,606 @@ TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
     CHECK(result1 == expected1);
   }
 }
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Discrete Timed Sinks",
+  "[discrete_timed]")
+{
+  using verdict_t = std::pair<time_type, bool>;
+
+  SECTION("PushOnlyOnChange")
+  {
+    std::vector<input_type> sequence = std::vector<input_type>();
+
+    sequence.push_back(input_type{{"p1", false}, {"p2", false}});
+    sequence.push_back(input_type{{"p1", true}, {"p2", true}});
+    sequence.push_back(input_type{{"p1", true}, {"p2", false}});
+    sequence.push_back(input_type{{"p1", true}, {"p2", false}});
+    sequence.push_back(input_type{{"p1", false}, {"p2", false}});
+    sequence.push_back(input_type{{"p1", false}, {"p2", false}});
+    sequence.push_back(input_type{{"p1", false}, {"p2", true}});
+
+    auto options = reelay::basic_options();
+    auto monitor1 = reelay::discrete_timed_monitor<
+      time_type,
+      input_type,
+      reelay::json,
+      true>::make("{p1} since {p2}", options);
+    auto monitor2 = reelay::discrete_timed_monitor<
+      time_type,
+      input_type,
+      reelay::json,
+      true>::make("{p1} since {p2}", options);
+
+    auto result1 = std::vector<verdict_t>();
+    auto result2 = std::vector<verdict_t>();
+
+    for(const auto& s : sequence) {
+      monitor1.push(
+        s, [&](time_type t, bool v) { result1.emplace_back(t, v); });
+      auto output = monitor2.update(s);
+      if(not output.empty()) {
+        result2.emplace_back(output["time"], output["value"]);
+      }
+    }
+
+    auto expected = std::vector<verdict_t>(
+      {{0, false}, {1, true}, {4, false}, {6, true}});
+
+    CHECK(result1 == expected);
+    CHECK(result1 == result2);
+  }
+}
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Discrete Timed Decided Verdicts",
+  "[discrete_timed]")
+{
+  SECTION("Historically")
+  {
+    std::vector<input_type> sequence = std::vector<input_type>();
+
+    sequence.push_back(input_type{{"p1", true}, {"p2", false}});
+    sequence.push_back(input_type{{"p1", true}, {"p2", true}});
+    sequence.push_back(input_type{{"p1", false}, {"p2", true}});
+    sequence.push_back(input_type{{"p1", true}, {"p2", true}});
+
+    auto net1 = reelay::discrete_timed_network<time_type, input_type>::make(
+      "historically({p1} or {p2})");
+
+    auto result1 = std::vector<bool>();
+    auto decided1 = std::vector<bool>();
+
+    for(const auto& s : sequence) {
+      net1.update(s);
+      result1.push_back(net1.output());
+      decided1.push_back(net1.decided().has_value());
+    }
+
+    CHECK(result1 == std::vector<bool>({true, true, true, true}));
+    CHECK(decided1 == std::vector<bool>({false, false, false, false}));
+
+    net1.update(input_type{{"p1", false}, {"p2", false}});
+    net1.update(input_type{{"p1", true}, {"p2", true}});
+
+    CHECK_FALSE(net1.output());
+    CHECK(net1.decided() == false);
+    CHECK(net1.states.empty());
+  }
+
+  SECTION("Once Subformula")
+  {
+    auto net1 = reelay::discrete_timed_network<time_type, input_type>::make(
+      "{p1} and once({p2} and {p3})");
+
+    auto size = net1.states.size();
+
+    net1.update(input_type{{"p1", true}, {"p2", true}, {"p3", false}});
+    CHECK_FALSE(net1.output());
+    CHECK(net1.states.size() == size);
+
+    net1.update(input_type{{"p1", true}, {"p2", true}, {"p3", true}});
+    CHECK(net1.output());
+    CHECK_FALSE(net1.decided().has_value());
+
+    // Only {p1} remains to be updated
+    CHECK(net1.states.size() == 1);
+
+    net1.update(input_type{{"p1", false}, {"p2", false}, {"p3", false}});
+    CHECK_FALSE(net1.output());
+    net1.update(input_type{{"p1", true}, {"p2", false}, {"p3", false}});
+    CHECK(net1.output());
+  }
+
+  SECTION("Monitor")
+  {
+    auto options = reelay::basic_options();
+    auto monitor1 = reelay::discrete_timed_monitor<
+      time_type,
+      input_type,
+      reelay::json,
+      true>::make("not(once {p1})", options);
+
+    monitor1.update(input_type{{"p1", false}});
+    CHECK_FALSE(monitor1.decided().has_value());
+    monitor1.update(input_type{{"p1", true}});
+    CHECK(monitor1.decided() == false);
+  }
+}
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Discrete Timed Adaptive Ordering",
+  "[discrete_timed]")
+{
+  using conjunction_t =
+    reelay::discrete_timed_setting::conjunction<input_type, time_type>;
+
+  std::vector<input_type> sequence = std::vector<input_type>();
+
+  // The last conjunct is false nine times out of ten
+  for(int i = 0; i < 4096; i++) {
+    sequence.push_back(
+      input_type{{"p1", i % 3 != 0}, {"p2", true}, {"p3", i % 10 == 0}});
+  }
+
+  auto options = reelay::basic_options().with_adaptive_ordering(true);
+
+  auto net1 = reelay::discrete_timed_network<time_type, input_type>::make(
+    "{p1} and {p2} and {p3}", options);
+  auto net2 = reelay::discrete_timed_network<time_type, input_type>::make(
+    "{p1} and {p2} and {p3}");
+
+  auto result1 = std::vector<bool>();
+  auto result2 = std::vector<bool>();
+
+  for(const auto& s : sequence) {
+    net1.update(s);
+    result1.push_back(net1.output());
+    net2.update(s);
+    result2.push_back(net2.output());
+  }
+
+  CHECK(result1 == result2);
+
+  auto root = std::dynamic_pointer_cast<conjunction_t>(net1.root);
+  REQUIRE(root != nullptr);
+  REQUIRE(root->operands.has_value());
+  CHECK(root->operands->order().front() == 2);
+
+  auto stats = root->operands->statistics();
+  REQUIRE(stats.size() == 3);
+  CHECK(stats[2].index == 2);
+  CHECK(stats[1].hits == 0);
+  // Every output evaluates the operand ranked first
+  CHECK(stats[0].evaluations + stats[2].evaluations >= 4096);
+  CHECK(stats[2].evaluations > stats[0].evaluations);
+
+  auto root2 = std::dynamic_pointer_cast<conjunction_t>(net2.root);
+  REQUIRE(root2 != nullptr);
+  CHECK_FALSE(root2->operands.has_value());
+
+  SECTION("Record Propositions")
+  {
+    using atomic_map_t =
+      reelay::discrete_timed_setting::atomic_map<input_type, time_type>;
+
+    auto net3 = reelay::discrete_timed_network<time_type, input_type>::make(
+      "{p1, p2, p3}", options);
+    auto net4 = reelay::discrete_timed_network<time_type, input_type>::make(
+      "{p1, p2, p3}");
+
+    // Mappings are updated by the record proposition alone
+    CHECK(net3.states.size() == 1);
+    CHECK(net4.states.size() == 1);
+
+    auto result3 = std::vector<bool>();
+    auto result4 = std::vector<bool>();
+    for(const auto& s : sequence) {
+      net3.update(s);
+      result3.push_back(net3.output());
+      net4.update(s);
+      result4.push_back(net4.output());
+    }
+
+    CHECK(result3 == result1);
+    CHECK(result4 == result1);
+
+    // Record propositions update every mapping and keep syntactic order
+    auto map = std::dynamic_pointer_cast<atomic_map_t>(net3.root);
+    REQUIRE(map != nullptr);
+    CHECK(map->cost() == 4.0);
+  }
+
+  SECTION("Record Propositions over Sparse Records")
+  {
+    // Missing keys keep the last value of a mapping
+    std::vector<input_type> sparse = std::vector<input_type>();
+    sparse.push_back(input_type{{"p", false}, {"q", true}});
+    sparse.push_back(input_type{{"p", true}});
+    sparse.push_back(input_type{{"q", false}});
+    sparse.push_back(input_type{{"p", false}, {"q", true}});
+    sparse.push_back(input_type{{"p", true}});
+    sparse.push_back(input_type{{"q", true}});
+
+    auto net5 = reelay::discrete_timed_network<time_type, input_type>::make(
+      "{p, q}", options);
+    auto net6 = reelay::discrete_timed_network<time_type, input_type>::make(
+      "{p, q}");
+
+    auto result5 = std::vector<bool>();
+    auto result6 = std::vector<bool>();
+    for(const auto& s : sparse) {
+      net5.update(s);
+      result5.push_back(net5.output());
+      net6.update(s);
+      result6.push_back(net6.output());
+    }
+
+    auto expected = std::vector<bool>{false, true, false, false, true, true};
+    CHECK(result6 == expected);
+    CHECK(result5 == expected);
+  }
+}
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Discrete Timed Automaton",
+  "[discrete_timed]")
+{
+  using automaton_t = reelay::discrete_timed_automaton<time_type, input_type>;
+  using network_t = reelay::discrete_timed_network<time_type, input_type>;
+
+  std::vector<input_type> sequence = std::vector<input_type>();
+
+  for(int i = 0; i < 512; i++) {
+    sequence.push_back(input_type{
+      {"p", (i * 7) % 11 < 6}, {"q", (i * 5) % 13 < 3}, {"r", i % 4 != 0}});
+  }
+
+  SECTION("Equivalence")
+  {
+    auto specs = std::vector<std::string>{
+      "{p} since {q}",
+      "pre({p}) or historically({r})",
+      "(once[:10]{q}) -> ((not{p}) since {q})",
+      "({r} and not {q} and once{q}) -> ({p} since[3:10] {q})",
+      "{r} -> (historically[:5](not{p}))",
+      "once[2:4]{p} and historically[1:3]{r}",
+      "{p} since[2:] {q} or once[3:] (pre {p})",
+    };
+
+    for(const auto& spec : specs) {
+      auto net = network_t::make(spec);
+      auto automaton = automaton_t::compile(spec);
+      REQUIRE(automaton.has_value());
+
+      auto result1 = std::vector<bool>();
+      auto result2 = std::vector<bool>();
+      for(const auto& s : sequence) {
+        result1.push_back(net.update(s));
+        result2.push_back(automaton->update(s));
+      }
+      CHECK(result1 == result2);
+      CHECK(automaton->now() == net.now());
+    }
+  }
+
+  SECTION("Decided")
+  {
+    auto automaton = automaton_t::compile("historically({p} or {q})");
+    REQUIRE(automaton.has_value());
+    CHECK(automaton->size() == 2);
+    CHECK(automaton->width() == 2);
+
+    automaton->update(input_type{{"p", true}, {"q", false}});
+    CHECK_FALSE(automaton->decided().has_value());
+    automaton->update(input_type{{"p", false}, {"q", false}});
+    CHECK(automaton->decided() == false);
+    CHECK(automaton->update(input_type{{"p", true}, {"q", true}}) == false);
+  }
+
+  SECTION("Fallback")
+  {
+    CHECK_FALSE(automaton_t::compile("once[:1000]{p}", 1024).has_value());
+    CHECK_FALSE(automaton_t::compile("{p} since[2:100] {q}").has_value());
+    CHECK(automaton_t::compile("once[:1000]{p}").has_value());
+
+    using monitor_t =
+      reelay::discrete_timed_monitor<time_type, input_type, input_type, false>;
+
+    auto options = reelay::basic_options().with_automaton(true);
+
+    auto monitor1 = monitor_t::make("once[2:4]{p}", options);
+    auto monitor2 = monitor_t::make("{p} since[2:100] {q}", options);
+    CHECK(monitor1.is_automaton());
+    CHECK_FALSE(monitor2.is_automaton());
+
+    // Plans record networks and are loaded without parsing the source
+    auto plan = network_t::compile("once[2:4]{p}");
+    CHECK_THROWS_AS(monitor_t::from_plan(*plan, options), std::invalid_argument);
+    CHECK_FALSE(
+      monitor_t::from_plan(*plan, reelay::basic_options()).is_automaton());
+
+    auto result = std::vector<input_type>();
+    for(std::size_t i = 0; i < 8; i++) {
+      result.push_back(monitor1.update(sequence[i]));
+    }
+
+    auto net = network_t::make("once[2:4]{p}");
+    for(std::size_t i = 0; i < result.size(); i++) {
+      CHECK(result[i]["value"] == net.update(sequence[i]));
+    }
+  }
+}
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Discrete Timed Monitor Set",
+  "[discrete_timed]")
+{
+  using monitor_set_t =
+    reelay::discrete_timed_monitor_set<time_type, input_type>;
+  using network_t = reelay::discrete_timed_network<time_type, input_type>;
+
+  std::vector<input_type> sequence = std::vector<input_type>();
+
+  for(int i = 0; i < 256; i++) {
+    sequence.push_back(input_type{
+      {"p", (i * 7) % 11 < 6}, {"q", (i * 5) % 13 < 3}, {"r", i % 4 != 0}});
+  }
+
+  SECTION("Shared Subformulas")
+  {
+    auto specs = std::vector<std::string>{
+      "once[:10]{q} -> {p}",
+      "once[:10]{q} and not {r}",
+      "{r} since once[:10]{q}",
+      "{p} since {q}",
+      "{p} since {q}",
+      "historically[1:3]({p} or {r})",
+    };
+
+    auto monitors = monitor_set_t::make(specs, reelay::basic_options());
+    REQUIRE(monitors.size() == specs.size());
+
+    std::size_t total = 0;
+    for(const auto& spec : specs) {
+      total += network_t::compile(spec)->steps.size();
+    }
+    CHECK(monitors.width() < total);
+
+    auto expected = std::vector<std::vector<std::pair<time_type, bool>>>();
+    for(const auto& spec : specs) {
+      auto net = network_t::make(spec);
+      auto changes = std::vector<std::pair<time_type, bool>>();
+      for(const auto& s : sequence) {
+        bool value = net.update(s);
+        if(net.now() == 0 or value != changes.back().second) {
+          changes.emplace_back(net.now(), value);
+        }
+      }
+      expected.push_back(changes);
+    }
+
+    auto result = std::vector<std::vector<std::pair<time_type, bool>>>(
+      specs.size());
+    monitors.push(
+      sequence.begin(),
+      sequence.end(),
+      [&result](time_type time, std::size_t index, bool value) {
+        result[index].emplace_back(time, value);
+      });
+
+    CHECK(result == expected);
+    CHECK(monitors.now() == 255);
+  }
+
+  SECTION("Decided")
+  {
+    auto monitors = monitor_set_t::make(
+      {"historically{p}", "once{q}"}, reelay::basic_options());
+
+    auto sink = [](time_type, std::size_t, bool) {};
+    monitors.push(input_type{{"p", false}, {"q", false}}, sink);
+    CHECK(monitors.decided(0) == false);
+    CHECK_FALSE(monitors.decided(1).has_value());
+    CHECK_FALSE(monitors.decided());
+
+    monitors.push(input_type{{"p", true}, {"q", true}}, sink);
+    CHECK(monitors.decided(1) == true);
+    CHECK(monitors.decided());
+    CHECK(monitors.active() == 0);
+  }
+
+  SECTION("Nested Records")
+  {
+    auto monitors =
+      monitor_set_t::make({"{p1}", "a::{p1}"}, reelay::basic_options());
+    CHECK(monitors.active() == 2);
+
+    auto result = std::vector<std::pair<std::size_t, bool>>();
+    monitors.push(
+      input_type{{"p1", true}, {"a", {{"p1", false}}}},
+      [&result](time_type, std::size_t index, bool value) {
+        result.emplace_back(index, value);
+      });
+
+    auto expected =
+      std::vector<std::pair<std::size_t, bool>>({{0, true}, {1, false}});
+    CHECK(result == expected);
+  }
+
+  SECTION("Settings")
+  {
+    auto plan = *network_t::compile("{p}");
+    auto plans = reelay::ptl_plan_set();
+    plans.add(plan);
+
+    plan.setting = "dense_timed";
+    CHECK_THROWS_AS(plans.add(plan), std::invalid_argument);
+
+    auto others = reelay::ptl_plan_set();
+    others.add(plan);
+    CHECK_THROWS_AS(
+      monitor_set_t(others, reelay::basic_options()), std::invalid_argument);
+  }
+}
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Discrete Timed Parallel Network",
+  "[discrete_timed]")
+{
+  using parallel_t =
+    reelay::discrete_timed_parallel_network<time_type, input_type>;
+  using network_t = reelay::discrete_timed_network<time_type, input_type>;
+
+  std::vector<input_type> sequence = std::vector<input_type>();
+
+  for(int i = 0; i < 1000; i++) {
+    sequence.push_back(input_type{
+      {"p", (i * 7) % 11 < 6}, {"q", (i * 5) % 13 < 3}, {"r", i % 4 != 0}});
+  }
+
+  auto sequential = [&sequence](const std::string& spec) {
+    auto net = network_t::make(spec);
+    auto result = std::vector<bool>();
+    for(const auto& s : sequence) {
+      result.push_back(net.update(s));
+    }
+    return result;
+  };
+
+  SECTION("Lanes")
+  {
+    auto specs = std::vector<std::string>{
+      "{p} since {q}",
+      "({p} since {q}) and once[:10]{r} and historically[1:3]({p} or {r})",
+      "not(({p} since[2:9] {q}) or pre {r}) and ({r} -> once {q})",
+      "(once[:3]{q} -> ({p} since {q})) and (once[:4]{r} -> not{p})",
+      "historically(once[:3]{q} -> {p}) or ({r} since[:5] {q})",
+    };
+    auto lanes = std::vector<std::size_t>{1, 3, 4, 4, 2};
+
+    for(std::size_t n = 0; n < specs.size(); n++) {
+      for(std::size_t threads : {1, 2, 4}) {
+        for(std::size_t batch_size : {1, 7, 256}) {
+          auto parallel = reelay::parallel_options{threads, batch_size, 4};
+          auto net =
+            parallel_t::make(specs[n], reelay::basic_options(), parallel);
+          CHECK(net.lanes() == lanes[n]);
+          CHECK(net.threads() == std::min(threads, lanes[n]));
+
+          auto result = std::vector<bool>();
+          auto sink = [&result](time_type time, bool value) {
+            CHECK(time == time_type(result.size()));
+            result.push_back(value);
+          };
+          net.update(sequence.begin(), sequence.begin() + 500, sink);
+          result.push_back(net.update(sequence[500]));
+          net.update(sequence.begin() + 501, sequence.end(), sink);
+
+          CHECK(result == sequential(specs[n]));
+          CHECK(net.now() == 999);
+        }
+      }
+    }
+  }
+
+  SECTION("BinaryRows")
+  {
+    using row_parallel_t =
+      reelay::discrete_timed_parallel_network<time_type, reelay::binary_row>;
+
+    auto schema = reelay::binary_schema::packed(
+      {{"time", reelay::scalar_kind::int64},
+       {"p", reelay::scalar_kind::boolean},
+       {"q", reelay::scalar_kind::boolean},
+       {"r", reelay::scalar_kind::boolean}});
+
+    std::ostringstream stream;
+    {
+      auto writer = reelay::binary_row_writer(stream, schema);
+      for(std::size_t i = 0; i < sequence.size(); i++) {
+        writer.set("time", int64_t(i));
+        for(const auto* key : {"p", "q", "r"}) {
+          writer.set(key, sequence[i][key].get<bool>());
+        }
+        writer.commit();
+      }
+    }
+    const std::string bytes = stream.str();
+    auto [loaded, offset] =
+      reelay::binary_schema::read(bytes.data(), bytes.size());
+
+    auto spec = "({p} since {q}) and once[:10]{r} and historically[1:3]{p}";
+    auto parallel = reelay::parallel_options{3, 7, 4};
+    auto net = row_parallel_t::make(spec, reelay::basic_options(), parallel);
+    CHECK(net.lanes() == 3);
+
+    auto result = std::vector<bool>();
+    auto first = reelay::binary_row_iterator(&loaded, bytes.data() + offset);
+    net.update(
+      first,
+      first + sequence.size(),
+      [&result](time_type, bool value) { result.push_back(value); });
+
+    CHECK(result == sequential(spec));
+  }
+
+  SECTION("Errors")
+  {
+    auto events = std::vector<input_type>(100, input_type{{"x", 5}});
+    events[60] = input_type{{"x", "abc"}};
+
+    auto parallel = reelay::parallel_options{2, 8, 3};
+    auto net = parallel_t::make(
+      "{x > 3} and once{x < 0}", reelay::basic_options(), parallel);
+
+    auto sink = [](time_type, bool) {};
+    CHECK_THROWS_AS(
+      net.update(events.begin(), events.end(), sink),
+      reelay::json::type_error);
+    CHECK(net.now() < 60);
+
+    // Lanes may have run past the failing event, so the network stops
+    events[60] = input_type{{"x", -1}};
+    CHECK_THROWS_AS(
+      net.update(events.begin() + 60, events.end(), sink), std::logic_error);
+  }
+
+  SECTION("Decided")
+  {
+    auto parallel = reelay::parallel_options{2, 16, 2};
+    auto net = parallel_t::make(
+      "historically{p} and once{q}", reelay::basic_options(), parallel);
+
+    net.update(input_type{{"p", true}, {"q", false}});
+    CHECK_FALSE(net.decided().has_value());
+
+    net.update(input_type{{"p", false}, {"q", true}});
+    CHECK(net.decided() == false);
+    CHECK_FALSE(net.output());
+  }
+
+  SECTION("Monitor")
+  {
+    using monitor_t = reelay::
+      discrete_timed_parallel_monitor<time_type, input_type, input_type, true>;
+
+    auto monitor = monitor_t::make(
+      "({p} since {q}) and once[:10]{r}", reelay::basic_options());
+
+    auto result = std::vector<std::pair<time_type, bool>>();
+    monitor.push(
+      sequence.begin(), sequence.end(), [&result](time_type time, bool value) {
+        result.emplace_back(time, value);
+      });
+
+    auto expected = std::vector<std::pair<time_type, bool>>();
+    auto values = sequential("({p} since {q}) and once[:10]{r}");
+    for(std::size_t i = 0; i < values.size(); i++) {
+      if(i == 0 or values[i] != values[i - 1]) {
+        expected.emplace_back(time_type(i), values[i]);
+      }
+    }
+    CHECK(result == expected);
+  }
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "reelay/formatters/json_formatter.hpp"
+#include "reelay/json.hpp"
+#include "reelay/monitors/discrete_timed_regex_monitor.hpp"
+#include "reelay/networks/discrete_timed_network.hpp"
+#include "reelay/networks/discrete_timed_regex.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using time_type = int64_t;
+using input_type = reelay::json;
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Discrete Timed Regular Expressions",
+  "[discrete_timed]")
+{
+  using regex_t = reelay::discrete_timed_regex<time_type, input_type>;
+  using network_t = reelay::discrete_timed_network<time_type, input_type>;
+
+  // p holds at 0, 4, 8, 9, 10, 12 and q at 1, 5, 9, 11, 13
+  std::vector<input_type> sequence = std::vector<input_type>();
+  for(int i = 0; i < 16; i++) {
+    sequence.push_back(input_type{
+      {"p", i % 4 == 0 or i == 9 or i == 10},
+      {"q", i % 4 == 1 or i == 11},
+      {"r", i % 3 == 0}});
+  }
+
+  auto run = [&sequence](regex_t regex) {
+    std::string result;
+    for(const auto& s : sequence) {
+      result += regex.update(s) ? '1' : '0';
+    }
+    return result;
+  };
+
+  SECTION("Operators")
+  {
+    CHECK(run(regex_t::make("{p} {q}")) == "0100010001010100");
+    CHECK(run(regex_t::make("{p}; {q}")) == "0100010001010100");
+    CHECK(run(regex_t::make("{p} && !{q}")) == "1000100010101000");
+    CHECK(run(regex_t::make("({p} | {q}) {r}?")) == "1100111011111100");
+    CHECK(run(regex_t::make("({p} {q})[2:]")) == "0000000000010100");
+    CHECK(run(regex_t::make("({p} {q})*")) == "1111111111111111");
+    CHECK(run(regex_t::make("{p} {*}* {q} & {*}[3:5]")) == "0000000000010100");
+  }
+
+  SECTION("Counters")
+  {
+    auto counted = regex_t::make("{p}[2:3]");
+    CHECK(counted.size() == 1);
+    CHECK(run(counted) == "0000000001100000");
+
+    // Intersections unroll repetitions into copies of the letter
+    auto specs = std::vector<std::string>{
+      "{q} {p}[2:4] {r}",
+      "{p} {*}[:3] {q}",
+      "{p}[:2] {q}[1:]",
+      "({p} || {q})[3:5]",
+    };
+    for(const auto& spec : specs) {
+      auto unrolled = regex_t::make("(" + spec + ") & {*}+");
+      CHECK(unrolled.size() > regex_t::make(spec).size());
+      CHECK(run(regex_t::make(spec)) == run(unrolled));
+    }
+  }
+
+  SECTION("Constant Letters")
+  {
+    CHECK(run(regex_t::make("({*} || {p}) {q}")) == run(regex_t::make("{*} {q}")));
+    CHECK(run(regex_t::make("{*} && {p}")) == run(regex_t::make("{p}")));
+    CHECK(run(regex_t::make("!{*}")) == "0000000000000000");
+    CHECK(run(regex_t::make("!{*} {q}")) == "0000000000000000");
+    CHECK(run(regex_t::make("(!{*})* {q}")) == run(regex_t::make("{q}")));
+    CHECK(run(regex_t::make("(!{*})[2:3]")) == "0000000000000000");
+    CHECK(
+      run(regex_t::make("({*} || {q})[2:3]")) == run(regex_t::make("{*}[2:3]")));
+  }
+
+  SECTION("Past Temporal Logic")
+  {
+    auto pairs = std::vector<std::pair<std::string, std::string>>{
+      {"{p} {q}", "{q} and pre{p}"},
+      {"{p} {*}[:3] {q}", "{q} and pre(once[0:3]{p})"},
+      {"{p}+ {r}", "{r} and pre{p}"},
+      {"{q} {p}*", "{p} since {q}"},
+    };
+    for(const auto& [regex, formula] : pairs) {
+      auto net = network_t::make(formula);
+      std::string expected;
+      for(const auto& s : sequence) {
+        expected += net.update(s) ? '1' : '0';
+      }
+      CHECK(run(regex_t::make(regex)) == expected);
+    }
+  }
+
+  SECTION("Errors")
+  {
+    CHECK_THROWS_AS(regex_t::make("{p} |"), std::invalid_argument);
+    CHECK_THROWS_AS(regex_t::make("{p}[3:2]"), std::invalid_argument);
+    CHECK_THROWS_AS(
+      regex_t::make("({p} {q})[600:] & ({q} {p})[600:]"),
+      std::invalid_argument);
+  }
+
+  SECTION("Monitor")
+  {
+    using monitor_t = reelay::
+      discrete_timed_regex_monitor<time_type, input_type, input_type, true>;
+
+    auto monitor = monitor_t::make("{p} {q}", reelay::basic_options());
+    auto result = std::vector<input_type>();
+    for(int i = 0; i < 6; i++) {
+      result.push_back(monitor.update(sequence[i]));
+    }
+
+    auto expected = std::vector<input_type>{
+      input_type{{"time", 0}, {"value", false}},
+      input_type{{"time", 1}, {"value", true}},
+      input_type{{"time", 2}, {"value", false}},
+      input_type::object(),
+      input_type::object(),
+      input_type{{"time", 5}, {"value", true}},
+    };
+    CHECK(result == expected);
+  }
+}
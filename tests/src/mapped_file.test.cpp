@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "reelay/io/mapped_file.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#pragma pack(push, 1)
+struct test_record_t {
+  int32_t time;
+  bool p;
+};
+#pragma pack(pop)
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Mapped Files",
+  "[mapped_file]")
+{
+  const std::string filename = "reelay_mapped_file_test.bin";
+
+  SECTION("RecordSpans")
+  {
+    {
+      std::ofstream output(filename, std::ios::binary);
+      uint32_t count = 5;
+      output.write(reinterpret_cast<const char*>(&count), sizeof(count));
+      for(int32_t i = 0; i < 5; i++) {
+        test_record_t rec{i, i % 2 == 0};
+        output.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+      }
+      output.put('\0');  // trailing partial record
+    }
+
+    auto file = reelay::mapped_file(filename);
+    file.advise_sequential();
+
+    auto records = file.records<test_record_t>(sizeof(uint32_t));
+    REQUIRE(records.size() == 5);
+    CHECK(records.begin()[4].time == 4);
+
+    auto batch = records.subspan(3, 10);
+    CHECK(batch.size() == 2);
+    CHECK(batch.begin()->time == 3);
+    CHECK(records.subspan(7, 1).empty());
+
+    std::remove(filename.c_str());
+  }
+
+  SECTION("EmptyFile")
+  {
+    {
+      std::ofstream output(filename, std::ios::binary);
+    }
+    auto file = reelay::mapped_file(filename);
+    CHECK(file.size() == 0);
+    CHECK(file.records<test_record_t>().empty());
+
+    std::remove(filename.c_str());
+  }
+
+  SECTION("MissingFile")
+  {
+    CHECK_THROWS(reelay::mapped_file("reelay_no_such_file.bin"));
+  }
+}
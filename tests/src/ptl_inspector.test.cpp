@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "reelay/parser/ptl_inspector.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+reelay::ptl_bounds bounds(const std::string& pattern)
+{
+  auto result = reelay::ptl_inspector().inspect(pattern);
+  return reelay::any_cast<reelay::ptl_bounds>(result["bounds"]);
+}
+
+}  // namespace
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "PTL Inspector Bounds",
+  "[parser]")
+{
+  using bounds_t = reelay::ptl_bounds;
+
+  SECTION("Untimed")
+  {
+    auto result = bounds("{p} and not {q}");
+    CHECK(result.operators == 4);
+    CHECK(result.states == 2);
+    CHECK(result.windows == 0);
+    CHECK(result.horizon == 0);
+    CHECK(result.memory() == 4 * bounds_t::node_bytes);
+    CHECK(result.memory(true) == result.memory());
+
+    CHECK(bounds("pre(pre{p})").horizon == 2);
+    CHECK(std::isinf(bounds("{p} since {q}").horizon));
+    CHECK(bounds("historically{p}").states == 2);
+    CHECK(bounds("true or false").states == 0);
+  }
+
+  SECTION("Timed")
+  {
+    auto result = bounds("once[:10]({p} since[2:4] pre{q})");
+    CHECK(result.operators == 5);
+    CHECK(result.states == 5);
+    CHECK(result.windows == 2);
+    CHECK(result.unbounded_windows == 0);
+    CHECK(result.horizon == 15);
+    CHECK(result.intervals == 1 + 2);
+    CHECK(result.span == 14);
+    CHECK(
+      result.memory() ==
+      5 * bounds_t::node_bytes + 3 * bounds_t::interval_bytes);
+
+    // Dense windows fragment with input changes
+    CHECK(std::isinf(result.memory(true)));
+    CHECK(
+      result.memory(true, 2) ==
+      5 * bounds_t::node_bytes + (2 + 14 * 2) * bounds_t::interval_bytes);
+
+    auto half = bounds("historically[5:]{p}");
+    CHECK(half.unbounded_windows == 1);
+    CHECK(half.intervals == 1);
+    CHECK(std::isinf(half.horizon));
+    CHECK(half.memory(true) == half.memory());
+  }
+
+  SECTION("References")
+  {
+    auto result = bounds("exists[x]. {id: *x} since[:3] {q}");
+    CHECK(result.references);
+    CHECK(std::isinf(result.memory()));
+    CHECK(bounds("{id: *x}").references);
+  }
+
+  SECTION("Budget")
+  {
+    auto inspector = reelay::ptl_inspector();
+    CHECK_NOTHROW(inspector.admit("once[:10]{p}", 1024));
+    CHECK_THROWS_AS(inspector.admit("once[:10]{p}", 256), std::invalid_argument);
+    CHECK_THROWS_AS(
+      inspector.admit("once[:10]{p}", 1024, true), std::invalid_argument);
+    CHECK_NOTHROW(inspector.admit("once[:10]{p}", 4096, true, 4));
+
+    // Partial bounds of malformed specifications are not admitted
+    CHECK_THROWS_AS(
+      inspector.admit("once[:10]{p} and and (", 1e9), std::invalid_argument);
+    CHECK_THROWS_AS(inspector.inspect("{p"), std::invalid_argument);
+
+    // Nothing carries over from an earlier specification
+    inspector.inspect("exists[x]. once[:3]{p: *x}");
+    auto result = inspector.admit("{p}", 1e9);
+    CHECK_FALSE(reelay::any_cast<bool>(result["timed"]));
+    CHECK_FALSE(reelay::any_cast<bool>(result["has_references"]));
+  }
+}
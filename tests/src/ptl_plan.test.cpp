@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "reelay/intervals.hpp"
+#include "reelay/io/plan_file.hpp"
+#include "reelay/json.hpp"
+#include "reelay/networks/dense_timed_network.hpp"
+#include "reelay/networks/discrete_timed_network.hpp"
+#include "reelay/parser/ptl_plan.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using time_type = int64_t;
+using input_type = reelay::json;
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "PTL Plan Cache",
+  "[parser]")
+{
+  using network_t = reelay::discrete_timed_network<time_type, input_type>;
+  using parser_t = reelay::ptl_parser<network_t>;
+
+  SECTION("Least Recently Used")
+  {
+    auto cache = reelay::plan_cache(2);
+    auto plan = std::make_shared<const reelay::ptl_plan>();
+
+    cache.insert("a", plan);
+    cache.insert("b", plan);
+    CHECK(cache.find("a") == plan);  // b is now the oldest
+    cache.insert("c", plan);
+
+    CHECK(cache.size() == 2);
+    CHECK(cache.find("a") != nullptr);
+    CHECK(cache.find("b") == nullptr);
+    CHECK(cache.find("c") != nullptr);
+
+    cache.resize(0);
+    CHECK(cache.size() == 0);
+  }
+
+  SECTION("Instantiation")
+  {
+    const std::string pattern =
+      "historically[0:4]({p1} -> once {p2}) and not {p3} since {p1}";
+
+    parser_t::cache().clear();
+    auto net1 = network_t::make(pattern);
+    REQUIRE(parser_t::cache().find(pattern) != nullptr);
+    auto net2 = network_t::make(pattern);  // From the plan
+
+    CHECK(net1.states.size() == net2.states.size());
+    CHECK(net1.root != net2.root);
+
+    std::vector<input_type> sequence = std::vector<input_type>();
+    for(int i = 0; i < 64; i++) {
+      sequence.push_back(
+        input_type{{"p1", i % 3 == 0}, {"p2", i % 5 == 1}, {"p3", i % 7 == 2}});
+    }
+
+    auto result1 = std::vector<bool>();
+    auto result2 = std::vector<bool>();
+    for(const auto& s : sequence) {
+      result1.push_back(net1.update(s));
+      result2.push_back(net2.update(s));
+    }
+    CHECK(result1 == result2);
+  }
+
+  SECTION("Syntax Errors")
+  {
+    parser_t::cache().clear();
+    network_t::make("{p1} and and");
+    CHECK(parser_t::cache().size() == 0);
+  }
+
+  SECTION("Caching Disabled")
+  {
+    parser_t::cache().clear();
+    parser_t::cache().resize(0);
+    auto plan = network_t::compile("{p1} since {p2}");
+    parser_t::cache().resize(reelay::plan_cache::default_capacity);
+
+    REQUIRE(plan != nullptr);
+    CHECK(plan->source == "{p1} since {p2}");
+    CHECK(parser_t::cache().size() == 0);
+  }
+
+  SECTION("Concurrent Construction")
+  {
+    parser_t::cache().clear();
+
+    auto outputs = std::vector<std::vector<bool>>(8);
+    auto threads = std::vector<std::thread>();
+    for(std::size_t t = 0; t < outputs.size(); t++) {
+      threads.emplace_back([&outputs, t]() {
+        for(int k = 0; k < 16; k++) {
+          auto pattern = "{p1} since[0:" + std::to_string(k % 4 + 1) + "] {p2}";
+          auto net = network_t::make(pattern);
+          net.update(input_type{{"p1", false}, {"p2", true}});
+          net.update(input_type{{"p1", true}, {"p2", false}});
+          outputs[t].push_back(net.output());
+        }
+      });
+    }
+    for(auto& thread : threads) {
+      thread.join();
+    }
+
+    for(const auto& output : outputs) {
+      CHECK(output == outputs[0]);
+      CHECK(output[0]);
+    }
+    CHECK(parser_t::cache().size() == 4);
+  }
+}
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "PTL Plan Files",
+  "[parser]")
+{
+  using network_t = reelay::discrete_timed_network<time_type, input_type>;
+  using parser_t = reelay::ptl_parser<network_t>;
+
+  const std::string pattern =
+    "once[2:4]{p2} or not {p3 > 2} since[1:3] {p1: \"a\"}";
+
+  SECTION("Round Trip")
+  {
+    auto plan = parser_t().compile(pattern);
+
+    auto stream = std::stringstream();
+    reelay::plan_writer(stream).write(*plan);
+    auto loaded = reelay::plan_reader(stream).read();
+
+    CHECK(loaded == *plan);
+    CHECK(loaded.setting == "discrete_timed");
+    CHECK(loaded.source == pattern);
+  }
+
+  SECTION("Discrete Instantiation")
+  {
+    const std::string spec = "historically[0:4]({p1} -> once {p2}) since {p3}";
+
+    auto stream = std::stringstream();
+    reelay::plan_writer(stream).write(*parser_t().compile(spec));
+    auto net1 = network_t::make(spec);
+    auto net2 = network_t::from_plan(reelay::plan_reader(stream).read());
+
+    auto result1 = std::vector<bool>();
+    auto result2 = std::vector<bool>();
+    for(int i = 0; i < 64; i++) {
+      auto s =
+        input_type{{"p1", i % 3 == 0}, {"p2", i % 5 == 1}, {"p3", i % 7 == 2}};
+      result1.push_back(net1.update(s));
+      result2.push_back(net2.update(s));
+    }
+    CHECK(result1 == result2);
+  }
+
+  SECTION("Dense Instantiation")
+  {
+    using dense_network_t = reelay::dense_timed_network<double, input_type>;
+    using interval_set = reelay::interval_set<double>;
+
+    const std::string spec = "{x1 > 2} since[1.5:3] {x2}";
+
+    auto stream = std::stringstream();
+    reelay::plan_writer(stream).write(*dense_network_t::compile(spec));
+    auto net1 = dense_network_t::make(spec);
+    auto net2 = dense_network_t::from_plan(reelay::plan_reader(stream).read());
+
+    auto result1 = interval_set();
+    auto result2 = interval_set();
+    for(int i = 0; i < 32; i++) {
+      auto s = input_type{
+        {"time", 0.7 * i}, {"x1", i % 6 == 5 ? 0 : 3}, {"x2", i % 6 == 0}};
+      net1.update(s);
+      net2.update(s);
+      result1 = result1 | net1.output();
+      result2 = result2 | net2.output();
+    }
+    CHECK(result1 == result2);
+    CHECK(not result1.empty());
+  }
+
+  SECTION("Invalid Files")
+  {
+    auto plan = parser_t().compile(pattern);
+    auto stream = std::stringstream();
+    reelay::plan_writer(stream).write(*plan);
+    auto bytes = stream.str();
+
+    auto magic = bytes;
+    magic[0] = 'X';
+    auto input1 = std::stringstream(magic);
+    CHECK_THROWS_AS(reelay::plan_reader(input1).read(), std::runtime_error);
+
+    auto version = bytes;
+    version[4] = 99;
+    auto input2 = std::stringstream(version);
+    CHECK_THROWS_AS(reelay::plan_reader(input2).read(), std::runtime_error);
+
+    auto input3 = std::stringstream(bytes.substr(0, bytes.size() - 2));
+    CHECK_THROWS_AS(reelay::plan_reader(input3).read(), std::runtime_error);
+
+    auto length = bytes;
+    length.replace(8, 4, 4, '\xff');  // Setting name of 4 GiB
+    auto input4 = std::stringstream(length);
+    CHECK_THROWS_AS(reelay::plan_reader(input4).read(), std::runtime_error);
+
+    // States and nested arguments must refer to state steps
+    std::size_t node = 0;
+    while(plan->steps[node].is_state) {
+      node++;
+    }
+
+    auto states = *plan;
+    states.states.back() = node;
+    auto output5 = std::stringstream();
+    reelay::plan_writer(output5).write(states);
+    auto input5 = std::stringstream(output5.str());
+    CHECK_THROWS_AS(reelay::plan_reader(input5).read(), std::runtime_error);
+
+    auto nested = *plan;
+    nested.steps.back().nested = true;
+    nested.steps.back().args = {node};
+    auto output6 = std::stringstream();
+    reelay::plan_writer(output6).write(nested);
+    auto input6 = std::stringstream(output6.str());
+    CHECK_THROWS_AS(reelay::plan_reader(input6).read(), std::runtime_error);
+
+    using dense_network_t = reelay::dense_timed_network<double, input_type>;
+    CHECK_THROWS_AS(dense_network_t::from_plan(*plan), std::invalid_argument);
+  }
+}
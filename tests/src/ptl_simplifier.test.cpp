@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "reelay/json.hpp"
+#include "reelay/networks/dense_timed_network.hpp"
+#include "reelay/networks/discrete_timed_network.hpp"
+#include "reelay/parser/ptl_simplifier.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using time_type = int64_t;
+using input_type = reelay::json;
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "PTL Simplifier",
+  "[parser]")
+{
+  auto simplifier = reelay::ptl_simplifier();
+
+  SECTION("Constants")
+  {
+    CHECK(simplifier.simplify("{p} and true") == "{p}");
+    CHECK(simplifier.simplify("{p} and ({q} or false) and true") == "{p} and {q}");
+    CHECK(simplifier.simplify("true -> {p}") == "{p}");
+    CHECK(simplifier.simplify("{p} -> false") == "not {p}");
+    CHECK(simplifier.simplify("true since[2:5] {q}") == "once[2:5] {q}");
+    CHECK(simplifier.simplify("false since {q}") == "{q}");
+    CHECK(simplifier.simplify("{p} or historically false") == "{p}");
+
+    CHECK_THROWS_AS(simplifier.simplify("{p} or true"), std::invalid_argument);
+    CHECK_THROWS_AS(
+      simplifier.simplify("{p} and once[1:2] true"), std::invalid_argument);
+  }
+
+  SECTION("Negations")
+  {
+    CHECK(simplifier.simplify("not (not {p})") == "{p}");
+    CHECK(simplifier.simplify("not (once (not {p}))") == "historically {p}");
+    CHECK(simplifier.simplify("not ({p} -> {q})") == "{p} and (not {q})");
+    CHECK(
+      simplifier.simplify("not (not {p} and not {q} and {r})") ==
+      "{p} or {q} or (not {r})");
+    CHECK(
+      simplifier.simplify("not ({p} and {q})") == "not ({p} and {q})");
+  }
+
+  SECTION("Flattening")
+  {
+    CHECK(
+      simplifier.simplify("({p} and {q}) and ({r} and {p})") ==
+      "{p} and {q} and {r}");
+    CHECK(simplifier.simplify("{p} or ({q} or {p})") == "{p} or {q}");
+  }
+
+  SECTION("Bounded Operators")
+  {
+    CHECK(simplifier.simplify("once[1:2] (once[3:4] {p})") == "once[4:6] {p}");
+    CHECK(simplifier.simplify("once (once {p})") == "once {p}");
+    CHECK(
+      simplifier.simplify("historically (historically[2:5] {p})") ==
+      "historically[2:] {p}");
+    CHECK(
+      simplifier.simplify("not (historically[1:3] (not (once[2:4] {p})))") ==
+      "once[3:7] {p}");
+
+    // Bounds are printed in the notation of the grammar
+    CHECK(
+      simplifier.simplify("once[0:0.00001] {p}") == "once[0:0.00001] {p}");
+    CHECK(
+      simplifier.simplify("once[0:100000000000000000] {p}") ==
+      "once[0:100000000000000000] {p}");
+    CHECK_NOTHROW(reelay::dense_timed_network<double, input_type>::make(
+      "{p} since[0:0.00001] {q}"));
+  }
+
+  SECTION("Unchanged")
+  {
+    auto pattern = std::string("{p} since[2:4] {x > 3, y: *a}");
+    CHECK(simplifier.simplify(pattern) == pattern);
+    CHECK(simplifier.simplify("{p} and and") == "{p} and and");
+  }
+
+  SECTION("Equivalence")
+  {
+    std::vector<input_type> sequence = std::vector<input_type>();
+
+    for(int i = 0; i < 32; i++) {
+      sequence.push_back(input_type{{"p", i % 5 == 0}, {"q", i % 7 == 3}});
+    }
+
+    auto net1 = reelay::discrete_timed_network<time_type, input_type>::make(
+      "not (historically[1:3] (not (once[2:4] {p}))) and true");
+    auto net2 = reelay::discrete_timed_network<time_type, input_type>::make(
+      "once[3:7] {p}");
+
+    auto result1 = std::vector<bool>();
+    auto result2 = std::vector<bool>();
+    for(const auto& s : sequence) {
+      net1.update(s);
+      result1.push_back(net1.output());
+      net2.update(s);
+      result2.push_back(net2.output());
+    }
+
+    CHECK(result1 == result2);
+    CHECK(net1.states.size() == net2.states.size());
+  }
+}
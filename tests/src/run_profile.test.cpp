@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2019-2025 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "reelay/profiling/latency_histogram.hpp"
+#include "reelay/profiling/run_profile.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <sstream>
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Run Profiles",
+  "[run_profile]")
+{
+  SECTION("ExactSmallValues")
+  {
+    auto histogram = reelay::latency_histogram();
+    for(uint64_t v = 1; v <= 100; v++) {
+      histogram.record(v);
+    }
+
+    CHECK(histogram.count() == 100);
+    CHECK(histogram.min() == 1);
+    CHECK(histogram.max() == 100);
+    CHECK(histogram.mean() == 50.5);
+    CHECK(histogram.value_at(0.5) == 50);
+    CHECK(histogram.value_at(0.99) == 99);
+    CHECK(histogram.value_at(0.999) == 100);
+    CHECK(histogram.value_at(0.0) == 1);
+    CHECK(histogram.value_at(1.0) == 100);
+  }
+
+  SECTION("RelativePrecision")
+  {
+    auto histogram = reelay::latency_histogram();
+    for(uint64_t v = 1000; v <= 1000000; v += 1000) {
+      histogram.record(v);
+    }
+
+    auto within = [](uint64_t reported, uint64_t exact) {
+      return reported >= exact and reported - exact <= exact / 128;
+    };
+    CHECK(within(histogram.value_at(0.5), 500000));
+    CHECK(within(histogram.value_at(0.99), 990000));
+    CHECK(within(histogram.value_at(0.999), 999000));
+    CHECK(histogram.value_at(1.0) == 1000000);
+
+    histogram.record(UINT64_MAX);
+    CHECK(histogram.max() == UINT64_MAX);
+    CHECK(histogram.value_at(1.0) == UINT64_MAX);
+  }
+
+  SECTION("TailLatency")
+  {
+    auto histogram = reelay::latency_histogram();
+    for(int i = 0; i < 9990; i++) {
+      histogram.record(100);
+    }
+    for(int i = 0; i < 10; i++) {
+      histogram.record(50000);
+    }
+
+    CHECK(histogram.value_at(0.99) == 100);
+    CHECK(histogram.value_at(0.999) == 100);
+    CHECK(histogram.value_at(0.9995) >= 50000);
+
+    auto other = reelay::latency_histogram();
+    other.record(7);
+    histogram.merge(other);
+    CHECK(histogram.count() == 10001);
+    CHECK(histogram.min() == 7);
+    CHECK_THROWS(histogram.merge(reelay::latency_histogram(5)));
+
+    histogram.reset();
+    CHECK(histogram.count() == 0);
+    CHECK(histogram.value_at(0.5) == 0);
+  }
+
+  SECTION("Phases")
+  {
+    using phase = reelay::run_profile::phase;
+
+    auto profile = reelay::run_profile();
+    for(int i = 0; i < 10; i++) {
+      profile.measure(phase::parse, [] {});
+      profile.measure_event([&] {
+        profile.measure(phase::output, [&] { profile.verdicts++; });
+      });
+      profile.bytes += 8;
+    }
+    profile.charge(phase::parse, reelay::run_profile::clock::now());
+    profile.stop();
+
+    auto report = profile.report();
+    CHECK(report["events"] == 10);
+    CHECK(report["bytes"] == 80);
+    CHECK(report["verdicts"] == 10);
+    CHECK(report["latency_ns"].contains("p999"));
+    CHECK(report["seconds"]["total"].get<double>() >= 0.0);
+    CHECK(profile.latency.count() == 10);
+    CHECK(profile.spent(phase::monitor) <= report["seconds"]["total"].get<double>() * 1e9);
+
+    std::ostringstream stream;
+    profile.write(stream);
+    CHECK(reelay::json::parse(stream.str())["events"] == 10);
+  }
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019-2025 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "reelay/io/binary_row.hpp"
+#include "ryserve/session.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Feeds `data` to the session in chunks of `size` bytes, then ends input
+std::string run(const std::string& data, std::size_t size)
+{
+  auto session = ryserve::session();
+  for(std::size_t pos = 0; pos < data.size() and not session.closing;
+      pos += size) {
+    session.input.append(data, pos, size);
+    session.process(false);
+  }
+  if(not session.closing) {
+    session.process(true);
+  }
+  return session.output;
+}
+
+}  // namespace
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Monitoring Daemon Sessions",
+  "[ryserve]")
+{
+  SECTION("JsonEvents")
+  {
+    const std::string data =
+      "{\"specs\": [\"{p}\", \"once{q}\"]}\n"
+      "{\"p\": true, \"q\": false}\n"
+      "\n"
+      "{\"p\": false, \"q\": false}\n"
+      "{\"p\": false, \"q\": true}";
+
+    const std::string expected =
+      "{\"ready\":true,\"specs\":2}\n"
+      "{\"time\":0,\"spec\":0,\"value\":true}\n"
+      "{\"time\":0,\"spec\":1,\"value\":false}\n"
+      "{\"time\":1,\"spec\":0,\"value\":false}\n"
+      "{\"time\":2,\"spec\":1,\"value\":true}\n";
+
+    // Lines split across reads wait for the rest of the line
+    CHECK(run(data, data.size()) == expected);
+    CHECK(run(data, 7) == expected);
+    CHECK(run(data, 1) == expected);
+  }
+
+  SECTION("RowEvents")
+  {
+    auto schema = reelay::binary_schema::packed(
+      {{"time", reelay::scalar_kind::int64},
+       {"p", reelay::scalar_kind::boolean}});
+
+    std::ostringstream stream;
+    {
+      auto writer = reelay::binary_row_writer(stream, schema);
+      for(int i = 0; i < 4; i++) {
+        writer.set("time", i);
+        writer.set("p", i == 2);
+        writer.commit();
+      }
+    }
+    const std::string data =
+      "{\"spec\": \"{p}\", \"format\": \"rows\"}\n" + stream.str();
+
+    const std::string expected =
+      "{\"ready\":true,\"specs\":1}\n"
+      "{\"time\":0,\"spec\":0,\"value\":false}\n"
+      "{\"time\":2,\"spec\":0,\"value\":true}\n"
+      "{\"time\":3,\"spec\":0,\"value\":false}\n";
+
+    // Partial headers and rows wait for the rest
+    CHECK(run(data, data.size()) == expected);
+    CHECK(run(data, 5) == expected);
+
+    auto partial = run(data.substr(0, data.size() - 3), 5);
+    CHECK(partial.find("{\"time\":2,\"spec\":0,\"value\":true}\n") !=
+          std::string::npos);
+    CHECK(partial.find("{\"error\":") != std::string::npos);
+  }
+
+  SECTION("Errors")
+  {
+    auto session = ryserve::session();
+    session.input = "{\"spec\": \"{p}\"}\n{\"p\": true}\n{\"p\": tr";
+    session.process(false);
+    CHECK_FALSE(session.closing);
+    session.input += "ue\nnot json\n{\"p\": false}\n";
+    session.process(false);
+    CHECK(session.closing);
+    CHECK(session.input.empty());
+    CHECK(
+      session.output ==
+      "{\"ready\":true,\"specs\":1}\n"
+      "{\"time\":0,\"spec\":0,\"value\":true}\n"
+      "{\"error\":\"Invalid JSON event\"}\n");
+
+    auto error = [](const std::string& data) {
+      auto output = run(data, data.size());
+      return output.rfind("{\"error\":", 0) == 0 and
+             output.find("ready") == std::string::npos;
+    };
+    CHECK(error("[1, 2]\n"));
+    CHECK(error("{\"specs\": []}\n"));
+    CHECK(error("{\"spec\": \"{p}\", \"model\": \"hybrid\"}\n"));
+    CHECK(error("{\"spec\": \"{p}\", \"format\": \"xml\"}\n"));
+    CHECK(error("{\"spec\": \"{p} and and\"}\n"));
+    CHECK(error("{\"spec\": \"{p}\""));
+  }
+}
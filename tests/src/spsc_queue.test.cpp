@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "reelay/concurrency/spsc_queue.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "SPSC Queues",
+  "[spsc_queue]")
+{
+  SECTION("Bounded")
+  {
+    auto queue = reelay::spsc_queue<int>(3);
+    CHECK(queue.capacity() == 4);
+
+    for(int i = 0; i < 4; i++) {
+      int value = i;
+      CHECK(queue.try_push(value));
+    }
+    int extra = 4;
+    CHECK_FALSE(queue.try_push(extra));
+
+    int value = -1;
+    CHECK(queue.try_pop(value));
+    CHECK(value == 0);
+    CHECK(queue.try_push(extra));
+
+    auto result = std::vector<int>();
+    while(queue.try_pop(value)) {
+      result.push_back(value);
+    }
+    CHECK(result == std::vector<int>({1, 2, 3, 4}));
+  }
+
+  SECTION("ProducerConsumer")
+  {
+    const int n = 100000;
+    auto queue = reelay::spsc_queue<int>(64);
+
+    std::thread producer([&]() {
+      for(int i = 1; i <= n; i++) {
+        queue.push(i);
+      }
+      queue.push(0);
+    });
+
+    long long sum = 0;
+    int last = 0;
+    bool ordered = true;
+    while(int value = queue.pop()) {
+      ordered = ordered and value == last + 1;
+      last = value;
+      sum += value;
+    }
+    producer.join();
+
+    CHECK(ordered);
+    CHECK(sum == static_cast<long long>(n) * (n + 1) / 2);
+  }
+
+  SECTION("Parking")
+  {
+    auto queue = reelay::spsc_queue<int>(1);
+    auto replies = reelay::spsc_queue<int>(1);
+
+    // Both sides outwait the spin and park before the other makes progress
+    std::thread consumer([&]() {
+      int value = queue.pop();
+      replies.push(value + 1);
+      replies.push(queue.pop() + 1);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+    CHECK(replies.pop() == 2);
+    CHECK(replies.pop() == 3);
+    consumer.join();
+
+    int value = 0;
+    CHECK(queue.try_pop(value));
+    CHECK(value == 3);
+  }
+}
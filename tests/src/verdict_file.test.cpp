@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2019-2023 Dogan Ulus
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "reelay/formatters/json_formatter.hpp"
+#include "reelay/io/verdict_file.hpp"
+#include "reelay/json.hpp"
+#include "reelay/monitors/discrete_timed_monitor.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using time_type = int64_t;
+using input_type = reelay::json;
+
+TEST_CASE(  // NOLINT(readability-function-cognitive-complexity)
+  "Verdict Files",
+  "[verdict_file]")
+{
+  const std::string filename = "reelay_verdict_file_test.rylb";
+
+  SECTION("PointRoundTrip")
+  {
+    std::vector<input_type> sequence = std::vector<input_type>();
+
+    sequence.push_back(input_type{{"p1", false}, {"p2", false}});
+    sequence.push_back(input_type{{"p1", true}, {"p2", true}});
+    sequence.push_back(input_type{{"p1", true}, {"p2", false}});
+    sequence.push_back(input_type{{"p1", false}, {"p2", false}});
+    sequence.push_back(input_type{{"p1", false}, {"p2", true}});
+
+    auto options = reelay::basic_options();
+    auto monitor = reelay::discrete_timed_monitor<
+      time_type,
+      input_type,
+      reelay::json,
+      true>::make("{p1} since {p2}", options);
+
+    {
+      std::ofstream output(filename, std::ios::binary);
+      auto writer = reelay::verdict_writer<time_type, bool>(output);
+      for(const auto& s : sequence) {
+        monitor.push(s, writer);
+      }
+    }
+
+    auto reader = reelay::verdict_reader(filename);
+    CHECK(reader.header().model == reelay::verdict_model::discrete);
+    CHECK(reader.header().layout == reelay::verdict_layout::point);
+    CHECK(reader.header().time_kind == reelay::scalar_kind::int64);
+    CHECK(reader.header().value_kind == reelay::scalar_kind::boolean);
+    REQUIRE(reader.size() == 4);
+
+    const auto* records = reader.points<time_type, bool>();
+    auto result = std::vector<std::pair<time_type, bool>>();
+    for(std::size_t i = 0; i < reader.size(); i++) {
+      result.emplace_back(records[i].time, records[i].value);
+    }
+
+    auto expected = std::vector<std::pair<time_type, bool>>(
+      {{0, false}, {1, true}, {3, false}, {4, true}});
+
+    CHECK(result == expected);
+
+    std::ostringstream lines;
+    reader.to_json_lines(lines);
+    CHECK(
+      lines.str() ==
+      "{\"time\":0,\"value\":false}\n{\"time\":1,\"value\":true}\n"
+      "{\"time\":3,\"value\":false}\n{\"time\":4,\"value\":true}\n");
+
+    CHECK_THROWS(reader.points<double, bool>());
+
+    std::remove(filename.c_str());
+  }
+
+  SECTION("IntervalRoundTrip")
+  {
+    {
+      std::ofstream output(filename, std::ios::binary);
+      auto writer = reelay::verdict_writer<double, double>(
+        output, reelay::verdict_model::dense, reelay::verdict_layout::interval);
+      writer(0.0, 1.5, 2.0);
+      writer(1.5, 4.0, -1.0);
+      CHECK_THROWS(writer(5.0, 0.0));
+    }
+
+    auto reader = reelay::verdict_reader(filename);
+    CHECK(reader.header().model == reelay::verdict_model::dense);
+    REQUIRE(reader.size() == 2);
+
+    const auto* records = reader.intervals<double, double>();
+    CHECK(records[1].begin == 1.5);
+    CHECK(records[1].end == 4.0);
+    CHECK(records[1].value == -1.0);
+
+    std::remove(filename.c_str());
+  }
+
+  SECTION("RecordSizeMismatch")
+  {
+    {
+      std::ofstream output(filename, std::ios::binary);
+      auto writer = reelay::verdict_writer<int64_t, bool>(output);
+      writer(0, true);
+      writer(1, false);
+    }
+    {
+      // Claim records smaller than the declared types
+      std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+      uint16_t record_size = 2;
+      file.seekp(offsetof(reelay::verdict_header, record_size));
+      file.write(reinterpret_cast<const char*>(&record_size), sizeof(record_size));
+    }
+
+    auto reader = reelay::verdict_reader(filename);
+    CHECK_THROWS(reader.points<int64_t, bool>());
+
+    std::ostringstream lines;
+    CHECK_THROWS(reader.to_json_lines(lines));
+
+    std::remove(filename.c_str());
+  }
+}